@@ -1,23 +1,23 @@
-#include"EBO.h"
-
-EBO::EBO(GLuint* indices, GLsizeiptr size)
-{
-	glGenBuffers(1, &ID);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ID);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, size, indices, GL_STATIC_DRAW);
-}
-
-void EBO::Bind()
-{
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ID);
-}
-
-void EBO::Unbind()
-{
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-}
-
-void EBO::Delete()
-{
-	glDeleteBuffers(1, &ID);
+#include"EBO.h"
+
+EBO::EBO(const void* indices, GLsizeiptr size)
+{
+	glGenBuffers(1, &ID);
+	GLStateCache::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, ID);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, size, indices, GL_STATIC_DRAW);
+}
+
+void EBO::Bind()
+{
+	GLStateCache::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, ID);
+}
+
+void EBO::Unbind()
+{
+	GLStateCache::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+}
+
+void EBO::Delete()
+{
+	GLStateCache::deleteBuffer(ID);
 }
\ No newline at end of file
@@ -1,17 +1,19 @@
-#ifndef EBO_CLASS_H
-#define EBO_CLASS_H
-
-#include<glad/glad.h>
-
-class EBO
-{
-public:
-	GLuint ID;
-	EBO(GLuint* indices, GLsizeiptr size);
-
-	void Bind();
-	void Unbind();
-	void Delete();
-};
-
+#ifndef EBO_CLASS_H
+#define EBO_CLASS_H
+
+#include<glad/glad.h>
+#include"glStateCache.h"
+
+class EBO
+{
+public:
+	GLuint ID;
+	// indices may be 16-bit or 32-bit data (nullptr allocates only)
+	EBO(const void* indices, GLsizeiptr size);
+
+	void Bind();
+	void Unbind();
+	void Delete();
+};
+
 #endif
\ No newline at end of file
@@ -4,10 +4,17 @@ TrapezoidPrism::TrapezoidPrism(float width, float height, float depthTop, float
     : m_width(width), m_height(height), m_depthTop(depthTop), m_depthBottom(depthBottom), m_color(color) {
 }
 
-void TrapezoidPrism::generateGeometry() {
-    vertices_data.clear();
-    indices_data.clear();
+std::string TrapezoidPrism::getMeshKey() const {
+    return makeMeshKey("TrapezoidPrism", { m_width, m_height, m_depthTop, m_depthBottom, m_color.r, m_color.g, m_color.b });
+}
+
+void TrapezoidPrism::countGeometry(size_t& vertexCount, size_t& indexCount) const {
+    // Only the front face is generated so far
+    vertexCount = 4;
+    indexCount = 6;
+}
 
+void TrapezoidPrism::writeGeometry(GeometryWriter& writer) const {
     float hw = m_width / 2.0f;
     float ht = m_height;
     float dt = m_depthTop / 2.0f;
@@ -32,10 +39,11 @@ void TrapezoidPrism::generateGeometry() {
     // For brevity, you can copy the Cube logic and adjust for trapezoid
 
     // Example: front face (trapezoid)
-    addVertex(v3, m_color, { 0,0 }, { 0,0,1 });
-    addVertex(v2, m_color, { 1,0 }, { 0,0,1 });
-    addVertex(v6, m_color, { 1,1 }, { 0,0,1 });
-    addVertex(v7, m_color, { 0,1 }, { 0,0,1 });
-    indices_data.insert(indices_data.end(), { 0,1,2, 0,2,3 });
+    writer.addVertex(v3, m_color, { 0,0 }, { 0,0,1 });
+    writer.addVertex(v2, m_color, { 1,0 }, { 0,0,1 });
+    writer.addVertex(v6, m_color, { 1,1 }, { 0,0,1 });
+    writer.addVertex(v7, m_color, { 0,1 }, { 0,0,1 });
+    writer.addTriangle(0, 1, 2);
+    writer.addTriangle(0, 2, 3);
     // ... repeat for other faces
 }
\ No newline at end of file
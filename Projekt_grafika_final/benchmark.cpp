@@ -0,0 +1,764 @@
+#include "benchmark.h"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <random>
+#include <memory>
+#include <cfloat>
+#include <glm/gtc/constants.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include "Sphere.h"
+#include "Cylinder.h"
+#include "IcoSphere.h"
+#include "simdTrig.h"
+#include "frustumCuller.h"
+#include "bvh.h"
+#include "bounds.h"
+#include "occlusionCuller.h"
+#include "portalSystem.h"
+#include "scene.h"
+#include "collisionWorld.h"
+#include "renderQueue.h"
+#include "Cube.h"
+#include "threadPool.h"
+
+namespace {
+
+    // Exposes the protected generation methods; the shapes never create a Mesh here
+    class BenchSphere : public Sphere {
+    public:
+        using Sphere::Sphere;
+        using Sphere::countGeometry;
+        using Sphere::writeGeometry;
+    };
+
+    class BenchCylinder : public Cylinder {
+    public:
+        using Cylinder::Cylinder;
+        using Cylinder::countGeometry;
+        using Cylinder::writeGeometry;
+    };
+
+    class BenchIcoSphere : public IcoSphere {
+    public:
+        using IcoSphere::IcoSphere;
+        using IcoSphere::countGeometry;
+        using IcoSphere::writeGeometry;
+    };
+
+    // Previous Sphere vertex loop: sinf/cosf for every vertex
+    void legacySphere(GeometryWriter& writer, float radius, unsigned int sectorCount, unsigned int stackCount, const glm::vec3& color) {
+        float lengthInv = 1.0f / radius;
+        float sectorStep = 2 * glm::pi<float>() / sectorCount;
+        float stackStep = glm::pi<float>() / stackCount;
+
+        for (unsigned int i = 0; i <= stackCount; ++i) {
+            float stackAngle = glm::pi<float>() / 2.0f - i * stackStep;
+            float xy_projection = radius * cosf(stackAngle);
+            float y_height = radius * sinf(stackAngle);
+            for (unsigned int j = 0; j <= sectorCount; ++j) {
+                float sectorAngle = j * sectorStep;
+                float x_pos = xy_projection * cosf(sectorAngle);
+                float z_depth = xy_projection * sinf(sectorAngle);
+                float s = 1.0f - ((float)j / sectorCount);
+                float t = 1.0f - ((float)i / stackCount);
+                writer.addVertex(glm::vec3(x_pos, z_depth, y_height), color, glm::vec2(s, t),
+                                 glm::vec3(x_pos * lengthInv, z_depth * lengthInv, y_height * lengthInv));
+            }
+        }
+        for (unsigned int i = 0; i < stackCount; ++i) {
+            GLuint k1 = i * (sectorCount + 1);
+            GLuint k2 = k1 + sectorCount + 1;
+            for (unsigned int j = 0; j < sectorCount; ++j, ++k1, ++k2) {
+                if (i != 0) writer.addTriangle(k1, k2, k1 + 1);
+                if (i != (stackCount - 1)) writer.addTriangle(k1 + 1, k2, k2 + 1);
+            }
+        }
+    }
+
+    // Previous Cylinder vertex loops: the same sector angles recomputed for the walls and both caps
+    void legacyCylinder(GeometryWriter& writer, float baseRadius, float topRadius, float height,
+                        unsigned int sectorCount, unsigned int stackCount, const glm::vec3& color) {
+        float halfHeight = height / 2.0f;
+        float sectorStep = 2.0f * glm::pi<float>() / sectorCount;
+
+        for (unsigned int i = 0; i <= stackCount; ++i) {
+            float stackY = -halfHeight + (float)i / stackCount * height;
+            float currentRadius = baseRadius + (float)i / stackCount * (topRadius - baseRadius);
+            for (unsigned int j = 0; j <= sectorCount; ++j) {
+                float currentAngle = j * sectorStep;
+                glm::vec3 normal;
+                if (topRadius == baseRadius) {
+                    normal = glm::normalize(glm::vec3(cosf(currentAngle), 0.0f, sinf(currentAngle)));
+                } else {
+                    glm::vec3 tangent1 = glm::vec3(-sinf(currentAngle), 0.0f, cosf(currentAngle));
+                    glm::vec3 tangent2 = glm::vec3(cosf(currentAngle) * (topRadius - baseRadius) / height, 1.0f, sinf(currentAngle) * (topRadius - baseRadius) / height);
+                    normal = glm::normalize(glm::cross(tangent2, tangent1));
+                }
+                writer.addVertex(glm::vec3(currentRadius * cosf(currentAngle), stackY, currentRadius * sinf(currentAngle)), color,
+                                 glm::vec2((float)j / sectorCount, (float)i / stackCount), normal);
+            }
+        }
+        for (unsigned int i = 0; i < stackCount; ++i) {
+            GLuint k1 = i * (sectorCount + 1);
+            GLuint k2 = k1 + (sectorCount + 1);
+            for (unsigned int j = 0; j < sectorCount; ++j, ++k1, ++k2) {
+                writer.addTriangle(k1, k2, k1 + 1);
+                writer.addTriangle(k2, k2 + 1, k1 + 1);
+            }
+        }
+        GLuint next = (stackCount + 1) * (sectorCount + 1);
+
+        const float capRadius[2] = { baseRadius, topRadius };
+        for (int cap = 0; cap < 2; ++cap) {
+            if (capRadius[cap] <= 0.0f) continue;
+            float y = cap == 0 ? -halfHeight : halfHeight;
+            glm::vec3 normal(0.0f, cap == 0 ? -1.0f : 1.0f, 0.0f);
+            GLuint center = next;
+            writer.addVertex(glm::vec3(0.0f, y, 0.0f), color, glm::vec2(0.5f, 0.5f), normal);
+            next++;
+            for (unsigned int j = 0; j <= sectorCount; ++j) {
+                float currentAngle = j * sectorStep;
+                writer.addVertex(glm::vec3(capRadius[cap] * cosf(currentAngle), y, capRadius[cap] * sinf(currentAngle)), color,
+                                 glm::vec2(0.5f + 0.5f * cosf(currentAngle), 0.5f + 0.5f * sinf(currentAngle)), normal);
+            }
+            for (unsigned int j = 0; j < sectorCount; ++j) {
+                if (cap == 0) writer.addTriangle(center, next + j, next + j + 1);
+                else writer.addTriangle(center, next + j + 1, next + j);
+            }
+            next += sectorCount + 1;
+        }
+    }
+
+    // Largest distance between the true sphere (centered at the origin) and the tessellated surface.
+    // Vertices lie on the sphere, so it is radius minus the smallest distance of any triangle to the center.
+    float maxDeviation(const std::vector<GLfloat>& vertices, const std::vector<GLuint>& indices, float radius) {
+        float minDistance = radius;
+        for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+            const GLfloat* pa = &vertices[indices[i] * 11];
+            const GLfloat* pb = &vertices[indices[i + 1] * 11];
+            const GLfloat* pc = &vertices[indices[i + 2] * 11];
+            glm::vec3 a(pa[0], pa[1], pa[2]), b(pb[0], pb[1], pb[2]), c(pc[0], pc[1], pc[2]);
+            minDistance = std::min(minDistance, glm::length(closestPointOnTriangle(glm::vec3(0.0f), a, b, c)));
+        }
+        return radius - minDistance;
+    }
+
+    struct GeneratedMesh {
+        std::vector<GLfloat> vertices;
+        std::vector<GLuint> indices;
+    };
+
+    template <typename BenchShape>
+    GeneratedMesh generate(const BenchShape& shape) {
+        GeneratedMesh mesh;
+        size_t vertexCount = 0, indexCount = 0;
+        shape.countGeometry(vertexCount, indexCount);
+        mesh.vertices.resize(vertexCount * 11);
+        mesh.indices.resize(indexCount);
+        GeometryWriter writer(mesh.vertices.data(), vertexCount, mesh.indices.data(), indexCount);
+        shape.writeGeometry(writer);
+        return mesh;
+    }
+
+    // Average time of one call in microseconds
+    double timeMicroseconds(int iterations, const std::function<void()>& fn) {
+        fn(); // Warm-up
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < iterations; ++i) fn();
+        auto end = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration<double, std::micro>(end - start).count() / iterations;
+    }
+
+    float maxDifference(const std::vector<GLfloat>& a, const std::vector<GLfloat>& b) {
+        float diff = 0.0f;
+        for (size_t i = 0; i < a.size() && i < b.size(); ++i) {
+            diff = std::max(diff, std::fabs(a[i] - b[i]));
+        }
+        return diff;
+    }
+
+    void printResult(const char* name, double legacyUs, double simdUs, float diff) {
+        std::cout << "  " << std::left << std::setw(28) << name << std::right << std::fixed << std::setprecision(2)
+                  << std::setw(10) << legacyUs << " us" << std::setw(10) << simdUs << " us"
+                  << std::setw(7) << legacyUs / simdUs << "x" << std::scientific << std::setprecision(1)
+                  << "   max diff " << diff << std::defaultfloat << std::endl;
+    }
+
+    // Times one shape: legacy generator vs. the shape's writeGeometry, writing into the same pre-sized buffers
+    template <typename BenchShape>
+    void benchmarkShape(const char* name, const BenchShape& shape, int iterations,
+                        const std::function<void(GeometryWriter&)>& legacy) {
+        size_t vertexCount = 0, indexCount = 0;
+        shape.countGeometry(vertexCount, indexCount);
+        std::vector<GLfloat> legacyVertices(vertexCount * 11), simdVertices(vertexCount * 11);
+        std::vector<GLuint> indices(indexCount);
+
+        double legacyUs = timeMicroseconds(iterations, [&]() {
+            GeometryWriter writer(legacyVertices.data(), vertexCount, indices.data(), indexCount);
+            legacy(writer);
+        });
+        double simdUs = timeMicroseconds(iterations, [&]() {
+            GeometryWriter writer(simdVertices.data(), vertexCount, indices.data(), indexCount);
+            shape.writeGeometry(writer);
+        });
+        printResult(name, legacyUs, simdUs, maxDifference(legacyVertices, simdVertices));
+    }
+}
+
+int runBenchmarks() {
+    const glm::vec3 color(1.0f);
+    std::cout << "Geometry generation benchmark (SIMD trig path: " << getSimdTrigPath() << ")" << std::endl;
+    std::cout << "  " << std::left << std::setw(28) << "case" << std::right
+              << std::setw(13) << "sinf/cosf" << std::setw(13) << "table" << std::setw(8) << "speedup" << std::endl;
+
+    // Raw kernel: one table of 1024 angles
+    {
+        const size_t count = 1024;
+        std::vector<float> s0(count), c0(count), s1(count), c1(count);
+        float step = 2.0f * glm::pi<float>() / (count - 1);
+        double scalarUs = timeMicroseconds(2000, [&]() { sinCosTableScalar(0.0f, step, count, s0.data(), c0.data()); });
+        double simdUs = timeMicroseconds(2000, [&]() { sinCosTable(0.0f, step, count, s1.data(), c1.data()); });
+        printResult("sinCosTable (1024)", scalarUs, simdUs, std::max(maxDifference(s0, s1), maxDifference(c0, c1)));
+    }
+
+    const struct { float radius; unsigned int sectors, stacks; int iterations; const char* name; } spheres[] = {
+        { 1.0f, 36, 18, 2000, "Sphere 36x18" },
+        { 1.0f, 128, 64, 200, "Sphere 128x64" },
+        { 1.0f, 512, 256, 20, "Sphere 512x256" },
+    };
+    for (const auto& s : spheres) {
+        BenchSphere sphere(s.radius, s.sectors, s.stacks, color);
+        benchmarkShape(s.name, sphere, s.iterations, [&](GeometryWriter& writer) {
+            legacySphere(writer, s.radius, s.sectors, s.stacks, color);
+        });
+    }
+
+    const struct { float baseRadius, topRadius, height; unsigned int sectors, stacks; int iterations; const char* name; } cylinders[] = {
+        { 0.5f, 0.5f, 2.0f, 36, 1, 5000, "Cylinder 36x1" },
+        { 0.5f, 0.5f, 2.0f, 256, 16, 200, "Cylinder 256x16" },
+        { 0.5f, 0.2f, 2.0f, 256, 16, 200, "Truncated cone 256x16" },
+    };
+    for (const auto& c : cylinders) {
+        BenchCylinder cylinder(c.baseRadius, c.topRadius, c.height, c.sectors, c.stacks, true, color);
+        benchmarkShape(c.name, cylinder, c.iterations, [&](GeometryWriter& writer) {
+            legacyCylinder(writer, c.baseRadius, c.topRadius, c.height, c.sectors, c.stacks, color);
+        });
+    }
+
+    // IcoSphere vs. UV Sphere at equal silhouette error: for every subdivision level, the smallest
+    // UV sphere (sectors = 2 * stacks, i.e. square cells at the equator) that is at least as accurate
+    std::cout << std::endl << "IcoSphere vs. UV Sphere at equal max. deviation (radius 1)" << std::endl;
+    std::cout << "  " << std::left << std::setw(12) << "IcoSphere" << std::right << std::setw(10) << "vertices" << std::setw(10) << "tris"
+              << std::setw(12) << "deviation" << std::setw(12) << "time" << "   " << std::left << std::setw(12) << "UV Sphere" << std::right
+              << std::setw(10) << "vertices" << std::setw(10) << "tris" << std::setw(12) << "deviation" << std::setw(12) << "time"
+              << std::setw(10) << "vertices" << std::endl;
+    unsigned int stacks = 2;
+    for (unsigned int level = 1; level <= 5; ++level) {
+        BenchIcoSphere ico(1.0f, level, color);
+        GeneratedMesh icoMesh = generate(ico);
+        float icoDeviation = maxDeviation(icoMesh.vertices, icoMesh.indices, 1.0f);
+
+        float uvDeviation = 0.0f;
+        GeneratedMesh uvMesh;
+        do {
+            stacks++;
+            BenchSphere uv(1.0f, 2 * stacks, stacks, color);
+            uvMesh = generate(uv);
+            uvDeviation = maxDeviation(uvMesh.vertices, uvMesh.indices, 1.0f);
+        } while (uvDeviation > icoDeviation);
+        stacks--; // The next level needs at least as many stacks again
+
+        int iterations = level < 4 ? 500 : 20;
+        double icoUs = timeMicroseconds(iterations, [&]() { generate(ico); });
+        BenchSphere uv(1.0f, 2 * (stacks + 1), stacks + 1, color);
+        double uvUs = timeMicroseconds(iterations, [&]() { generate(uv); });
+
+        size_t icoVertices = icoMesh.vertices.size() / 11, uvVertices = uvMesh.vertices.size() / 11;
+        std::string icoName = "level " + std::to_string(level);
+        std::string uvName = std::to_string(2 * (stacks + 1)) + "x" + std::to_string(stacks + 1);
+        std::cout << "  " << std::left << std::setw(12) << icoName << std::right << std::setw(10) << icoVertices
+                  << std::setw(10) << icoMesh.indices.size() / 3 << std::scientific << std::setprecision(2) << std::setw(12) << icoDeviation
+                  << std::fixed << std::setw(9) << icoUs << " us" << "   " << std::left << std::setw(12) << uvName << std::right
+                  << std::setw(10) << uvVertices << std::setw(10) << uvMesh.indices.size() / 3 << std::scientific << std::setw(12) << uvDeviation
+                  << std::fixed << std::setw(9) << uvUs << " us" << std::setw(9) << std::setprecision(0)
+                  << 100.0 * (1.0 - (double)icoVertices / uvVertices) << "% fewer" << std::defaultfloat << std::endl;
+    }
+
+    // Frustum culling: random boxes around a camera at the origin looking down -z (roughly 1/8 of them visible)
+    std::cout << std::endl << "Frustum culling (SIMD path: " << FrustumCuller::getSimdPath() << ")" << std::endl;
+    std::cout << "  " << std::left << std::setw(28) << "case" << std::right
+              << std::setw(13) << "scalar" << std::setw(13) << "SoA SIMD" << std::setw(8) << "speedup" << std::endl;
+    glm::mat4 viewProjection = glm::perspective(glm::radians(45.0f), 16.0f / 9.0f, 0.1f, 100.0f)
+                             * glm::lookAt(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    Frustum frustum = Frustum::fromMatrix(viewProjection);
+    std::mt19937 random(42);
+    std::uniform_real_distribution<float> position(-100.0f, 100.0f), size(0.1f, 2.0f);
+    for (size_t boxCount : { (size_t)256, (size_t)4096, (size_t)65536 }) {
+        FrustumCuller culler;
+        for (size_t i = 0; i < boxCount; ++i) {
+            BoundingBox box;
+            glm::vec3 center(position(random), position(random), position(random));
+            glm::vec3 extent(size(random), size(random), size(random));
+            box.expand(center - extent);
+            box.expand(center + extent);
+            culler.add(box);
+        }
+        int iterations = boxCount < 10000 ? 2000 : 100;
+        std::vector<uint32_t> scalarVisible = culler.cullScalar(frustum);
+        double scalarUs = timeMicroseconds(iterations, [&]() { culler.cullScalar(frustum); });
+        double simdUs = timeMicroseconds(iterations, [&]() { culler.cull(frustum); });
+        bool identical = culler.getVisible() == scalarVisible;
+        std::string name = std::to_string(boxCount) + " boxes, " + std::to_string(scalarVisible.size()) + " visible";
+        std::cout << "  " << std::left << std::setw(28) << name << std::right << std::fixed << std::setprecision(2)
+                  << std::setw(10) << scalarUs << " us" << std::setw(10) << simdUs << " us"
+                  << std::setw(7) << scalarUs / simdUs << "x" << (identical ? "   same result" : "   RESULTS DIFFER") << std::defaultfloat << std::endl;
+    }
+
+    // BVH: build, refit of 1% moving objects and queries, against the flat SoA culler / a brute-force loop.
+    // Objects are spread over a gallery-like 1 km x 10 m x 1 km volume, the camera sees roughly 1/1000 of it.
+    std::cout << std::endl << "BVH (binned SAH, " << Bvh::binCount << " bins, " << Bvh::maxLeafObjects << " objects per leaf)" << std::endl;
+    std::cout << "  " << std::left << std::setw(10) << "objects" << std::right << std::setw(11) << "build" << std::setw(7) << "depth"
+              << std::setw(13) << "refit 1%" << std::setw(13) << "frustum" << std::setw(13) << "flat SoA" << std::setw(10) << "visible"
+              << std::setw(11) << "ray" << std::setw(13) << "brute ray" << std::setw(8) << "sphere" << std::endl;
+    glm::mat4 galleryViewProjection = glm::perspective(glm::radians(45.0f), 16.0f / 9.0f, 0.1f, 100.0f)
+                                    * glm::lookAt(glm::vec3(0.0f, 1.7f, 0.0f), glm::vec3(1.0f, 1.7f, 1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    Frustum galleryFrustum = Frustum::fromMatrix(galleryViewProjection);
+    std::uniform_real_distribution<float> ground(-500.0f, 500.0f), height(0.0f, 10.0f), objectSize(0.2f, 2.0f);
+    for (size_t objectCount : { (size_t)10000, (size_t)100000, (size_t)1000000 }) {
+        std::vector<BoundingBox> boxes(objectCount);
+        FrustumCuller flat;
+        for (BoundingBox& box : boxes) {
+            glm::vec3 center(ground(random), height(random), ground(random));
+            glm::vec3 extent(objectSize(random), objectSize(random), objectSize(random));
+            box.expand(center - extent);
+            box.expand(center + extent);
+            flat.add(box);
+        }
+
+        Bvh bvh;
+        int buildIterations = objectCount <= 100000 ? 5 : 1;
+        double buildMs = timeMicroseconds(buildIterations, [&]() { bvh.build(boxes); }) / 1000.0;
+
+        size_t moving = objectCount / 100;
+        glm::vec3 offset(0.01f, 0.0f, 0.0f);
+        double refitUs = timeMicroseconds(10, [&]() {
+            for (size_t i = 0; i < moving; ++i) {
+                BoundingBox box = bvh.getObjectBox((uint32_t)(i * 100));
+                box.min += offset;
+                box.max += offset;
+                bvh.update((uint32_t)(i * 100), box);
+            }
+        });
+        for (size_t i = 0; i < moving; ++i) flat.set((uint32_t)(i * 100), bvh.getObjectBox((uint32_t)(i * 100)));
+
+        std::vector<uint32_t> visible;
+        int queryIterations = objectCount <= 100000 ? 200 : 20;
+        double frustumUs = timeMicroseconds(queryIterations, [&]() { visible.clear(); bvh.queryFrustum(galleryFrustum, visible); });
+        double flatUs = timeMicroseconds(queryIterations, [&]() { flat.cull(galleryFrustum); });
+        std::sort(visible.begin(), visible.end());
+        bool sameVisible = visible == flat.getVisible();
+
+        // Ray along the view direction, compared with testing every box
+        glm::vec3 rayOrigin(0.0f, 1.7f, 0.0f), rayDirection = glm::normalize(glm::vec3(1.0f, 0.0f, 1.0f));
+        std::vector<uint32_t> rayHits;
+        double rayUs = timeMicroseconds(queryIterations, [&]() { rayHits.clear(); bvh.queryRay(rayOrigin, rayDirection, 1000.0f, rayHits); });
+        size_t bruteHits = 0;
+        double bruteUs = timeMicroseconds(queryIterations / 10 + 1, [&]() {
+            bruteHits = 0;
+            for (const BoundingBox& box : boxes) {
+                // Slab test without the hierarchy
+                float tMin = 0.0f, tMax = 1000.0f;
+                for (int axis = 0; axis < 3 && tMin <= tMax; ++axis) {
+                    float inverse = 1.0f / rayDirection[axis];
+                    float t1 = (box.min[axis] - rayOrigin[axis]) * inverse, t2 = (box.max[axis] - rayOrigin[axis]) * inverse;
+                    tMin = std::max(tMin, std::min(t1, t2));
+                    tMax = std::min(tMax, std::max(t1, t2));
+                }
+                if (tMin <= tMax) bruteHits++;
+            }
+        });
+
+        std::vector<uint32_t> nearby;
+        double sphereUs = timeMicroseconds(queryIterations, [&]() { nearby.clear(); bvh.querySphere(glm::vec3(0.0f, 1.7f, 0.0f), 10.0f, nearby); });
+
+        std::cout << "  " << std::left << std::setw(10) << objectCount << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(8) << buildMs << " ms" << std::setw(7) << bvh.getDepth()
+                  << std::setw(10) << refitUs << " us" << std::setw(10) << frustumUs << " us" << std::setw(10) << flatUs << " us"
+                  << std::setw(10) << visible.size() << std::setw(8) << rayUs << " us" << std::setw(10) << bruteUs << " us"
+                  << std::setw(5) << sphereUs << " us"
+                  << ((sameVisible && rayHits.size() == bruteHits) ? "   same result" : "   RESULTS DIFFER") << std::defaultfloat << std::endl;
+    }
+
+    // Occlusion culling, known scene first: a 4 x 2 wall 5 units in front of the camera
+    ThreadPool pool;
+    OcclusionCuller occlusion(256, 144, &pool);
+    std::cout << std::endl << "Occlusion culling (" << occlusion.getWidth() << "x" << occlusion.getHeight() << " depth buffer, "
+              << pool.getThreadCount() + 1 << " threads)" << std::endl;
+    BoundingBox wall;
+    wall.expand(glm::vec3(-2.0f, -1.0f, -5.05f));
+    wall.expand(glm::vec3(2.0f, 1.0f, -4.95f));
+    occlusion.addOccluder(glm::mat4(1.0f), wall);
+    occlusion.render(viewProjection);
+    const struct { glm::vec3 center; bool visible; const char* name; } occludees[] = {
+        { glm::vec3(0.0f, 0.0f, -20.0f), false, "behind the wall" },
+        { glm::vec3(0.0f, 0.0f, -3.0f), true, "in front of the wall" },
+        { glm::vec3(12.0f, 0.0f, -20.0f), true, "beside the wall" },
+        { glm::vec3(0.0f, 4.0f, -20.0f), true, "partly above the wall" },
+        { glm::vec3(100.0f, 0.0f, -20.0f), false, "off screen" },
+    };
+    bool occlusionCorrect = true;
+    for (const auto& occludee : occludees) {
+        BoundingBox box;
+        box.expand(occludee.center - glm::vec3(1.0f));
+        box.expand(occludee.center + glm::vec3(1.0f));
+        bool visible = occlusion.isVisible(box);
+        occlusionCorrect = occlusionCorrect && visible == occludee.visible;
+        std::cout << "  " << std::left << std::setw(28) << occludee.name << (visible ? "visible" : "hidden ")
+                  << (visible == occludee.visible ? "   ok" : "   WRONG") << std::endl;
+    }
+
+    // Timings: random walls in the gallery volume as occluders, random boxes as occludees
+    std::cout << "  " << std::left << std::setw(12) << "occluders" << std::right << std::setw(11) << "triangles"
+              << std::setw(13) << "1 thread" << std::setw(13) << "pool" << std::setw(15) << "10K tests" << std::setw(10) << "hidden" << std::endl;
+    std::uniform_real_distribution<float> wallLength(1.0f, 8.0f), angle(0.0f, 6.2832f), nearGround(-30.0f, 30.0f);
+    for (size_t occluderCount : { (size_t)16, (size_t)128, (size_t)1024 }) {
+        OcclusionCuller serial(256, 144);
+        occlusion.clearOccluders();
+        for (size_t i = 0; i < occluderCount; ++i) {
+            glm::mat4 model = glm::rotate(glm::translate(glm::mat4(1.0f), glm::vec3(nearGround(random), 0.0f, nearGround(random))),
+                                          angle(random), glm::vec3(0.0f, 1.0f, 0.0f));
+            BoundingBox box;
+            box.expand(glm::vec3(-wallLength(random), 0.0f, -0.1f));
+            box.expand(glm::vec3(wallLength(random), 4.0f, 0.1f));
+            occlusion.addOccluder(model, box);
+            serial.addOccluder(model, box);
+        }
+        std::vector<BoundingBox> boxes(10000);
+        for (BoundingBox& box : boxes) {
+            glm::vec3 center(nearGround(random), height(random) * 0.4f, nearGround(random));
+            box.expand(center - glm::vec3(0.3f));
+            box.expand(center + glm::vec3(0.3f));
+        }
+        double serialUs = timeMicroseconds(100, [&]() { serial.render(galleryViewProjection); });
+        double poolUs = timeMicroseconds(100, [&]() { occlusion.render(galleryViewProjection); });
+        bool sameDepth = serial.getDepthBuffer() == occlusion.getDepthBuffer();
+        size_t hidden = 0;
+        double testUs = timeMicroseconds(10, [&]() {
+            hidden = 0;
+            for (const BoundingBox& box : boxes) hidden += occlusion.isVisible(box) ? 0 : 1;
+        });
+        std::cout << "  " << std::left << std::setw(12) << occluderCount << std::right << std::setw(11) << occlusion.getTriangleCount()
+                  << std::fixed << std::setprecision(1) << std::setw(10) << serialUs << " us" << std::setw(10) << poolUs << " us"
+                  << std::setw(12) << testUs << " us" << std::setw(10) << hidden
+                  << (sameDepth ? "   same result" : "   RESULTS DIFFER") << std::defaultfloat << std::endl;
+    }
+
+    // Portals: a chain of 10 x 4 x 12 rooms along +z, joined by doors alternating between x = -3 and x = 3,
+    // camera in the first room looking down the chain. The rooms seen should not depend on the chain length.
+    std::cout << std::endl << "Portal visibility (room chain, camera in the first room)" << std::endl;
+    std::cout << "  " << std::left << std::setw(10) << "rooms" << std::right << std::setw(13) << "update"
+              << std::setw(10) << "visited" << std::setw(10) << "portals" << std::setw(14) << "facing away" << std::endl;
+    glm::mat4 roomProjection = glm::perspective(glm::radians(45.0f), 16.0f / 9.0f, 0.1f, 1000.0f);
+    glm::vec3 roomCamera(0.0f, 1.7f, 2.0f);
+    glm::mat4 lookDown = roomProjection * glm::lookAt(roomCamera, glm::vec3(0.0f, 1.7f, 20.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    glm::mat4 lookBack = roomProjection * glm::lookAt(roomCamera, glm::vec3(0.0f, 1.7f, -20.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    bool portalsCorrect = true;
+    size_t firstVisited = 0;
+    for (size_t roomCount : { (size_t)10, (size_t)100, (size_t)1000, (size_t)10000 }) {
+        PortalSystem building;
+        for (size_t room = 0; room < roomCount; ++room) {
+            BoundingBox bounds;
+            bounds.expand(glm::vec3(-5.0f, 0.0f, room * 12.0f));
+            bounds.expand(glm::vec3(5.0f, 4.0f, (room + 1) * 12.0f));
+            building.addCell(bounds);
+        }
+        for (size_t room = 0; room + 1 < roomCount; ++room) {
+            building.addDoor((int)room, (int)room + 1, glm::vec3(room % 2 ? 3.0f : -3.0f, 0.0f, (room + 1) * 12.0f),
+                             glm::vec3(0.0f, 0.0f, 1.0f), 1.5f, 2.5f);
+        }
+        building.update(roomCamera, lookBack);
+        size_t awayVisited = building.getVisitedCellCount();
+        double updateUs = timeMicroseconds(2000, [&]() { building.update(roomCamera, lookDown); });
+        size_t visited = building.getVisitedCellCount();
+        if (firstVisited == 0) firstVisited = visited;
+        bool correct = awayVisited == 1 && visited > 1 && visited == firstVisited;
+        portalsCorrect = portalsCorrect && correct;
+        std::cout << "  " << std::left << std::setw(10) << roomCount << std::right << std::fixed << std::setprecision(2)
+                  << std::setw(10) << updateUs << " us" << std::setw(10) << visited << std::setw(10) << building.getTestedPortalCount()
+                  << std::setw(14) << awayVisited << (correct ? "   ok" : "   WRONG") << std::defaultfloat << std::endl;
+    }
+
+    // Walking through the first door (x = -3, z = 12) along +z: the next room must stay visible the whole way,
+    // also while the door is closer than the near plane and when the camera stands in it
+    std::cout << "  walking through a door:";
+    PortalSystem doorway;
+    for (int room = 0; room < 3; ++room) {
+        BoundingBox bounds;
+        bounds.expand(glm::vec3(-5.0f, 0.0f, room * 12.0f));
+        bounds.expand(glm::vec3(5.0f, 4.0f, (room + 1) * 12.0f));
+        doorway.addCell(bounds);
+    }
+    doorway.addDoor(0, 1, glm::vec3(-3.0f, 0.0f, 12.0f), glm::vec3(0.0f, 0.0f, 1.0f), 1.5f, 2.5f);
+    doorway.addDoor(1, 2, glm::vec3(3.0f, 0.0f, 24.0f), glm::vec3(0.0f, 0.0f, 1.0f), 1.5f, 2.5f);
+    bool walkCorrect = true;
+    for (float z : { 10.0f, 11.5f, 11.95f, 11.99f, 12.0f, 12.05f, 13.0f }) {
+        glm::vec3 position(-3.0f, 1.7f, z);
+        doorway.update(position, roomProjection * glm::lookAt(position, position + glm::vec3(0.0f, 0.0f, 1.0f), glm::vec3(0.0f, 1.0f, 0.0f)));
+        bool seen = doorway.isCellVisible(1);
+        walkCorrect = walkCorrect && seen;
+        std::cout << " " << std::fixed << std::setprecision(2) << z << std::defaultfloat << (seen ? "" : " (next room lost)");
+    }
+    portalsCorrect = portalsCorrect && walkCorrect;
+    std::cout << (walkCorrect ? "   ok" : "   WRONG") << std::endl;
+
+    // Picking: shapes scattered over a 40 x 4 x 40 m gallery, rays from its centre in random directions,
+    // checked against a brute-force test of every world-space triangle
+    std::cout << std::endl << "Scene raycast (triangle kernel: " << Scene::getSimdPath() << ")" << std::endl;
+    std::cout << "  " << std::left << std::setw(10) << "objects" << std::right << std::setw(11) << "triangles" << std::setw(9) << "meshes"
+              << std::setw(11) << "build" << std::setw(15) << "1000 rays" << std::setw(14) << "per ray" << std::setw(13) << "brute ray" << std::endl;
+    std::uniform_real_distribution<float> floorPosition(-20.0f, 20.0f), rotation(0.0f, 6.2832f), unit(-1.0f, 1.0f);
+    bool pickingCorrect = true;
+    for (size_t objectCount : { (size_t)100, (size_t)1000 }) {
+        std::vector<std::unique_ptr<Shape>> shapes;
+        Scene scene;
+        for (size_t i = 0; i < objectCount; ++i) {
+            std::unique_ptr<Shape> shape;
+            if (i % 3 == 0) shape.reset(new Sphere(0.5f, 36, 18, color));
+            else if (i % 3 == 1) shape.reset(new Cylinder(0.3f, 0.3f, 1.5f, 32, 1, true, color));
+            else shape.reset(new Cube(1.0f, 0.6f, 0.8f, color));
+            shape->modelMatrix = glm::rotate(glm::translate(glm::mat4(1.0f), glm::vec3(floorPosition(random), height(random) * 0.4f, floorPosition(random))),
+                                             rotation(random), glm::normalize(glm::vec3(unit(random), 1.0f, unit(random))));
+            scene.add(shape.get());
+            shapes.push_back(std::move(shape));
+        }
+        auto start = std::chrono::high_resolution_clock::now();
+        scene.build();
+        double buildMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+        glm::vec3 rayOrigin(0.0f, 1.7f, 0.0f);
+        std::vector<glm::vec3> directions(1000);
+        for (glm::vec3& direction : directions) direction = glm::normalize(glm::vec3(unit(random), unit(random) * 0.3f, unit(random)));
+        std::vector<RayHit> hits(directions.size());
+        double batchUs = timeMicroseconds(20, [&]() {
+            for (size_t r = 0; r < directions.size(); ++r) hits[r] = scene.raycast(rayOrigin, directions[r]);
+        });
+
+        // Reference: every triangle of every shape in world space, no hierarchy
+        std::vector<glm::vec3> worldTriangles;
+        std::vector<const Shape*> triangleShapes;
+        for (const auto& shape : shapes) {
+            std::vector<GLfloat> vertices;
+            std::vector<GLuint> indices;
+            shape->getGeometry(vertices, indices);
+            for (GLuint index : indices) {
+                worldTriangles.push_back(glm::vec3(shape->modelMatrix * glm::vec4(vertices[index * 11], vertices[index * 11 + 1], vertices[index * 11 + 2], 1.0f)));
+            }
+            triangleShapes.insert(triangleShapes.end(), indices.size() / 3, shape.get());
+        }
+        size_t checkedRays = 100;
+        bool same = true;
+        double bruteUs = timeMicroseconds(1, [&]() {
+            for (size_t r = 0; r < checkedRays; ++r) {
+                const glm::vec3& direction = directions[r];
+                float closest = FLT_MAX;
+                const Shape* closestShape = nullptr;
+                for (size_t t = 0; t < triangleShapes.size(); ++t) {
+                    glm::vec3 edge1 = worldTriangles[t * 3 + 1] - worldTriangles[t * 3], edge2 = worldTriangles[t * 3 + 2] - worldTriangles[t * 3];
+                    glm::vec3 p = glm::cross(direction, edge2);
+                    float det = glm::dot(edge1, p);
+                    if (std::fabs(det) < 1e-12f) continue;
+                    glm::vec3 s = rayOrigin - worldTriangles[t * 3];
+                    float u = glm::dot(s, p) / det;
+                    glm::vec3 q = glm::cross(s, edge1);
+                    float v = glm::dot(direction, q) / det;
+                    float distance = glm::dot(edge2, q) / det;
+                    if (u < 0.0f || v < 0.0f || u + v > 1.0f || distance < 0.0f || distance >= closest) continue;
+                    closest = distance;
+                    closestShape = triangleShapes[t];
+                }
+                // Coinciding triangles of two shapes may resolve differently, so only the distance has to agree
+                bool hitBoth = hits[r].hasHit() == (closestShape != nullptr);
+                if (!hitBoth || (closestShape && std::fabs(hits[r].distance - closest) > 1e-3f * std::max(1.0f, closest))) same = false;
+            }
+        }) / checkedRays;
+        pickingCorrect = pickingCorrect && same;
+        std::cout << "  " << std::left << std::setw(10) << objectCount << std::right << std::setw(11) << triangleShapes.size()
+                  << std::setw(9) << scene.getMeshCount() << std::fixed << std::setprecision(2) << std::setw(8) << buildMs << " ms"
+                  << std::setw(12) << batchUs << " us" << std::setw(11) << batchUs / directions.size() << " us" << std::setw(10) << bruteUs << " us"
+                  << (same ? "   same result" : "   RESULTS DIFFER") << std::defaultfloat << std::endl;
+    }
+
+    // Camera collision, known scene first: a 10 x 4 x 10 room with a 0.25 sphere walking into its walls,
+    // and a thin wall crossed in a single large step
+    std::cout << std::endl << "Camera collision" << std::endl;
+    const float cameraRadius = 0.25f;
+    auto addQuad = [](CollisionWorld& world, const glm::vec3& a, const glm::vec3& b, const glm::vec3& c, const glm::vec3& d) {
+        world.addTriangle(a, b, c);
+        world.addTriangle(a, c, d);
+    };
+    CollisionWorld room;
+    for (int axis = 0; axis < 3; ++axis) {
+        for (float side : { -1.0f, 1.0f }) {
+            // Corners of the face of the [-5, 5] x [0, 4] x [-5, 5] box at 'side' along 'axis'
+            glm::vec3 corners[4];
+            for (int corner = 0; corner < 4; ++corner) {
+                glm::vec3 unitCorner;
+                unitCorner[axis] = side;
+                unitCorner[(axis + 1) % 3] = (corner == 1 || corner == 2) ? 1.0f : -1.0f;
+                unitCorner[(axis + 2) % 3] = corner >= 2 ? 1.0f : -1.0f;
+                corners[corner] = glm::vec3(unitCorner.x * 5.0f, 2.0f + unitCorner.y * 2.0f, unitCorner.z * 5.0f);
+            }
+            addQuad(room, corners[0], corners[1], corners[2], corners[3]);
+        }
+    }
+    room.build();
+    glm::vec3 walker(0.0f, 1.5f, 0.0f);
+    for (int step = 0; step < 200; ++step) walker = room.move(walker, glm::vec3(0.05f, 0.0f, 0.05f), cameraRadius);
+    bool cornerCorrect = std::fabs(walker.x - (5.0f - cameraRadius)) < 0.01f && std::fabs(walker.z - (5.0f - cameraRadius)) < 0.01f &&
+                         std::fabs(walker.y - 1.5f) < 1e-4f;
+    glm::vec3 slider(0.0f, 1.5f, -4.0f);
+    for (int step = 0; step < 20; ++step) slider = room.move(slider, glm::vec3(0.3f, 0.0f, 0.05f), cameraRadius);
+    bool slideCorrect = std::fabs(slider.x - (5.0f - cameraRadius)) < 0.01f && std::fabs(slider.z - -3.0f) < 0.01f;
+    glm::vec3 climber = room.move(glm::vec3(0.0f, 1.5f, 0.0f), glm::vec3(0.0f, 20.0f, 0.0f), cameraRadius);
+    bool ceilingCorrect = std::fabs(climber.y - (4.0f - cameraRadius)) < 0.01f;
+    CollisionWorld thinWall;
+    addQuad(thinWall, glm::vec3(2.0f, 0.0f, -5.0f), glm::vec3(2.0f, 4.0f, -5.0f), glm::vec3(2.0f, 4.0f, 5.0f), glm::vec3(2.0f, 0.0f, 5.0f));
+    thinWall.build();
+    glm::vec3 runner = thinWall.move(glm::vec3(0.0f, 1.5f, 0.0f), glm::vec3(10.0f, 0.0f, 0.0f), cameraRadius);
+    glm::vec3 backRunner = thinWall.move(glm::vec3(4.0f, 1.5f, 0.0f), glm::vec3(-10.0f, 0.0f, 0.0f), cameraRadius);
+    bool tunnelCorrect = runner.x <= 2.0f - cameraRadius && runner.x > 2.0f - cameraRadius - 0.01f &&
+                         backRunner.x >= 2.0f + cameraRadius && backRunner.x < 2.0f + cameraRadius + 0.01f;
+    bool collisionCorrect = cornerCorrect && slideCorrect && ceilingCorrect && tunnelCorrect;
+    std::cout << "  walk into a corner: " << (cornerCorrect ? "stopped in the corner" : "WRONG")
+              << ", slide along a wall: " << (slideCorrect ? "slides" : "WRONG")
+              << ", up into the ceiling: " << (ceilingCorrect ? "stopped" : "WRONG")
+              << ", 10 m step through a thin wall: " << (tunnelCorrect ? "stopped (both sides)" : "WRONG") << std::endl;
+
+    // Timing: a walk through shapes scattered over a 40 x 40 m room, 0.05 m per frame (far faster than the camera
+    // moves), compared with a world whose single cell hands every triangle to every move
+    std::cout << "  " << std::left << std::setw(11) << "triangles" << std::right << std::setw(9) << "cells" << std::setw(11) << "build"
+              << std::setw(14) << "per move" << std::setw(14) << "99th pct" << std::setw(13) << "candidates" << std::setw(14) << "brute move" << std::endl;
+    for (size_t shapeCount : { (size_t)16, (size_t)136 }) {
+        std::vector<std::unique_ptr<Shape>> shapes;
+        CollisionWorld world, bruteWorld(1e6f);
+        for (size_t i = 0; i < shapeCount; ++i) {
+            std::unique_ptr<Shape> shape;
+            if (i % 2 == 0) shape.reset(new Sphere(0.5f, 36, 18, color));
+            else shape.reset(new Cylinder(0.3f, 0.3f, 1.5f, 64, 1, true, color));
+            shape->modelMatrix = glm::translate(glm::mat4(1.0f), glm::vec3(floorPosition(random), height(random) * 0.3f, floorPosition(random)));
+            world.add(shape.get());
+            bruteWorld.add(shape.get());
+            shapes.push_back(std::move(shape));
+        }
+        for (CollisionWorld* target : { &world, &bruteWorld }) {
+            addQuad(*target, glm::vec3(-20.0f, 0.0f, -20.0f), glm::vec3(-20.0f, 0.0f, 20.0f), glm::vec3(20.0f, 0.0f, 20.0f), glm::vec3(20.0f, 0.0f, -20.0f));
+            addQuad(*target, glm::vec3(-20.0f, 3.0f, -20.0f), glm::vec3(20.0f, 3.0f, -20.0f), glm::vec3(20.0f, 3.0f, 20.0f), glm::vec3(-20.0f, 3.0f, 20.0f));
+        }
+        auto start = std::chrono::high_resolution_clock::now();
+        world.build();
+        double buildMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+        bruteWorld.build();
+
+        // A random walk, turning every 50 frames; the path is kept to compare with the brute-force world
+        const size_t moveCount = 10000;
+        std::vector<glm::vec3> positions(moveCount + 1), motions(moveCount);
+        positions[0] = glm::vec3(0.0f, 1.5f, 0.0f);
+        glm::vec3 heading(1.0f, 0.0f, 0.0f);
+        std::vector<double> moveUs(moveCount);
+        size_t totalCandidates = 0;
+        for (size_t i = 0; i < moveCount; ++i) {
+            if (i % 50 == 0) heading = glm::normalize(glm::vec3(unit(random), unit(random) * 0.3f, unit(random)));
+            motions[i] = heading * 0.05f;
+            auto moveStart = std::chrono::high_resolution_clock::now();
+            positions[i + 1] = world.move(positions[i], motions[i], cameraRadius);
+            moveUs[i] = std::chrono::duration<double, std::micro>(std::chrono::high_resolution_clock::now() - moveStart).count();
+            totalCandidates += world.getCandidateCount();
+        }
+
+        // The slowest moves are mostly the OS interrupting the loop: the 99th percentile is what a frame can expect
+        double totalUs = 0.0;
+        for (double us : moveUs) totalUs += us;
+        std::nth_element(moveUs.begin(), moveUs.begin() + moveCount * 99 / 100, moveUs.end());
+        double percentileUs = moveUs[moveCount * 99 / 100];
+
+        // Every move of the first 200 must end where the brute-force world puts it, and no position may penetrate
+        // anything: a zero move in the brute-force world (which pushes out of every triangle) leaves it in place
+        size_t checkedMoves = 200;
+        bool same = true;
+        double bruteUs = timeMicroseconds(1, [&]() {
+            for (size_t i = 0; i < checkedMoves; ++i) {
+                glm::vec3 brute = bruteWorld.move(positions[i], motions[i], cameraRadius);
+                if (glm::length(brute - positions[i + 1]) > 1e-3f) same = false;
+            }
+        }) / checkedMoves;
+        for (size_t i = 0; i <= moveCount; i += 50) {
+            if (glm::length(bruteWorld.move(positions[i], glm::vec3(0.0f), cameraRadius) - positions[i]) > 1e-4f) same = false;
+        }
+        collisionCorrect = collisionCorrect && same;
+        std::cout << "  " << std::left << std::setw(11) << world.getTriangleCount() << std::right << std::setw(9) << world.getCellCount()
+                  << std::fixed << std::setprecision(2) << std::setw(8) << buildMs << " ms" << std::setw(11) << totalUs / moveCount << " us"
+                  << std::setw(11) << percentileUs << " us" << std::setw(13) << totalCandidates / moveCount << std::setw(11) << bruteUs << " us"
+                  << (same ? "   same result" : "   RESULTS DIFFER") << std::defaultfloat << std::endl;
+    }
+
+    // Render queue: random opaque draws (2 shaders, 16 textures, 8 VAOs, every fifth double-sided) in submission
+    // order and sorted. The radix sort is checked against std::stable_sort.
+    std::cout << std::endl << "Render queue sort" << std::endl;
+    std::cout << "  " << std::left << std::setw(10) << "items" << std::right << std::setw(13) << "radix sort" << std::setw(15) << "stable_sort"
+              << std::setw(22) << "state changes before" << std::setw(8) << "after" << std::endl;
+    // Shader, face culling, texture and VAO changes between consecutive opaque keys
+    auto countStateChanges = [](const std::vector<RenderItem>& items) {
+        size_t changes = 0;
+        const uint64_t vertexArrayMask = (1ull << RenderQueue::vertexArrayBits) - 1;
+        const uint64_t textureMask = ((1ull << RenderQueue::textureBits) - 1) << RenderQueue::vertexArrayBits;
+        const uint64_t cullMask = 1ull << (RenderQueue::textureBits + RenderQueue::vertexArrayBits);
+        const uint64_t shaderMask = ((1ull << RenderQueue::shaderBits) - 1) << (1 + RenderQueue::textureBits + RenderQueue::vertexArrayBits);
+        for (size_t i = 0; i < items.size(); ++i) {
+            uint64_t state = items[i].key >> RenderQueue::depthBits;
+            uint64_t previous = i > 0 ? items[i - 1].key >> RenderQueue::depthBits : ~state;
+            for (uint64_t mask : { shaderMask, cullMask, textureMask, vertexArrayMask }) {
+                if ((state & mask) != (previous & mask)) changes++;
+            }
+        }
+        return changes;
+    };
+    std::uniform_int_distribution<int> stateChoice(0, 1 << 20);
+    std::uniform_real_distribution<float> depthChoice(0.0f, 1.0f);
+    bool queueCorrect = true;
+    for (size_t itemCount : { (size_t)100, (size_t)1000, (size_t)10000, (size_t)100000 }) {
+        std::vector<RenderItem> submitted(itemCount);
+        for (size_t i = 0; i < itemCount; ++i) {
+            int choice = stateChoice(random);
+            submitted[i].key = RenderQueue::makeKey(RenderPass::Opaque, 1 + choice % 2, (choice >> 1) % 5 != 0, 1 + (choice >> 4) % 16,
+                                                    1 + (choice >> 8) % 8, depthChoice(random));
+            submitted[i].tag = static_cast<uint32_t>(i);
+        }
+        RenderQueue queue;
+        int iterations = static_cast<int>(std::max<size_t>(1, 200000 / itemCount));
+        double radixUs = timeMicroseconds(iterations, [&]() {
+            queue.begin(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f), 100.0f);
+            for (const RenderItem& item : submitted) queue.submit(item);
+            queue.sort();
+        });
+        std::vector<RenderItem> reference;
+        double stableUs = timeMicroseconds(iterations, [&]() {
+            reference = submitted;
+            std::stable_sort(reference.begin(), reference.end(), [](const RenderItem& a, const RenderItem& b) { return a.key < b.key; });
+        });
+        bool same = true;
+        for (size_t i = 0; i < itemCount; ++i) {
+            if (queue.getItems()[i].key != reference[i].key || queue.getItems()[i].tag != reference[i].tag) same = false;
+        }
+        queueCorrect = queueCorrect && same;
+        std::cout << "  " << std::left << std::setw(10) << itemCount << std::right << std::fixed << std::setprecision(2)
+                  << std::setw(10) << radixUs << " us" << std::setw(12) << stableUs << " us" << std::setw(22) << countStateChanges(submitted)
+                  << std::setw(8) << countStateChanges(queue.getItems()) << (same ? "   same order" : "   ORDER DIFFERS") << std::defaultfloat << std::endl;
+    }
+    return (occlusionCorrect && portalsCorrect && pickingCorrect && collisionCorrect && queueCorrect) ? 0 : 1;
+}
@@ -0,0 +1,16 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+// CPU microbenchmarks, run with "--benchmark" instead of opening the window (no OpenGL context needed).
+// Compares the table-based SIMD Sphere/Cylinder generation against the previous per-vertex
+// sinf/cosf code and prints timings and the largest difference between the two.
+// Also times the SIMD frustum culler against its scalar version, and the BVH (build, refit and
+// queries) against the flat culler and brute-force loops at 10K-1M objects, and checks the
+// occlusion culler on a known scene before timing it. The portal system is checked and timed on
+// chains of 10-10K rooms, and Scene::raycast() against a brute-force triangle loop. Camera collision
+// is checked in a known room and timed on a random walk through ~100K triangles, and the render queue's
+// radix sort against std::stable_sort.
+// Returns the process exit code (1 if the occlusion, portal, picking, collision or sort check fails).
+int runBenchmarks();
+
+#endif // BENCHMARK_H
@@ -0,0 +1,94 @@
+#include "bounds.h"
+#include <algorithm>
+#include <cmath>
+
+BoundingBox BoundingBox::transformed(const glm::mat4& matrix) const {
+    if (isEmpty()) return BoundingBox();
+
+    // New center = transformed center, new half extent per axis = |row of the 3x3 part| . old half extent
+    glm::vec3 center = glm::vec3(matrix * glm::vec4(getCenter(), 1.0f));
+    glm::vec3 extent = getExtent();
+    glm::vec3 newExtent(0.0f);
+    for (int column = 0; column < 3; ++column) {
+        for (int row = 0; row < 3; ++row) {
+            newExtent[row] += std::fabs(matrix[column][row]) * extent[column];
+        }
+    }
+
+    BoundingBox result;
+    result.min = center - newExtent;
+    result.max = center + newExtent;
+    return result;
+}
+
+BoundingSphere BoundingSphere::transformed(const glm::mat4& matrix) const {
+    if (isEmpty()) return BoundingSphere();
+
+    float scale = std::max(glm::length(glm::vec3(matrix[0])),
+                  std::max(glm::length(glm::vec3(matrix[1])), glm::length(glm::vec3(matrix[2]))));
+    BoundingSphere result;
+    result.center = glm::vec3(matrix * glm::vec4(center, 1.0f));
+    result.radius = radius * scale;
+    return result;
+}
+
+Bounds Bounds::fromBox(const BoundingBox& box, float maxOriginDistance) {
+    Bounds bounds;
+    bounds.box = box;
+    if (box.isEmpty()) return bounds;
+
+    float boxRadius = glm::length(box.getExtent());
+    if (maxOriginDistance < boxRadius) {
+        bounds.sphere.center = glm::vec3(0.0f);
+        bounds.sphere.radius = maxOriginDistance;
+    } else {
+        bounds.sphere.center = box.getCenter();
+        bounds.sphere.radius = boxRadius;
+    }
+    return bounds;
+}
+
+Bounds Bounds::fromVertices(const std::vector<GLfloat>& vertices) {
+    BoundingBox box;
+    float maxDistanceSq = 0.0f;
+    for (size_t v = 0; v + 10 < vertices.size(); v += 11) {
+        glm::vec3 position(vertices[v], vertices[v + 1], vertices[v + 2]);
+        box.expand(position);
+        maxDistanceSq = std::max(maxDistanceSq, glm::dot(position, position));
+    }
+    return fromBox(box, std::sqrt(maxDistanceSq));
+}
+
+Bounds Bounds::transformed(const glm::mat4& matrix) const {
+    Bounds result;
+    result.box = box.transformed(matrix);
+    result.sphere = sphere.transformed(matrix);
+    return result;
+}
+
+glm::vec3 closestPointOnTriangle(const glm::vec3& point, const glm::vec3& a, const glm::vec3& b, const glm::vec3& c) {
+    // Voronoi regions of the corners, edges and face (Ericson, Real-Time Collision Detection 5.1.5)
+    glm::vec3 ab = b - a, ac = c - a, ap = point - a;
+    float d1 = glm::dot(ab, ap), d2 = glm::dot(ac, ap);
+    if (d1 <= 0.0f && d2 <= 0.0f) return a;
+
+    glm::vec3 bp = point - b;
+    float d3 = glm::dot(ab, bp), d4 = glm::dot(ac, bp);
+    if (d3 >= 0.0f && d4 <= d3) return b;
+
+    float vc = d1 * d4 - d3 * d2;
+    if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f) return a + ab * (d1 / (d1 - d3));
+
+    glm::vec3 cp = point - c;
+    float d5 = glm::dot(ab, cp), d6 = glm::dot(ac, cp);
+    if (d6 >= 0.0f && d5 <= d6) return c;
+
+    float vb = d5 * d2 - d1 * d6;
+    if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f) return a + ac * (d2 / (d2 - d6));
+
+    float va = d3 * d6 - d5 * d4;
+    if (va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f) return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+
+    float denominator = 1.0f / (va + vb + vc);
+    return a + ab * (vb * denominator) + ac * (vc * denominator);
+}
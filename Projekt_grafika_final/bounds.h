@@ -0,0 +1,61 @@
+#ifndef BOUNDS_H
+#define BOUNDS_H
+
+#include <vector>
+#include <limits>
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+// Axis-aligned bounding box. Default-constructed boxes are empty (min > max) and grow with expand().
+struct BoundingBox {
+    glm::vec3 min = glm::vec3(std::numeric_limits<float>::max());
+    glm::vec3 max = glm::vec3(-std::numeric_limits<float>::max());
+
+    bool isEmpty() const { return min.x > max.x || min.y > max.y || min.z > max.z; }
+    void expand(const glm::vec3& point) {
+        min = glm::min(min, point);
+        max = glm::max(max, point);
+    }
+    void expand(const BoundingBox& other) {
+        min = glm::min(min, other.min);
+        max = glm::max(max, other.max);
+    }
+    glm::vec3 getCenter() const { return (min + max) * 0.5f; }
+    glm::vec3 getExtent() const { return (max - min) * 0.5f; } // Half size
+
+    // Box around this box after the transform (exact for the transformed corners, Arvo's method)
+    BoundingBox transformed(const glm::mat4& matrix) const;
+};
+
+// Bounding sphere. A negative radius marks an empty sphere.
+struct BoundingSphere {
+    glm::vec3 center = glm::vec3(0.0f);
+    float radius = -1.0f;
+
+    bool isEmpty() const { return radius < 0.0f; }
+
+    // Sphere around this sphere after the transform (radius scaled by the largest axis scale)
+    BoundingSphere transformed(const glm::mat4& matrix) const;
+};
+
+// Box + sphere of one piece of geometry. Culling tests the cheap sphere first and the tighter box second.
+struct Bounds {
+    BoundingBox box;
+    BoundingSphere sphere;
+
+    bool isEmpty() const { return box.isEmpty(); }
+
+    // Picks the tighter of two spheres that need no second pass over the vertices: the box's circumsphere,
+    // or the sphere around the local origin reaching the farthest vertex (tight for shapes built around
+    // their origin, like spheres and cylinders)
+    static Bounds fromBox(const BoundingBox& box, float maxOriginDistance);
+    // Bounds of 11-float vertex data (one pass, for geometry that did not come through a GeometryWriter)
+    static Bounds fromVertices(const std::vector<GLfloat>& vertices);
+
+    Bounds transformed(const glm::mat4& matrix) const;
+};
+
+// Point of triangle abc closest to the given point (Ericson, Real-Time Collision Detection 5.1.5)
+glm::vec3 closestPointOnTriangle(const glm::vec3& point, const glm::vec3& a, const glm::vec3& b, const glm::vec3& c);
+
+#endif // BOUNDS_H
@@ -0,0 +1,377 @@
+#include "bvh.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+const uint32_t Bvh::maxLeafObjects;
+const uint32_t Bvh::binCount;
+
+namespace {
+    float surfaceArea(const BoundingBox& box) {
+        if (box.isEmpty()) return 0.0f;
+        glm::vec3 size = box.max - box.min;
+        return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+    }
+
+    // -1 = completely behind the plane, 1 = completely in front of it, 0 = intersecting
+    int classify(const BoundingBox& box, const glm::vec4& plane) {
+        glm::vec3 center = box.getCenter();
+        glm::vec3 extent = box.getExtent();
+        float distance = plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w;
+        float radius = std::fabs(plane.x) * extent.x + std::fabs(plane.y) * extent.y + std::fabs(plane.z) * extent.z;
+        if (distance + radius < 0.0f) return -1;
+        if (distance - radius >= 0.0f) return 1;
+        return 0;
+    }
+
+    // Slab test: does origin + t * direction hit the box for some t in [0, maxDistance]?
+    // Slab test; 'entry' receives the distance at which the ray enters the box (0 if it starts inside)
+    bool rayHitsBox(const BoundingBox& box, const glm::vec3& origin, const glm::vec3& inverseDirection, float maxDistance, float& entry) {
+        if (box.isEmpty()) return false;
+        float tMin = 0.0f, tMax = maxDistance;
+        for (int axis = 0; axis < 3; ++axis) {
+            float t1 = (box.min[axis] - origin[axis]) * inverseDirection[axis];
+            float t2 = (box.max[axis] - origin[axis]) * inverseDirection[axis];
+            if (t1 > t2) std::swap(t1, t2);
+            // NaN (origin on a slab plane of a parallel ray) leaves the interval unchanged
+            if (t1 > tMin) tMin = t1;
+            if (t2 < tMax) tMax = t2;
+            if (tMin > tMax) return false;
+        }
+        entry = tMin;
+        return true;
+    }
+
+    bool rayHitsBox(const BoundingBox& box, const glm::vec3& origin, const glm::vec3& inverseDirection, float maxDistance) {
+        float entry;
+        return rayHitsBox(box, origin, inverseDirection, maxDistance, entry);
+    }
+
+    bool sphereHitsBox(const BoundingBox& box, const glm::vec3& center, float radius) {
+        if (box.isEmpty()) return false;
+        glm::vec3 closest = glm::max(box.min, glm::min(center, box.max));
+        glm::vec3 offset = center - closest;
+        return glm::dot(offset, offset) <= radius * radius;
+    }
+}
+
+void Bvh::build(const std::vector<BoundingBox>& boxes) {
+    objectBoxes = boxes;
+    nodes.clear();
+    objectIndices.resize(boxes.size());
+    objectLeaf.assign(boxes.size(), 0);
+    depth = 0;
+    if (boxes.empty()) return;
+
+    centroids.resize(boxes.size());
+    for (uint32_t i = 0; i < boxes.size(); ++i) {
+        objectIndices[i] = i;
+        centroids[i] = boxes[i].isEmpty() ? glm::vec3(0.0f) : boxes[i].getCenter();
+    }
+
+    // At most 2n - 1 nodes, reserved up front so node references stay valid while children are added
+    nodes.reserve(2 * boxes.size());
+    Node root;
+    root.count = (uint32_t)boxes.size();
+    nodes.push_back(root);
+    updateNodeBounds(0);
+    subdivide(0);
+
+    for (uint32_t n = 0; n < nodes.size(); ++n) {
+        for (uint32_t i = 0; i < nodes[n].count; ++i) objectLeaf[objectIndices[nodes[n].first + i]] = n;
+    }
+    centroids.clear();
+    centroids.shrink_to_fit();
+    depth = getDepth();
+}
+
+bool Bvh::findSplit(const Node& node, int& bestAxis, float& bestPosition) const {
+    BoundingBox centroidBounds;
+    for (uint32_t i = 0; i < node.count; ++i) centroidBounds.expand(centroids[objectIndices[node.first + i]]);
+
+    float bestCost = std::numeric_limits<float>::max();
+    for (int axis = 0; axis < 3; ++axis) {
+        float low = centroidBounds.min[axis], high = centroidBounds.max[axis];
+        if (!(high > low)) continue; // All centroids in one plane
+
+        // Bin the objects by centroid
+        BoundingBox binBoxes[binCount];
+        uint32_t binCounts[binCount] = {};
+        float scale = binCount / (high - low);
+        for (uint32_t i = 0; i < node.count; ++i) {
+            uint32_t object = objectIndices[node.first + i];
+            uint32_t bin = std::min(binCount - 1, (uint32_t)((centroids[object][axis] - low) * scale));
+            binCounts[bin]++;
+            binBoxes[bin].expand(objectBoxes[object]);
+        }
+
+        // Sweep from both sides: area and count left / right of every bin boundary
+        float leftArea[binCount - 1], rightArea[binCount - 1];
+        uint32_t leftCount[binCount - 1], rightCount[binCount - 1];
+        BoundingBox leftBox, rightBox;
+        uint32_t leftSum = 0, rightSum = 0;
+        for (uint32_t i = 0; i < binCount - 1; ++i) {
+            leftSum += binCounts[i];
+            leftCount[i] = leftSum;
+            leftBox.expand(binBoxes[i]);
+            leftArea[i] = surfaceArea(leftBox);
+            rightSum += binCounts[binCount - 1 - i];
+            rightCount[binCount - 2 - i] = rightSum;
+            rightBox.expand(binBoxes[binCount - 1 - i]);
+            rightArea[binCount - 2 - i] = surfaceArea(rightBox);
+        }
+
+        for (uint32_t i = 0; i < binCount - 1; ++i) {
+            if (leftCount[i] == 0 || rightCount[i] == 0) continue;
+            float cost = leftCount[i] * leftArea[i] + rightCount[i] * rightArea[i];
+            if (cost < bestCost) {
+                bestCost = cost;
+                bestAxis = axis;
+                bestPosition = low + (i + 1) / scale;
+            }
+        }
+    }
+    // Splitting must be cheaper than testing every object of the node
+    return bestCost < node.count * surfaceArea(node.bounds);
+}
+
+void Bvh::subdivide(uint32_t rootIndex) {
+    // Iterative, so badly distributed objects cannot overflow the call stack
+    std::vector<uint32_t> stack(1, rootIndex);
+    while (!stack.empty()) {
+        uint32_t nodeIndex = stack.back();
+        stack.pop_back();
+        uint32_t first = nodes[nodeIndex].first, count = nodes[nodeIndex].count;
+        if (count <= maxLeafObjects) continue;
+
+        int axis = 0;
+        float position = 0.0f;
+        uint32_t* begin = objectIndices.data() + first;
+        uint32_t* end = begin + count;
+        uint32_t leftCount = 0;
+        if (findSplit(nodes[nodeIndex], axis, position)) {
+            uint32_t* middle = std::partition(begin, end, [&](uint32_t object) { return centroids[object][axis] < position; });
+            leftCount = (uint32_t)(middle - begin);
+        } else if (count <= 4 * maxLeafObjects) {
+            continue; // SAH prefers a leaf
+        }
+
+        if (leftCount == 0 || leftCount == count) {
+            // No usable SAH split (e.g. identical centroids): median of the widest centroid axis
+            BoundingBox centroidBounds;
+            for (uint32_t* it = begin; it != end; ++it) centroidBounds.expand(centroids[*it]);
+            glm::vec3 size = centroidBounds.max - centroidBounds.min;
+            axis = size.x >= size.y && size.x >= size.z ? 0 : (size.y >= size.z ? 1 : 2);
+            leftCount = count / 2;
+            std::nth_element(begin, begin + leftCount, end,
+                [&](uint32_t a, uint32_t b) { return centroids[a][axis] < centroids[b][axis]; });
+        }
+
+        uint32_t leftIndex = (uint32_t)nodes.size();
+        Node left, right;
+        left.first = first;
+        left.count = leftCount;
+        left.parent = nodeIndex;
+        right.first = first + leftCount;
+        right.count = count - leftCount;
+        right.parent = nodeIndex;
+        nodes.push_back(left);
+        nodes.push_back(right);
+        nodes[nodeIndex].first = leftIndex;
+        nodes[nodeIndex].count = 0;
+        updateNodeBounds(leftIndex);
+        updateNodeBounds(leftIndex + 1);
+        stack.push_back(leftIndex);
+        stack.push_back(leftIndex + 1);
+    }
+}
+
+void Bvh::updateNodeBounds(uint32_t nodeIndex) {
+    Node& node = nodes[nodeIndex];
+    node.bounds = BoundingBox();
+    if (node.count > 0) {
+        for (uint32_t i = 0; i < node.count; ++i) node.bounds.expand(objectBoxes[objectIndices[node.first + i]]);
+    } else {
+        node.bounds.expand(nodes[node.first].bounds);
+        node.bounds.expand(nodes[node.first + 1].bounds);
+    }
+}
+
+void Bvh::update(uint32_t object, const BoundingBox& box) {
+    objectBoxes[object] = box;
+    // Refit the path to the root (the leaf from its objects, every ancestor from its two children)
+    uint32_t nodeIndex = objectLeaf[object];
+    while (true) {
+        updateNodeBounds(nodeIndex);
+        if (nodeIndex == 0) break;
+        nodeIndex = nodes[nodeIndex].parent;
+    }
+}
+
+void Bvh::addSubtree(uint32_t nodeIndex, std::vector<uint32_t>& objects) const {
+    std::vector<uint32_t> stack(1, nodeIndex);
+    while (!stack.empty()) {
+        const Node& node = nodes[stack.back()];
+        stack.pop_back();
+        if (node.count > 0) {
+            for (uint32_t i = 0; i < node.count; ++i) {
+                uint32_t object = objectIndices[node.first + i];
+                if (!objectBoxes[object].isEmpty()) objects.push_back(object);
+            }
+        } else {
+            stack.push_back(node.first);
+            stack.push_back(node.first + 1);
+        }
+    }
+}
+
+void Bvh::queryFrustum(const Frustum& frustum, std::vector<uint32_t>& objects) const {
+    if (nodes.empty()) return;
+    // Bit p set = plane p still has to be tested (the parent straddles it)
+    std::vector<std::pair<uint32_t, uint32_t>> stack(1, std::make_pair(0u, 0x3Fu));
+    while (!stack.empty()) {
+        uint32_t nodeIndex = stack.back().first, planeMask = stack.back().second;
+        stack.pop_back();
+        const Node& node = nodes[nodeIndex];
+        if (node.bounds.isEmpty()) continue;
+
+        bool outside = false;
+        for (int p = 0; p < 6 && !outside; ++p) {
+            if (!(planeMask & (1u << p))) continue;
+            int side = classify(node.bounds, frustum.planes[p]);
+            if (side < 0) outside = true;
+            else if (side > 0) planeMask &= ~(1u << p);
+        }
+        if (outside) continue;
+
+        if (planeMask == 0) {
+            addSubtree(nodeIndex, objects); // Completely inside: no further tests below this node
+        } else if (node.count > 0) {
+            for (uint32_t i = 0; i < node.count; ++i) {
+                uint32_t object = objectIndices[node.first + i];
+                const BoundingBox& box = objectBoxes[object];
+                if (box.isEmpty()) continue;
+                bool objectOutside = false;
+                for (int p = 0; p < 6 && !objectOutside; ++p) {
+                    if (planeMask & (1u << p)) objectOutside = classify(box, frustum.planes[p]) < 0;
+                }
+                if (!objectOutside) objects.push_back(object);
+            }
+        } else {
+            stack.push_back(std::make_pair(node.first, planeMask));
+            stack.push_back(std::make_pair(node.first + 1, planeMask));
+        }
+    }
+}
+
+void Bvh::queryRay(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, std::vector<uint32_t>& objects) const {
+    if (nodes.empty()) return;
+    glm::vec3 inverseDirection(1.0f / direction.x, 1.0f / direction.y, 1.0f / direction.z); // inf for axis-parallel rays
+    std::vector<uint32_t> stack(1, 0u);
+    while (!stack.empty()) {
+        const Node& node = nodes[stack.back()];
+        stack.pop_back();
+        if (!rayHitsBox(node.bounds, origin, inverseDirection, maxDistance)) continue;
+        if (node.count > 0) {
+            for (uint32_t i = 0; i < node.count; ++i) {
+                uint32_t object = objectIndices[node.first + i];
+                if (rayHitsBox(objectBoxes[object], origin, inverseDirection, maxDistance)) objects.push_back(object);
+            }
+        } else {
+            stack.push_back(node.first);
+            stack.push_back(node.first + 1);
+        }
+    }
+}
+
+float Bvh::queryRayClosest(const glm::vec3& origin, const glm::vec3& direction, float maxDistance,
+                           const std::function<float(const uint32_t*, uint32_t, float)>& intersect) const {
+    float closest = maxDistance;
+    glm::vec3 inverseDirection(1.0f / direction.x, 1.0f / direction.y, 1.0f / direction.z);
+    float entry;
+    if (nodes.empty() || !rayHitsBox(nodes[0].bounds, origin, inverseDirection, closest, entry)) return closest;
+
+    // Node + distance at which the ray enters it; the nearer child is pushed last so it is visited first.
+    // The stack never holds more than depth + 1 entries: no allocation for any sensible tree.
+    typedef std::pair<uint32_t, float> Entry;
+    Entry fixedStack[64];
+    std::vector<Entry> heapStack;
+    Entry* stack = fixedStack;
+    if (depth + 1 > 64) {
+        heapStack.resize(depth + 1);
+        stack = heapStack.data();
+    }
+    size_t stackSize = 0;
+    stack[stackSize++] = Entry(0u, entry);
+    uint32_t candidates[maxLeafObjects * 4];
+    const uint32_t candidateCapacity = sizeof(candidates) / sizeof(candidates[0]);
+    while (stackSize > 0) {
+        Entry top = stack[--stackSize];
+        if (top.second > closest) continue; // Entered only after the closest hit found meanwhile
+        const Node& node = nodes[top.first];
+        if (node.count > 0) {
+            // Objects whose own boxes are entered before the closest hit, handed over in groups
+            uint32_t count = 0;
+            for (uint32_t i = 0; i < node.count; ++i) {
+                uint32_t object = objectIndices[node.first + i];
+                if (!rayHitsBox(objectBoxes[object], origin, inverseDirection, closest)) continue;
+                candidates[count++] = object;
+                if (count == candidateCapacity) {
+                    closest = std::min(closest, intersect(candidates, count, closest));
+                    count = 0;
+                }
+            }
+            if (count > 0) closest = std::min(closest, intersect(candidates, count, closest));
+            continue;
+        }
+        float entryA = 0.0f, entryB = 0.0f;
+        bool hitA = rayHitsBox(nodes[node.first].bounds, origin, inverseDirection, closest, entryA);
+        bool hitB = rayHitsBox(nodes[node.first + 1].bounds, origin, inverseDirection, closest, entryB);
+        if (hitA && hitB) {
+            bool aFirst = entryA <= entryB;
+            stack[stackSize++] = aFirst ? Entry(node.first + 1, entryB) : Entry(node.first, entryA);
+            stack[stackSize++] = aFirst ? Entry(node.first, entryA) : Entry(node.first + 1, entryB);
+        } else if (hitA) {
+            stack[stackSize++] = Entry(node.first, entryA);
+        } else if (hitB) {
+            stack[stackSize++] = Entry(node.first + 1, entryB);
+        }
+    }
+    return closest;
+}
+
+void Bvh::querySphere(const glm::vec3& center, float radius, std::vector<uint32_t>& objects) const {
+    if (nodes.empty()) return;
+    std::vector<uint32_t> stack(1, 0u);
+    while (!stack.empty()) {
+        const Node& node = nodes[stack.back()];
+        stack.pop_back();
+        if (!sphereHitsBox(node.bounds, center, radius)) continue;
+        if (node.count > 0) {
+            for (uint32_t i = 0; i < node.count; ++i) {
+                uint32_t object = objectIndices[node.first + i];
+                if (sphereHitsBox(objectBoxes[object], center, radius)) objects.push_back(object);
+            }
+        } else {
+            stack.push_back(node.first);
+            stack.push_back(node.first + 1);
+        }
+    }
+}
+
+int Bvh::getDepth() const {
+    if (nodes.empty()) return 0;
+    int depth = 0;
+    std::vector<std::pair<uint32_t, int>> stack(1, std::make_pair(0u, 1));
+    while (!stack.empty()) {
+        std::pair<uint32_t, int> entry = stack.back();
+        stack.pop_back();
+        depth = std::max(depth, entry.second);
+        const Node& node = nodes[entry.first];
+        if (node.count == 0) {
+            stack.push_back(std::make_pair(node.first, entry.second + 1));
+            stack.push_back(std::make_pair(node.first + 1, entry.second + 1));
+        }
+    }
+    return depth;
+}
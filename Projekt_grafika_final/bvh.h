@@ -0,0 +1,75 @@
+#ifndef BVH_H
+#define BVH_H
+
+#include <vector>
+#include <cstdint>
+#include <functional>
+#include <glm/glm.hpp>
+#include "bounds.h"
+#include "frustumCuller.h"
+
+// Bounding volume hierarchy over object boxes (world space), for culling and spatial queries in
+// O(log n) instead of a loop over every object. Objects are identified by their index in the box list
+// passed to build(). Built top-down with binned SAH (surface area heuristic); moving objects are
+// handled with update(), which refits only the nodes above the object (the tree shape is kept, so
+// query cost slowly degrades if objects move far; build() again from time to time in that case).
+class Bvh {
+public:
+    // Objects per leaf the builder aims for (leaves may get larger when SAH prefers it)
+    static const uint32_t maxLeafObjects = 4;
+    // Number of centroid bins per axis in the split search
+    static const uint32_t binCount = 12;
+
+    // Full rebuild over the given boxes (object i = boxes[i]).
+    // Objects with empty boxes are kept but never returned by queries (every Shape has bounds after setupMesh()).
+    void build(const std::vector<BoundingBox>& boxes);
+
+    // Moves object to a new box and refits its leaf and all ancestors
+    void update(uint32_t object, const BoundingBox& box);
+
+    // Objects whose boxes intersect the frustum. Subtrees completely inside are added without testing
+    // their objects, and planes a node is completely inside of are skipped for its children.
+    void queryFrustum(const Frustum& frustum, std::vector<uint32_t>& objects) const;
+    // Objects whose boxes the ray origin + t * direction (0 <= t <= maxDistance) passes through
+    void queryRay(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, std::vector<uint32_t>& objects) const;
+    // Nearest hit along the ray: leaves are visited front to back, and nodes starting beyond the closest hit so far
+    // are skipped. intersect(objects, count, closest) is called with objects of a leaf whose boxes the ray enters
+    // before 'closest', and returns the distance of its nearest hit among them (or 'closest' for none).
+    // Returns the distance of the nearest hit, maxDistance if there is none.
+    float queryRayClosest(const glm::vec3& origin, const glm::vec3& direction, float maxDistance,
+                          const std::function<float(const uint32_t* objects, uint32_t count, float closest)>& intersect) const;
+    // Objects whose boxes intersect the sphere
+    void querySphere(const glm::vec3& center, float radius, std::vector<uint32_t>& objects) const;
+
+    size_t getObjectCount() const { return objectBoxes.size(); }
+    size_t getNodeCount() const { return nodes.size(); }
+    const BoundingBox& getObjectBox(uint32_t object) const { return objectBoxes[object]; }
+    // Box around everything (empty if there are no objects)
+    BoundingBox getBounds() const { return nodes.empty() ? BoundingBox() : nodes[0].bounds; }
+    // Longest root-to-leaf path (1 for a single leaf)
+    int getDepth() const;
+
+private:
+    // Children of inner nodes are stored next to each other (first, first + 1), always after their parent.
+    // Leaves reference a range of objectIndices.
+    struct Node {
+        BoundingBox bounds;
+        uint32_t first = 0;  // Leaf: first entry in objectIndices; inner node: index of the left child
+        uint32_t count = 0;  // Objects in the leaf, 0 for inner nodes
+        uint32_t parent = 0; // Unused for the root
+    };
+
+    std::vector<Node> nodes;
+    std::vector<uint32_t> objectIndices; // Objects in leaf order
+    std::vector<BoundingBox> objectBoxes;
+    std::vector<uint32_t> objectLeaf;    // Leaf node of every object (for update())
+    std::vector<glm::vec3> centroids;    // Build-time only
+    int depth = 0;                       // getDepth() after build(), sizes the traversal stack of queryRayClosest()
+
+    void subdivide(uint32_t nodeIndex);
+    bool findSplit(const Node& node, int& axis, float& position) const;
+    void updateNodeBounds(uint32_t nodeIndex);
+    void addSubtree(uint32_t nodeIndex, std::vector<uint32_t>& objects) const;
+};
+
+#endif // BVH_H
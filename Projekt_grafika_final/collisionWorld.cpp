@@ -0,0 +1,327 @@
+#include "collisionWorld.h"
+#include <algorithm>
+#include <utility>
+#include <cmath>
+
+const float CollisionWorld::skinWidth = 1e-3f;
+
+// Cell coordinates are packed into 21 bits each; cells further apart than that share a slot, which
+// only adds candidates
+static const int coordinateBits = 21;
+static const int coordinateOffset = 1 << (coordinateBits - 1);
+
+CollisionWorld::CollisionWorld(float cellSize) : cellSize(cellSize) {}
+
+void CollisionWorld::add(const Shape* shape) {
+    addGeometry(*shape, shape->modelMatrix);
+}
+
+void CollisionWorld::add(const LodShape* shape) {
+    // The levels are drawn with the LodShape's matrix, not their own
+    addGeometry(*shape->getLevel(0), shape->modelMatrix);
+}
+
+void CollisionWorld::addGeometry(const Shape& shape, const glm::mat4& matrix) {
+    std::vector<GLfloat> vertices;
+    std::vector<GLuint> indices;
+    shape.getGeometry(vertices, indices);
+    for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+        glm::vec3 corners[3];
+        for (int corner = 0; corner < 3; ++corner) {
+            const GLfloat* v = &vertices[indices[i + corner] * 11];
+            corners[corner] = glm::vec3(matrix * glm::vec4(v[0], v[1], v[2], 1.0f));
+        }
+        addTriangle(corners[0], corners[1], corners[2]);
+    }
+}
+
+void CollisionWorld::addTriangle(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c) {
+    glm::vec3 normal = glm::cross(b - a, c - a);
+    float length = glm::length(normal);
+    if (length < 1e-12f) return; // Degenerate: nothing to collide with
+    Triangle triangle;
+    triangle.a = a;
+    triangle.b = b;
+    triangle.c = c;
+    triangle.normal = normal / length;
+    triangle.min = glm::min(a, glm::min(b, c));
+    triangle.max = glm::max(a, glm::max(b, c));
+    triangles.push_back(triangle);
+}
+
+void CollisionWorld::clear() {
+    triangles.clear();
+    table.clear();
+    cellTriangles.clear();
+    cellCount = 0;
+    candidates.clear();
+    triangleStamps.clear();
+}
+
+glm::ivec3 CollisionWorld::getCellCoordinates(const glm::vec3& point) const {
+    return glm::ivec3(static_cast<int>(std::floor(point.x / cellSize)),
+                      static_cast<int>(std::floor(point.y / cellSize)),
+                      static_cast<int>(std::floor(point.z / cellSize)));
+}
+
+uint64_t CollisionWorld::getKey(const glm::ivec3& cell) {
+    const uint64_t mask = (1ull << coordinateBits) - 1;
+    return (static_cast<uint64_t>(cell.x + coordinateOffset) & mask) |
+           ((static_cast<uint64_t>(cell.y + coordinateOffset) & mask) << coordinateBits) |
+           ((static_cast<uint64_t>(cell.z + coordinateOffset) & mask) << (coordinateBits * 2));
+}
+
+size_t CollisionWorld::getSlot(uint64_t key, size_t mask) {
+    // 64-bit mix (splitmix64 finalizer): neighbouring cells land far apart
+    key ^= key >> 30;
+    key *= 0xbf58476d1ce4e5b9ull;
+    key ^= key >> 27;
+    key *= 0x94d049bb133111ebull;
+    key ^= key >> 31;
+    return static_cast<size_t>(key) & mask;
+}
+
+const CollisionWorld::Cell* CollisionWorld::findCell(uint64_t key) const {
+    if (table.empty()) return nullptr;
+    size_t mask = table.size() - 1;
+    for (size_t slot = getSlot(key, mask);; slot = (slot + 1) & mask) {
+        const Cell& cell = table[slot];
+        if (cell.key == key) return &cell;
+        if (cell.key == emptyKey) return nullptr;
+    }
+}
+
+void CollisionWorld::build() {
+    // Every (cell, triangle) pair for the cells the triangle's box touches, sorted so each cell's list is contiguous
+    std::vector<std::pair<uint64_t, uint32_t>> entries;
+    entries.reserve(triangles.size() * 4);
+    for (size_t i = 0; i < triangles.size(); ++i) {
+        const Triangle& triangle = triangles[i];
+        glm::ivec3 first = getCellCoordinates(triangle.min);
+        glm::ivec3 last = getCellCoordinates(triangle.max);
+        for (int z = first.z; z <= last.z; ++z) {
+            for (int y = first.y; y <= last.y; ++y) {
+                for (int x = first.x; x <= last.x; ++x) {
+                    entries.push_back(std::make_pair(getKey(glm::ivec3(x, y, z)), static_cast<uint32_t>(i)));
+                }
+            }
+        }
+    }
+    std::sort(entries.begin(), entries.end());
+
+    cellCount = 0;
+    for (size_t i = 0; i < entries.size(); ++i) {
+        if (i == 0 || entries[i].first != entries[i - 1].first) cellCount++;
+    }
+    size_t tableSize = 16;
+    while (tableSize < cellCount * 2) tableSize *= 2; // At most half full, so probe chains stay short
+    table.assign(tableSize, Cell());
+    cellTriangles.resize(entries.size());
+    size_t mask = tableSize - 1;
+    Cell* cell = nullptr;
+    for (size_t i = 0; i < entries.size(); ++i) {
+        cellTriangles[i] = entries[i].second;
+        if (i > 0 && entries[i].first == entries[i - 1].first) {
+            cell->count++;
+            continue;
+        }
+        size_t slot = getSlot(entries[i].first, mask);
+        while (table[slot].key != emptyKey) slot = (slot + 1) & mask;
+        cell = &table[slot];
+        cell->key = entries[i].first;
+        cell->first = static_cast<uint32_t>(i);
+        cell->count = 1;
+    }
+    triangleStamps.assign(triangles.size(), 0);
+    stamp = 0;
+}
+
+void CollisionWorld::gatherCandidates(const glm::vec3& min, const glm::vec3& max) {
+    candidates.clear();
+    if (++stamp == 0) { // Wrapped around: old stamps could match again
+        std::fill(triangleStamps.begin(), triangleStamps.end(), 0);
+        stamp = 1;
+    }
+    glm::ivec3 first = getCellCoordinates(min);
+    glm::ivec3 last = getCellCoordinates(max);
+    for (int z = first.z; z <= last.z; ++z) {
+        for (int y = first.y; y <= last.y; ++y) {
+            for (int x = first.x; x <= last.x; ++x) {
+                const Cell* cell = findCell(getKey(glm::ivec3(x, y, z)));
+                if (!cell) continue;
+                for (uint32_t i = cell->first; i < cell->first + cell->count; ++i) {
+                    uint32_t triangle = cellTriangles[i];
+                    if (triangleStamps[triangle] == stamp) continue; // Already taken from another cell
+                    triangleStamps[triangle] = stamp;
+                    candidates.push_back(triangle);
+                }
+            }
+        }
+    }
+}
+
+glm::vec3 CollisionWorld::move(const glm::vec3& position, const glm::vec3& motion, float radius) {
+    // Every position reachable in this move stays within |motion| of the start, plus the push-out
+    float reach = glm::length(motion) + radius * 2.0f + skinWidth;
+    gatherCandidates(position - glm::vec3(reach), position + glm::vec3(reach));
+    if (candidates.empty()) return position + motion;
+
+    glm::vec3 base = pushOut(position, radius);
+    glm::vec3 velocity = motion;
+    glm::vec3 previousNormal(0.0f);
+    for (int slide = 0; slide < maxSlides; ++slide) {
+        float length = glm::length(velocity);
+        if (length < 1e-6f) break;
+
+        float closest = 1.0f;
+        glm::vec3 contact(0.0f);
+        bool hit = false;
+        glm::vec3 sweepMin = glm::min(base, base + velocity) - glm::vec3(radius);
+        glm::vec3 sweepMax = glm::max(base, base + velocity) + glm::vec3(radius);
+        for (uint32_t index : candidates) {
+            const Triangle& triangle = triangles[index];
+            if (overlaps(triangle, sweepMin, sweepMax) && sweepTriangle(triangle, base, velocity, radius, closest, contact)) hit = true;
+        }
+        if (!hit) {
+            base += velocity;
+            break;
+        }
+
+        // Stop skinWidth short of the contact, then slide what is left of the motion along the contact plane
+        glm::vec3 destination = base + velocity;
+        glm::vec3 normal = base + velocity * closest - contact;
+        float normalLength = glm::length(normal);
+        normal = normalLength > 1e-6f ? normal / normalLength : -velocity / length;
+        base += velocity * (std::max(closest * length - skinWidth, 0.0f) / length);
+
+        velocity = destination - base;
+        velocity -= normal * glm::dot(velocity, normal);
+        // In a crease between two surfaces the slide along one would push into the other: follow the crease
+        if (slide > 0 && glm::dot(velocity, previousNormal) < 0.0f) {
+            glm::vec3 crease = glm::cross(previousNormal, normal);
+            float creaseLength = glm::length(crease);
+            velocity = creaseLength > 1e-6f ? crease * (glm::dot(velocity, crease) / (creaseLength * creaseLength)) : glm::vec3(0.0f);
+        }
+        previousNormal = normal;
+    }
+    return base;
+}
+
+glm::vec3 CollisionWorld::pushOut(glm::vec3 center, float radius) const {
+    for (int pass = 0; pass < maxSlides; ++pass) {
+        bool moved = false;
+        for (uint32_t index : candidates) {
+            const Triangle& triangle = triangles[index];
+            if (!overlaps(triangle, center - glm::vec3(radius), center + glm::vec3(radius))) continue;
+            glm::vec3 offset = center - closestPointOnTriangle(center, triangle.a, triangle.b, triangle.c);
+            float distanceSquared = glm::dot(offset, offset);
+            if (distanceSquared >= radius * radius) continue;
+            float distance = std::sqrt(distanceSquared);
+            glm::vec3 direction;
+            if (distance > 1e-6f) {
+                direction = offset / distance;
+            } else {
+                direction = triangle.normal; // Centre on the triangle: out through the front
+            }
+            center += direction * (radius + skinWidth - distance);
+            moved = true;
+        }
+        if (!moved) break;
+    }
+    return center;
+}
+
+// First time in (0, maxRoot) at which a*x^2 + b*x + c changes sign: the smaller root. A smaller root at or
+// below zero means the sphere already touches (push-out takes care of that), not a contact ahead.
+static bool getFirstRoot(float a, float b, float c, float maxRoot, float& root) {
+    if (std::fabs(a) < 1e-12f) return false;
+    float determinant = b * b - 4.0f * a * c;
+    if (determinant < 0.0f) return false;
+    float squareRoot = std::sqrt(determinant);
+    float first = std::min((-b - squareRoot) / (2.0f * a), (-b + squareRoot) / (2.0f * a));
+    if (first <= 0.0f || first >= maxRoot) return false;
+    root = first;
+    return true;
+}
+
+bool CollisionWorld::sweepTriangle(const Triangle& triangle, const glm::vec3& base, const glm::vec3& velocity, float radius,
+                                   float& closest, glm::vec3& contact) {
+    // Both sides block: work with the side the sphere is on
+    glm::vec3 normal = triangle.normal;
+    float planeDistance = glm::dot(normal, base - triangle.a);
+    if (planeDistance < 0.0f) {
+        normal = -normal;
+        planeDistance = -planeDistance;
+    }
+    float normalVelocity = glm::dot(normal, velocity);
+
+    // Interval [t0, t1] in which the sphere touches the plane
+    float t0, t1;
+    bool parallel = std::fabs(normalVelocity) < 1e-9f;
+    if (parallel) {
+        if (planeDistance >= radius) return false;
+        t0 = 0.0f;
+        t1 = 1.0f;
+    } else {
+        t0 = (radius - planeDistance) / normalVelocity;
+        t1 = (-radius - planeDistance) / normalVelocity;
+        if (t0 > t1) std::swap(t0, t1);
+        if (t0 > closest || t1 < 0.0f) return false;
+        t0 = std::max(t0, 0.0f);
+        t1 = std::min(t1, 1.0f);
+    }
+
+    // Touching the plane inside the triangle while moving towards it: that is the first contact
+    if (normalVelocity < 0.0f && !parallel) {
+        glm::vec3 point = base - normal * radius + velocity * t0;
+        glm::vec3 n = triangle.normal;
+        if (glm::dot(glm::cross(triangle.b - triangle.a, point - triangle.a), n) >= 0.0f &&
+            glm::dot(glm::cross(triangle.c - triangle.b, point - triangle.b), n) >= 0.0f &&
+            glm::dot(glm::cross(triangle.a - triangle.c, point - triangle.c), n) >= 0.0f) {
+            if (t0 >= closest) return false;
+            closest = t0;
+            contact = point;
+            return true;
+        }
+    }
+
+    // Otherwise it can only touch a corner or an edge first
+    bool found = false;
+    float maxRoot = std::min(closest, t1);
+    float velocitySquared = glm::dot(velocity, velocity);
+    const glm::vec3* corners[3] = { &triangle.a, &triangle.b, &triangle.c };
+    for (int i = 0; i < 3; ++i) {
+        const glm::vec3& corner = *corners[i];
+        float root;
+        if (getFirstRoot(velocitySquared, 2.0f * glm::dot(velocity, base - corner),
+                          glm::dot(corner - base, corner - base) - radius * radius, maxRoot, root)) {
+            maxRoot = root;
+            closest = root;
+            contact = corner;
+            found = true;
+        }
+    }
+    for (int i = 0; i < 3; ++i) {
+        const glm::vec3& start = *corners[i];
+        glm::vec3 edge = *corners[(i + 1) % 3] - start;
+        glm::vec3 baseToStart = start - base;
+        float edgeSquared = glm::dot(edge, edge);
+        float edgeVelocity = glm::dot(edge, velocity);
+        float edgeBase = glm::dot(edge, baseToStart);
+        float root;
+        if (getFirstRoot(edgeSquared * -velocitySquared + edgeVelocity * edgeVelocity,
+                          edgeSquared * 2.0f * glm::dot(velocity, baseToStart) - 2.0f * edgeVelocity * edgeBase,
+                          edgeSquared * (radius * radius - glm::dot(baseToStart, baseToStart)) + edgeBase * edgeBase,
+                          maxRoot, root)) {
+            // Only a contact within the edge segment counts (beyond it the corner test applies)
+            float along = (edgeVelocity * root - edgeBase) / edgeSquared;
+            if (along >= 0.0f && along <= 1.0f) {
+                maxRoot = root;
+                closest = root;
+                contact = start + edge * along;
+                found = true;
+            }
+        }
+    }
+    return found;
+}
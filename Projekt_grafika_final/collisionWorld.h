@@ -0,0 +1,94 @@
+#ifndef COLLISION_WORLD_H
+#define COLLISION_WORLD_H
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include "shape.h"
+#include "lodShape.h"
+
+// Keeps a sphere (the camera) out of the static scene geometry. The world-space triangles of the static
+// shapes are copied once and indexed by a spatial hash: the uniform grid of cellSize cubes is never
+// allocated, only the cells some triangle's box touches are stored, in an open-addressing table keyed by
+// the packed cell coordinates. A move only looks at the triangles of the few cells around it, so its cost
+// depends on the local triangle density and not on the size of the scene.
+//
+// move() sweeps the sphere along the motion (continuous: fast moves cannot tunnel through thin walls),
+// stops it just before the first triangle it would touch and slides the rest of the motion along the
+// contact plane, up to maxSlides times. Both sides of every triangle block. Needs no OpenGL context.
+class CollisionWorld {
+public:
+    static const int maxSlides = 4;
+    // Distance kept between the sphere and the triangles it stops at, so the next move starts clear
+    static const float skinWidth;
+
+    // Cells of about twice the sphere radius keep the cells looked at per move to a handful
+    explicit CollisionWorld(float cellSize = 0.5f);
+
+    // Copies the shape's triangles with its current modelMatrix (later changes are not seen: static
+    // geometry only). A LodShape collides with its finest level.
+    void add(const Shape* shape);
+    void add(const LodShape* shape);
+    void addTriangle(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c);
+    void clear();
+
+    // Builds the spatial hash over the triangles added so far
+    void build();
+
+    // Where a sphere at 'position' ends up when moved by 'motion': the full motion if nothing is in the way,
+    // otherwise stopped and slid along the surfaces it hits. A sphere starting inside geometry is pushed out first.
+    // Not thread-safe (uses per-world scratch buffers).
+    glm::vec3 move(const glm::vec3& position, const glm::vec3& motion, float radius);
+
+    size_t getTriangleCount() const { return triangles.size(); }
+    // Non-empty cells of the hash
+    size_t getCellCount() const { return cellCount; }
+    // Triangles looked at by the last move()
+    size_t getCandidateCount() const { return candidates.size(); }
+
+private:
+    struct Triangle {
+        glm::vec3 a, b, c;
+        glm::vec3 normal; // Unit length
+        glm::vec3 min, max; // Bounding box, for a cheap reject before the exact tests
+    };
+    // One hash table slot: the cell's triangles are cellTriangles[first, first + count)
+    struct Cell {
+        uint64_t key = emptyKey;
+        uint32_t first = 0;
+        uint32_t count = 0;
+    };
+    static const uint64_t emptyKey = ~0ull;
+
+    float cellSize;
+    std::vector<Triangle> triangles;
+    std::vector<Cell> table;             // Power-of-two size, linear probing
+    std::vector<uint32_t> cellTriangles; // Triangle indices grouped by cell
+    size_t cellCount = 0;
+
+    // Scratch for move(): triangles near the motion, deduplicated with a stamp per triangle
+    std::vector<uint32_t> candidates;
+    std::vector<uint32_t> triangleStamps;
+    uint32_t stamp = 0;
+
+    void addGeometry(const Shape& shape, const glm::mat4& matrix);
+    glm::ivec3 getCellCoordinates(const glm::vec3& point) const;
+    static uint64_t getKey(const glm::ivec3& cell);
+    static size_t getSlot(uint64_t key, size_t mask);
+    const Cell* findCell(uint64_t key) const;
+
+    // Collects the triangles of every cell overlapping [min, max] into 'candidates'
+    void gatherCandidates(const glm::vec3& min, const glm::vec3& max);
+    static bool overlaps(const Triangle& triangle, const glm::vec3& min, const glm::vec3& max) {
+        return triangle.min.x <= max.x && triangle.max.x >= min.x && triangle.min.y <= max.y && triangle.max.y >= min.y &&
+               triangle.min.z <= max.z && triangle.max.z >= min.z;
+    }
+    // Moves the centre out of every candidate it is closer than radius to
+    glm::vec3 pushOut(glm::vec3 center, float radius) const;
+    // First contact of the sphere moving from base by velocity (0 <= t < closest); updates closest and contact
+    static bool sweepTriangle(const Triangle& triangle, const glm::vec3& base, const glm::vec3& velocity, float radius,
+                              float& closest, glm::vec3& contact);
+};
+
+#endif // COLLISION_WORLD_H
@@ -1,18 +1,20 @@
-#ifndef CUBE_H
-#define CUBE_H
-
-#include "shape.h"
-
-class Cube : public Shape {
-private:
-    float width, height, depth;
-    glm::vec3 faceColor; // Single color for all faces, or you can get more complex
-    
-protected:
-    void generateGeometry() override; // Implementation of geometry generation
-
-public:
-    Cube(float w, float h, float d, const glm::vec3& color);
-};
-
+#ifndef CUBE_H
+#define CUBE_H
+
+#include "shape.h"
+
+class Cube : public Shape {
+private:
+    float width, height, depth;
+    glm::vec3 faceColor; // Single color for all faces, or you can get more complex
+    
+protected:
+    void countGeometry(size_t& vertexCount, size_t& indexCount) const override;
+    void writeGeometry(GeometryWriter& writer) const override; // Implementation of geometry generation
+    std::string getMeshKey() const override; // Dimensions + color identify the geometry
+
+public:
+    Cube(float w, float h, float d, const glm::vec3& color);
+};
+
 #endif // CUBE_H
\ No newline at end of file
@@ -1,122 +1,124 @@
-#include "Cylinder.h"
-#include <cmath>
-#include <vector> // For std::vector in helper method
-
-Cylinder::Cylinder(float baseRadius, float topRadius, float height, unsigned int sectors, unsigned int stacks, bool smooth, const glm::vec3& color)
-    : baseRadius(baseRadius), topRadius(topRadius), height(height), sectorCount(sectors), stackCount(stacks), smoothShading(smooth), cylinderColor(color) {
-    if (stackCount == 0) stackCount = 1; // At least 1 stack
-	if (sectorCount == 0) sectorCount = 36; // At least 36 sectors for a full circle
-    Type = ShapeType::SHAPE_TYPE_CYLINDER;
-}
-
-void Cylinder::generateGeometry() {
-    vertices_data.clear();
-    indices_data.clear();
-
-    float halfHeight = height / 2.0f;
-    float sectorStep = 2.0f * glm::pi<float>() / sectorCount;
-    float currentAngle;
-
-    // --- Side Walls ---
-    GLuint baseSideIndex = 0; // Starting index for side walls
-
-    for (unsigned int i = 0; i <= stackCount; ++i) {
-        float stackY = -halfHeight + (float)i / stackCount * height;
-        float currentRadius = baseRadius + (float)i / stackCount * (topRadius - baseRadius); // Radius interpolation
-
-        for (unsigned int j = 0; j <= sectorCount; ++j) {
-            currentAngle = j * sectorStep;
-            float x = currentRadius * cosf(currentAngle);
-            float z = currentRadius * sinf(currentAngle);
-
-            glm::vec3 normal;
-            if (smoothShading && (topRadius != 0 || baseRadius != 0)) { // Avoid division by zero if radius is 0
-                // Smooth shading: normal perpendicular to the side surface
-                // If it's a cone, the normal is more complex. For a cylinder:
-                if (topRadius == baseRadius) { // Pure cylinder
-                     normal = glm::normalize(glm::vec3(cosf(currentAngle), 0.0f, sinf(currentAngle)));
-                } else { // Cone or truncated cone - simplified normal (better would require more geometry)
-                    glm::vec3 tangent1 = glm::vec3(-sinf(currentAngle), 0.0f, cosf(currentAngle));
-                    glm::vec3 tangent2 = glm::vec3(cosf(currentAngle) * (topRadius-baseRadius)/height, 1.0f, sinf(currentAngle) * (topRadius-baseRadius)/height );
-                    normal = glm::normalize(glm::cross(tangent2,tangent1)); // May need to be reversed
-                }
-            } else {
-                // Flat shading (normal per face, harder to do per vertex without duplication)
-                // For simplicity, use radial normal, as in smooth
-                 normal = glm::normalize(glm::vec3(cosf(currentAngle), 0.0f, sinf(currentAngle)));
-            }
-            
-            // Texture coordinates for side walls
-            float u = (float)j / sectorCount;
-            float v = (float)i / stackCount;
-
-            addVertex(glm::vec3(x, stackY, z), cylinderColor, glm::vec2(u, v), normal);
-        }
-    }
-
-    // Indices for side walls
-    for (unsigned int i = 0; i < stackCount; ++i) {
-        GLuint k1 = baseSideIndex + i * (sectorCount + 1); // Start of the current "stack"
-        GLuint k2 = k1 + (sectorCount + 1);           // Start of the next "stack"
-
-        for (unsigned int j = 0; j < sectorCount; ++j, ++k1, ++k2) {
-            indices_data.push_back(k1);
-            indices_data.push_back(k2);
-            indices_data.push_back(k1 + 1);
-
-            indices_data.push_back(k2);
-            indices_data.push_back(k2 + 1);
-            indices_data.push_back(k1 + 1);
-        }
-    }
-    baseSideIndex += (stackCount + 1) * (sectorCount + 1);
-
-
-    // --- Caps (Bases) ---
-    // Bottom cap
-    if (baseRadius > 0.0f) {
-        GLuint bottomCenterIndex = baseSideIndex;
-        addVertex(glm::vec3(0.0f, -halfHeight, 0.0f), cylinderColor, glm::vec2(0.5f, 0.5f), glm::vec3(0.0f, -1.0f, 0.0f));
-        baseSideIndex++;
-
-        for (unsigned int j = 0; j <= sectorCount; ++j) {
-            currentAngle = j * sectorStep;
-            float x = baseRadius * cosf(currentAngle);
-            float z = baseRadius * sinf(currentAngle);
-            float u = 0.5f + 0.5f * cosf(currentAngle); // Simple planar mapping for caps
-            float v = 0.5f + 0.5f * sinf(currentAngle);
-            addVertex(glm::vec3(x, -halfHeight, z), cylinderColor, glm::vec2(u, v), glm::vec3(0.0f, -1.0f, 0.0f));
-        }
-        // Indices for the bottom cap (triangle fan)
-        for (unsigned int j = 0; j < sectorCount; ++j) {
-            indices_data.push_back(bottomCenterIndex);
-            indices_data.push_back(baseSideIndex + j);
-            indices_data.push_back(baseSideIndex + j + 1);
-        }
-        baseSideIndex += (sectorCount + 1);
-    }
-
-
-    // Top cap
-    if (topRadius > 0.0f) {
-        GLuint topCenterIndex = baseSideIndex;
-        addVertex(glm::vec3(0.0f, halfHeight, 0.0f), cylinderColor, glm::vec2(0.5f, 0.5f), glm::vec3(0.0f, 1.0f, 0.0f));
-        baseSideIndex++;
-
-        for (unsigned int j = 0; j <= sectorCount; ++j) {
-            currentAngle = j * sectorStep;
-            float x = topRadius * cosf(currentAngle);
-            float z = topRadius * sinf(currentAngle);
-            float u = 0.5f + 0.5f * cosf(currentAngle);
-            float v = 0.5f + 0.5f * sinf(currentAngle);
-            addVertex(glm::vec3(x, halfHeight, z), cylinderColor, glm::vec2(u, v), glm::vec3(0.0f, 1.0f, 0.0f));
-        }
-        // Indices for the top cap
-        for (unsigned int j = 0; j < sectorCount; ++j) {
-            indices_data.push_back(topCenterIndex);
-            indices_data.push_back(baseSideIndex + j + 1); // Reversed order for CCW
-            indices_data.push_back(baseSideIndex + j);
-        }
-        // baseSideIndex += (sectorCount + 1); // Not needed, this is the last part
-    }
+#include "Cylinder.h"
+#include <cmath>
+#include <vector> // For std::vector in helper method
+#include "simdTrig.h"
+
+Cylinder::Cylinder(float baseRadius, float topRadius, float height, unsigned int sectors, unsigned int stacks, bool smooth, const glm::vec3& color)
+    : baseRadius(baseRadius), topRadius(topRadius), height(height), sectorCount(sectors), stackCount(stacks), smoothShading(smooth), cylinderColor(color) {
+    if (stackCount == 0) stackCount = 1; // At least 1 stack
+	if (sectorCount == 0) sectorCount = 36; // At least 36 sectors for a full circle
+    Type = ShapeType::SHAPE_TYPE_CYLINDER;
+    doubleSided = true; // Side and caps are not consistently wound for culling
+}
+
+std::string Cylinder::getMeshKey() const {
+    return makeMeshKey("Cylinder", { baseRadius, topRadius, height, (float)sectorCount, (float)stackCount,
+                                     smoothShading ? 1.0f : 0.0f, cylinderColor.r, cylinderColor.g, cylinderColor.b });
+}
+
+void Cylinder::countGeometry(size_t& vertexCount, size_t& indexCount) const {
+    // Side walls: (stacks + 1) rings of (sectors + 1) vertices, 2 triangles per quad
+    vertexCount = (size_t)(stackCount + 1) * (sectorCount + 1);
+    indexCount = (size_t)stackCount * sectorCount * 6;
+    // Each cap: center + ring, one triangle per sector
+    int capCount = (baseRadius > 0.0f ? 1 : 0) + (topRadius > 0.0f ? 1 : 0);
+    vertexCount += capCount * (sectorCount + 2);
+    indexCount += capCount * sectorCount * 3;
+}
+
+void Cylinder::writeGeometry(GeometryWriter& writer) const {
+    float halfHeight = height / 2.0f;
+    float sectorStep = 2.0f * glm::pi<float>() / sectorCount;
+
+    // sin/cos of every sector angle, computed once (SIMD) and shared by the side walls and both caps
+    size_t sectorEntries = sectorCount + 1;
+    std::vector<float> scratch(6 * sectorEntries);
+    float* sectorSin = scratch.data();
+    float* sectorCos = sectorSin + sectorEntries;
+    float* ringX = sectorCos + sectorEntries;  // Positions of the current ring
+    float* ringZ = ringX + sectorEntries;
+    float* normalX = ringZ + sectorEntries;    // Side normals, identical for every stack
+    float* normalZ = normalX + sectorEntries;
+    sinCosTable(0.0f, sectorStep, sectorEntries, sectorSin, sectorCos);
+
+    // Side normal: cross(tangent2, tangent1) of the two surface tangents works out to
+    // (cos, -slope, sin) / sqrt(1 + slope^2), so only the scale depends on the shape.
+    // Pure cylinders and flat shading get the plain radial normal (slope 0).
+    float slope = 0.0f;
+    if (smoothShading && (topRadius != 0 || baseRadius != 0) && topRadius != baseRadius) { // Cone or truncated cone
+        slope = (topRadius - baseRadius) / height;
+    }
+    float normalScale = 1.0f / sqrtf(1.0f + slope * slope);
+    float normalY = -slope * normalScale;
+    scaleRing(sectorCos, sectorSin, sectorEntries, normalScale, normalX, normalZ);
+
+    // --- Side Walls ---
+    GLuint baseSideIndex = 0; // Starting index for side walls
+
+    for (unsigned int i = 0; i <= stackCount; ++i) {
+        float stackY = -halfHeight + (float)i / stackCount * height;
+        float currentRadius = baseRadius + (float)i / stackCount * (topRadius - baseRadius); // Radius interpolation
+        scaleRing(sectorCos, sectorSin, sectorEntries, currentRadius, ringX, ringZ);
+
+        for (unsigned int j = 0; j <= sectorCount; ++j) {
+            // Texture coordinates for side walls
+            float u = (float)j / sectorCount;
+            float v = (float)i / stackCount;
+
+            writer.addVertex(glm::vec3(ringX[j], stackY, ringZ[j]), cylinderColor, glm::vec2(u, v), glm::vec3(normalX[j], normalY, normalZ[j]));
+        }
+    }
+
+    // Indices for side walls
+    for (unsigned int i = 0; i < stackCount; ++i) {
+        GLuint k1 = baseSideIndex + i * (sectorCount + 1); // Start of the current "stack"
+        GLuint k2 = k1 + (sectorCount + 1);           // Start of the next "stack"
+
+        for (unsigned int j = 0; j < sectorCount; ++j, ++k1, ++k2) {
+            writer.addTriangle(k1, k2, k1 + 1);
+            writer.addTriangle(k2, k2 + 1, k1 + 1);
+        }
+    }
+    baseSideIndex += (stackCount + 1) * (sectorCount + 1);
+
+
+    // --- Caps (Bases) ---
+    // Bottom cap
+    if (baseRadius > 0.0f) {
+        GLuint bottomCenterIndex = baseSideIndex;
+        writer.addVertex(glm::vec3(0.0f, -halfHeight, 0.0f), cylinderColor, glm::vec2(0.5f, 0.5f), glm::vec3(0.0f, -1.0f, 0.0f));
+        baseSideIndex++;
+
+        scaleRing(sectorCos, sectorSin, sectorEntries, baseRadius, ringX, ringZ);
+        for (unsigned int j = 0; j <= sectorCount; ++j) {
+            float u = 0.5f + 0.5f * sectorCos[j]; // Simple planar mapping for caps
+            float v = 0.5f + 0.5f * sectorSin[j];
+            writer.addVertex(glm::vec3(ringX[j], -halfHeight, ringZ[j]), cylinderColor, glm::vec2(u, v), glm::vec3(0.0f, -1.0f, 0.0f));
+        }
+        // Indices for the bottom cap (triangle fan)
+        for (unsigned int j = 0; j < sectorCount; ++j) {
+            writer.addTriangle(bottomCenterIndex, baseSideIndex + j, baseSideIndex + j + 1);
+        }
+        baseSideIndex += (sectorCount + 1);
+    }
+
+
+    // Top cap
+    if (topRadius > 0.0f) {
+        GLuint topCenterIndex = baseSideIndex;
+        writer.addVertex(glm::vec3(0.0f, halfHeight, 0.0f), cylinderColor, glm::vec2(0.5f, 0.5f), glm::vec3(0.0f, 1.0f, 0.0f));
+        baseSideIndex++;
+
+        scaleRing(sectorCos, sectorSin, sectorEntries, topRadius, ringX, ringZ);
+        for (unsigned int j = 0; j <= sectorCount; ++j) {
+            float u = 0.5f + 0.5f * sectorCos[j];
+            float v = 0.5f + 0.5f * sectorSin[j];
+            writer.addVertex(glm::vec3(ringX[j], halfHeight, ringZ[j]), cylinderColor, glm::vec2(u, v), glm::vec3(0.0f, 1.0f, 0.0f));
+        }
+        // Indices for the top cap
+        for (unsigned int j = 0; j < sectorCount; ++j) {
+            writer.addTriangle(topCenterIndex, baseSideIndex + j + 1, baseSideIndex + j); // Reversed order for CCW
+        }
+        // baseSideIndex += (sectorCount + 1); // Not needed, this is the last part
+    }
 }
\ No newline at end of file
@@ -1,32 +1,66 @@
-//default.vert
-
-#version 330 core
-layout (location = 0) in vec3 aPos;
-layout (location = 1) in vec3 aColor; // Still passed, but unused
-layout (location = 2) in vec2 aTex;
-layout (location = 3) in vec3 aNormal; // Normal input
-
-out vec3 color;     // Still passed
-out vec2 texCoord;
-out vec3 Normal;    // Normal output to fragment shader
-out vec3 crntPos;   // World space position output
-
-uniform mat4 camMatrix; // Combined view * projection matrix
-uniform mat4 model;     // Model matrix for this object
-
-void main()
-{
-    // Calculate the vertex position in world space
-    crntPos = vec3(model * vec4(aPos, 1.0f));
-    // Transform to clip space
-    gl_Position = camMatrix * vec4(crntPos, 1.0f);
-
-    // Pass data to the fragment shader
-    color = aColor;
-    texCoord = aTex;
-
-    // Correct normal transformation
-    // Use mat3(transpose(inverse(model))) to transform normals.
-    // This is important if the model is scaled non-uniformly.
-    Normal = mat3(model) * aNormal;
+//default.vert
+
+#version 330 core
+#ifdef PACKED_VERTICES
+// Packed format (see vertexFormat.h), the attributes are normalized integers
+layout (location = 0) in vec4 aPos;    // snorm16, relative to the mesh bounding box
+layout (location = 1) in vec4 aColor;  // unorm8, still passed, but unused
+layout (location = 2) in vec2 aTex;    // unorm16, relative to the mesh UV range
+layout (location = 3) in vec2 aNormal; // snorm16, octahedral encoded
+
+uniform vec3 meshPosOffset;   // Bounding box center
+uniform vec3 meshPosScale;    // Bounding box half extent
+uniform vec4 meshUvTransform; // UV offset (xy) and scale (zw)
+
+vec3 getPosition() { return meshPosOffset + aPos.xyz * meshPosScale; }
+vec3 getColor() { return aColor.rgb; }
+vec2 getTexCoord() { return meshUvTransform.xy + aTex * meshUvTransform.zw; }
+vec3 getNormal()
+{
+    // Unfold the octahedron
+    vec3 n = vec3(aNormal, 1.0f - abs(aNormal.x) - abs(aNormal.y));
+    if (n.z < 0.0f) n.xy = (1.0f - abs(n.yx)) * vec2(n.x >= 0.0f ? 1.0f : -1.0f, n.y >= 0.0f ? 1.0f : -1.0f);
+    return normalize(n);
+}
+#else
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec3 aColor; // Still passed, but unused
+layout (location = 2) in vec2 aTex;
+layout (location = 3) in vec3 aNormal; // Normal input
+
+vec3 getPosition() { return aPos; }
+vec3 getColor() { return aColor; }
+vec2 getTexCoord() { return aTex; }
+vec3 getNormal() { return aNormal; }
+#endif
+
+out vec3 color;     // Still passed
+out vec2 texCoord;
+out vec3 Normal;    // Normal output to fragment shader
+out vec3 crntPos;   // World space position output
+
+// Per-frame camera data, shared by all programs (std140, must match FrameDataBlock in frameUniforms.h)
+layout (std140) uniform FrameData
+{
+    mat4 camMatrix; // Combined view * projection matrix
+    vec3 camPos;    // Camera position in world space
+};
+
+uniform mat4 model; // Model matrix for this object
+
+void main()
+{
+    // Calculate the vertex position in world space
+    crntPos = vec3(model * vec4(getPosition(), 1.0f));
+    // Transform to clip space
+    gl_Position = camMatrix * vec4(crntPos, 1.0f);
+
+    // Pass data to the fragment shader
+    color = getColor();
+    texCoord = getTexCoord();
+
+    // Correct normal transformation
+    // Use mat3(transpose(inverse(model))) to transform normals.
+    // This is important if the model is scaled non-uniformly.
+    Normal = mat3(model) * getNormal();
 }
\ No newline at end of file
@@ -0,0 +1,99 @@
+#include "frameUniforms.h"
+#include "glStateCache.h"
+#include <cstring>
+#include <iostream>
+
+static_assert(sizeof(FrameDataBlock) == 80, "FrameDataBlock does not match the std140 layout of FrameData");
+static_assert(sizeof(PointLightBlock) == 32, "PointLightBlock does not match the std140 layout of PointLight");
+static_assert(sizeof(LightDataBlock) == LightDataBlock::maxPointLights * 32 + 16, "LightDataBlock does not match the std140 layout of LightData");
+
+static GLsizeiptr alignUp(GLsizeiptr value, GLsizeiptr alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+FrameUniforms::FrameUniforms(GLuint regionCount) : regionCount(regionCount > 0 ? regionCount : 1) {
+    // Offsets given to glBindBufferRange must be multiples of the implementation's alignment
+    GLint alignment = 0;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+    if (alignment < 1) alignment = 256;
+    lightOffset = alignUp(sizeof(FrameDataBlock), alignment);
+    regionSize = alignUp(lightOffset + sizeof(LightDataBlock), alignment);
+    fences.assign(this->regionCount, nullptr);
+
+    glGenBuffers(1, &buffer);
+    GLStateCache::bindBuffer(GL_UNIFORM_BUFFER, buffer);
+    glBufferData(GL_UNIFORM_BUFFER, regionSize * this->regionCount, nullptr, GL_STREAM_DRAW);
+    region = this->regionCount - 1; // The first update() writes region 0
+}
+
+bool FrameUniforms::getBlockLayout(const char* name, GLuint& binding, GLsizeiptr& size) {
+    if (std::strcmp(name, "FrameData") == 0) {
+        binding = frameDataBinding;
+        size = sizeof(FrameDataBlock);
+        return true;
+    }
+    if (std::strcmp(name, "LightData") == 0) {
+        binding = lightDataBinding;
+        size = sizeof(LightDataBlock);
+        return true;
+    }
+    return false;
+}
+
+void FrameUniforms::waitForRegion(GLuint index) {
+    GLsync& fence = fences[index];
+    if (!fence) return;
+    // Poll first: the fence is normally signalled long ago
+    GLenum result = glClientWaitSync(fence, 0, 0);
+    if (result == GL_TIMEOUT_EXPIRED) {
+        waitCount++;
+        do {
+            result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000); // 1 ms
+        } while (result == GL_TIMEOUT_EXPIRED);
+    }
+    if (result == GL_WAIT_FAILED) std::cerr << "Error: Waiting for a FrameUniforms fence failed." << std::endl;
+    glDeleteSync(fence);
+    fence = nullptr;
+}
+
+void FrameUniforms::update(const FrameDataBlock& frame, const LightDataBlock& lights) {
+    // A second update in one frame must not overwrite what the frame's earlier draws read
+    if (regionWritten) endFrame();
+    region = (region + 1) % regionCount;
+    waitForRegion(region);
+    GLintptr offset = region * regionSize;
+
+    GLStateCache::bindBuffer(GL_UNIFORM_BUFFER, buffer);
+    // Unsynchronized: the fence above already guarantees the GPU is not reading this region
+    void* destination = glMapBufferRange(GL_UNIFORM_BUFFER, offset, regionSize,
+        GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+    if (destination) {
+        std::memcpy(destination, &frame, sizeof(frame));
+        std::memcpy(static_cast<char*>(destination) + lightOffset, &lights, sizeof(lights));
+        if (glUnmapBuffer(GL_UNIFORM_BUFFER) != GL_TRUE) {
+            std::cerr << "Error: FrameUniforms buffer contents lost while mapped." << std::endl;
+        }
+    } else {
+        glBufferSubData(GL_UNIFORM_BUFFER, offset, sizeof(frame), &frame);
+        glBufferSubData(GL_UNIFORM_BUFFER, offset + lightOffset, sizeof(lights), &lights);
+    }
+
+    GLStateCache::bindBufferRange(GL_UNIFORM_BUFFER, frameDataBinding, buffer, offset, sizeof(FrameDataBlock));
+    GLStateCache::bindBufferRange(GL_UNIFORM_BUFFER, lightDataBinding, buffer, offset + lightOffset, sizeof(LightDataBlock));
+    regionWritten = true;
+}
+
+void FrameUniforms::endFrame() {
+    if (!regionWritten) return;
+    fences[region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    regionWritten = false;
+}
+
+void FrameUniforms::Delete() {
+    for (GLsync& fence : fences) {
+        if (fence) glDeleteSync(fence);
+        fence = nullptr;
+    }
+    if (buffer) GLStateCache::deleteBuffer(buffer);
+    buffer = 0;
+}
@@ -0,0 +1,74 @@
+#ifndef FRAME_UNIFORMS_H
+#define FRAME_UNIFORMS_H
+
+#include <vector>
+#include <cstddef>
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+// std140 mirrors of the uniform blocks in the shaders (the GLSL declarations must match member by member)
+
+// layout (std140) uniform FrameData: per-frame camera data
+struct FrameDataBlock {
+    glm::mat4 camMatrix = glm::mat4(1.0f); // Combined view * projection matrix
+    glm::vec3 camPos = glm::vec3(0.0f);
+    float padding0 = 0.0f;
+};
+
+// struct PointLight in default.frag (a vec3 takes 16 bytes in std140)
+struct PointLightBlock {
+    glm::vec3 position = glm::vec3(0.0f);
+    float padding0 = 0.0f;
+    glm::vec4 color = glm::vec4(0.0f);
+};
+
+// layout (std140) uniform LightData: the point lights
+struct LightDataBlock {
+    static const int maxPointLights = 4; // MAX_POINT_LIGHTS in default.frag
+    PointLightBlock pointLights[maxPointLights];
+    GLint numActiveLights = 0;
+    GLint padding0[3] = { 0, 0, 0 };
+};
+
+// Per-frame uniform data shared by all programs. The FrameData and LightData blocks are bound to fixed
+// binding points (every Shader binds its blocks there when it is linked), so the camera and lights are
+// uploaded once per frame however many programs and passes read them.
+//
+// The blocks live in one uniform buffer split into regionCount regions, used in turn. update() writes the
+// next region through an unsynchronized glMapBufferRange (no driver stall or buffer copy), and endFrame()
+// puts a fence after the frame's draws; a region is only rewritten once the GPU has passed its fence,
+// which with 3 regions it has in practice always done.
+class FrameUniforms {
+public:
+    static const GLuint frameDataBinding = 0;
+    static const GLuint lightDataBinding = 1;
+
+    explicit FrameUniforms(GLuint regionCount = 3);
+
+    // Writes this frame's blocks into the next region and binds them (before the frame's first draw)
+    void update(const FrameDataBlock& frame, const LightDataBlock& lights);
+    // Fences the region written by update() (after the frame's last draw)
+    void endFrame();
+    void Delete();
+
+    // Binding point and std140 size of a shared block; false if the name is not one of them
+    static bool getBlockLayout(const char* name, GLuint& binding, GLsizeiptr& size);
+
+    // update() calls that had to wait for the GPU to finish with their region
+    size_t getWaitCount() const { return waitCount; }
+
+private:
+    GLuint buffer = 0;
+    GLuint regionCount;
+    GLuint region = 0;          // Region written by the last update()
+    bool regionWritten = false; // Region not fenced yet
+    GLsizeiptr regionSize = 0;
+    GLsizeiptr lightOffset = 0; // Of LightData in a region (FrameData is at 0)
+    std::vector<GLsync> fences; // One per region, nullptr when not in flight
+    size_t waitCount = 0;
+
+    // Blocks until the GPU is done with the region's previous contents
+    void waitForRegion(GLuint index);
+};
+
+#endif // FRAME_UNIFORMS_H
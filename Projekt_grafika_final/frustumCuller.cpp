@@ -0,0 +1,157 @@
+#include "frustumCuller.h"
+#include <cmath>
+
+#if defined(__AVX__)
+#define FRUSTUM_CULLER_AVX
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FRUSTUM_CULLER_SSE2
+#include <emmintrin.h>
+#endif
+
+static const size_t laneGroup = 8; // Padding granularity (AVX width, two SSE2 iterations)
+
+Frustum Frustum::fromMatrix(const glm::mat4& m) {
+    // Rows of the (column-major) matrix
+    glm::vec4 row0(m[0][0], m[1][0], m[2][0], m[3][0]);
+    glm::vec4 row1(m[0][1], m[1][1], m[2][1], m[3][1]);
+    glm::vec4 row2(m[0][2], m[1][2], m[2][2], m[3][2]);
+    glm::vec4 row3(m[0][3], m[1][3], m[2][3], m[3][3]);
+
+    Frustum frustum;
+    frustum.planes[0] = row3 + row0; // Left
+    frustum.planes[1] = row3 - row0; // Right
+    frustum.planes[2] = row3 + row1; // Bottom
+    frustum.planes[3] = row3 - row1; // Top
+    frustum.planes[4] = row3 + row2; // Near
+    frustum.planes[5] = row3 - row2; // Far
+    for (glm::vec4& plane : frustum.planes) {
+        float length = glm::length(glm::vec3(plane));
+        if (length > 0.0f) plane /= length;
+    }
+    return frustum;
+}
+
+uint32_t FrustumCuller::add(const BoundingBox& box) {
+    if (count == centerX.size()) {
+        size_t padded = centerX.size() + laneGroup;
+        centerX.resize(padded, 0.0f); centerY.resize(padded, 0.0f); centerZ.resize(padded, 0.0f);
+        extentX.resize(padded, 0.0f); extentY.resize(padded, 0.0f); extentZ.resize(padded, 0.0f);
+    }
+    uint32_t index = (uint32_t)count++;
+    set(index, box);
+    return index;
+}
+
+void FrustumCuller::set(uint32_t index, const BoundingBox& box) {
+    glm::vec3 center(0.0f);
+    glm::vec3 extent(INFINITY); // Unknown extent: the plane test can never reject it
+    if (!box.isEmpty()) {
+        center = box.getCenter();
+        extent = box.getExtent();
+    }
+    centerX[index] = center.x; centerY[index] = center.y; centerZ[index] = center.z;
+    extentX[index] = extent.x; extentY[index] = extent.y; extentZ[index] = extent.z;
+}
+
+void FrustumCuller::clear() {
+    count = 0; // The arrays keep their capacity, stale padding lanes are masked out
+    visible.clear();
+}
+
+// A box is outside if, for any plane, its center lies further behind the plane than its
+// projected radius: dot(n, c) + d < -dot(|n|, e)
+const std::vector<uint32_t>& FrustumCuller::cullScalar(const Frustum& frustum) {
+    visible.clear();
+    for (size_t i = 0; i < count; ++i) {
+        bool inside = true;
+        for (const glm::vec4& plane : frustum.planes) {
+            float distance = plane.x * centerX[i] + plane.y * centerY[i] + plane.z * centerZ[i] + plane.w;
+            float radius = std::fabs(plane.x) * extentX[i] + std::fabs(plane.y) * extentY[i] + std::fabs(plane.z) * extentZ[i];
+            if (distance < -radius) {
+                inside = false;
+                break;
+            }
+        }
+        if (inside) visible.push_back((uint32_t)i);
+    }
+    return visible;
+}
+
+#if defined(FRUSTUM_CULLER_AVX)
+
+const std::vector<uint32_t>& FrustumCuller::cull(const Frustum& frustum) {
+    visible.clear();
+    __m256 nx[6], ny[6], nz[6], ax[6], ay[6], az[6], d[6];
+    for (int p = 0; p < 6; ++p) {
+        const glm::vec4& plane = frustum.planes[p];
+        nx[p] = _mm256_set1_ps(plane.x); ny[p] = _mm256_set1_ps(plane.y); nz[p] = _mm256_set1_ps(plane.z);
+        ax[p] = _mm256_set1_ps(std::fabs(plane.x)); ay[p] = _mm256_set1_ps(std::fabs(plane.y)); az[p] = _mm256_set1_ps(std::fabs(plane.z));
+        d[p] = _mm256_set1_ps(plane.w);
+    }
+
+    for (size_t i = 0; i < count; i += 8) {
+        __m256 cx = _mm256_loadu_ps(&centerX[i]), cy = _mm256_loadu_ps(&centerY[i]), cz = _mm256_loadu_ps(&centerZ[i]);
+        __m256 ex = _mm256_loadu_ps(&extentX[i]), ey = _mm256_loadu_ps(&extentY[i]), ez = _mm256_loadu_ps(&extentZ[i]);
+        __m256 outside = _mm256_setzero_ps();
+        for (int p = 0; p < 6; ++p) {
+            __m256 distance = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(nx[p], cx), _mm256_mul_ps(ny[p], cy)),
+                                            _mm256_add_ps(_mm256_mul_ps(nz[p], cz), d[p]));
+            __m256 radius = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(ax[p], ex), _mm256_mul_ps(ay[p], ey)), _mm256_mul_ps(az[p], ez));
+            // distance + radius < 0, i.e. completely behind this plane
+            outside = _mm256_or_ps(outside, _mm256_cmp_ps(_mm256_add_ps(distance, radius), _mm256_setzero_ps(), _CMP_LT_OQ));
+        }
+        int mask = ~_mm256_movemask_ps(outside) & 0xFF;
+        if (count - i < 8) mask &= (1 << (count - i)) - 1; // Padding lanes
+        for (int lane = 0; mask; ++lane, mask >>= 1) {
+            if (mask & 1) visible.push_back((uint32_t)(i + lane));
+        }
+    }
+    return visible;
+}
+
+const char* FrustumCuller::getSimdPath() { return "AVX"; }
+
+#elif defined(FRUSTUM_CULLER_SSE2)
+
+const std::vector<uint32_t>& FrustumCuller::cull(const Frustum& frustum) {
+    visible.clear();
+    __m128 nx[6], ny[6], nz[6], ax[6], ay[6], az[6], d[6];
+    for (int p = 0; p < 6; ++p) {
+        const glm::vec4& plane = frustum.planes[p];
+        nx[p] = _mm_set1_ps(plane.x); ny[p] = _mm_set1_ps(plane.y); nz[p] = _mm_set1_ps(plane.z);
+        ax[p] = _mm_set1_ps(std::fabs(plane.x)); ay[p] = _mm_set1_ps(std::fabs(plane.y)); az[p] = _mm_set1_ps(std::fabs(plane.z));
+        d[p] = _mm_set1_ps(plane.w);
+    }
+
+    for (size_t i = 0; i < count; i += 4) {
+        __m128 cx = _mm_loadu_ps(&centerX[i]), cy = _mm_loadu_ps(&centerY[i]), cz = _mm_loadu_ps(&centerZ[i]);
+        __m128 ex = _mm_loadu_ps(&extentX[i]), ey = _mm_loadu_ps(&extentY[i]), ez = _mm_loadu_ps(&extentZ[i]);
+        __m128 outside = _mm_setzero_ps();
+        for (int p = 0; p < 6; ++p) {
+            __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx[p], cx), _mm_mul_ps(ny[p], cy)),
+                                         _mm_add_ps(_mm_mul_ps(nz[p], cz), d[p]));
+            __m128 radius = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ax[p], ex), _mm_mul_ps(ay[p], ey)), _mm_mul_ps(az[p], ez));
+            // distance + radius < 0, i.e. completely behind this plane
+            outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(distance, radius), _mm_setzero_ps()));
+        }
+        int mask = ~_mm_movemask_ps(outside) & 0xF;
+        if (count - i < 4) mask &= (1 << (count - i)) - 1; // Padding lanes
+        for (int lane = 0; mask; ++lane, mask >>= 1) {
+            if (mask & 1) visible.push_back((uint32_t)(i + lane));
+        }
+    }
+    return visible;
+}
+
+const char* FrustumCuller::getSimdPath() { return "SSE2"; }
+
+#else
+
+const std::vector<uint32_t>& FrustumCuller::cull(const Frustum& frustum) {
+    return cullScalar(frustum);
+}
+
+const char* FrustumCuller::getSimdPath() { return "scalar"; }
+
+#endif
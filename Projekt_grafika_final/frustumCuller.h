@@ -0,0 +1,50 @@
+#ifndef FRUSTUM_CULLER_H
+#define FRUSTUM_CULLER_H
+
+#include <vector>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include "bounds.h"
+
+// The 6 planes of a view frustum (left, right, bottom, top, near, far) as (normal, distance)
+// with normals pointing inside: a point p is inside a plane if dot(normal, p) + distance >= 0.
+struct Frustum {
+    glm::vec4 planes[6];
+
+    // Gribb-Hartmann extraction from projection * view (Camera::cameraMatrix), planes normalized
+    static Frustum fromMatrix(const glm::mat4& viewProjection);
+};
+
+// Tests many world-space AABBs against a frustum at once. The boxes are stored as structure of arrays
+// (center x/y/z, half extent x/y/z), so 8 boxes (AVX) or 4 boxes (SSE2) are tested per iteration
+// with one multiply-add chain per plane. The result is a compact list of the visible box indices.
+// Compiled for AVX when the compiler targets it (/arch:AVX, -mavx), otherwise SSE2, with a scalar fallback.
+class FrustumCuller {
+public:
+    // Adds a box and returns its index. Empty boxes (unknown bounds) are never culled.
+    uint32_t add(const BoundingBox& box);
+    // Replaces the box at index (for objects that moved)
+    void set(uint32_t index, const BoundingBox& box);
+    void clear();
+    size_t size() const { return count; }
+
+    // Indices of the boxes intersecting or inside the frustum, in ascending order.
+    // The returned list stays valid until the next cull() / cullScalar().
+    const std::vector<uint32_t>& cull(const Frustum& frustum);
+    // Same one box at a time (reference and fallback)
+    const std::vector<uint32_t>& cullScalar(const Frustum& frustum);
+
+    const std::vector<uint32_t>& getVisible() const { return visible; }
+
+    // Name of the compiled kernel ("AVX", "SSE2" or "scalar")
+    static const char* getSimdPath();
+
+private:
+    // Padded to a multiple of 8 entries, the padding lanes are masked out of the result
+    std::vector<float> centerX, centerY, centerZ;
+    std::vector<float> extentX, extentY, extentZ;
+    size_t count = 0;
+    std::vector<uint32_t> visible;
+};
+
+#endif // FRUSTUM_CULLER_H
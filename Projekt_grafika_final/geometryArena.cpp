@@ -0,0 +1,243 @@
+#include "geometryArena.h"
+#include "mesh.h"
+#include <algorithm>
+#include <iostream>
+
+// --- FreeListAllocator ---
+
+FreeListAllocator::FreeListAllocator(size_t capacity) : capacity(capacity) {
+    if (capacity > 0) freeBlocks.push_back({ 0, capacity });
+}
+
+bool FreeListAllocator::allocate(size_t size, size_t& offset) {
+    for (size_t i = 0; i < freeBlocks.size(); ++i) {
+        Block& block = freeBlocks[i];
+        if (block.size < size) continue;
+
+        offset = block.offset;
+        block.offset += size;
+        block.size -= size;
+        if (block.size == 0) freeBlocks.erase(freeBlocks.begin() + i);
+        return true;
+    }
+    return false;
+}
+
+void FreeListAllocator::release(size_t offset, size_t size) {
+    if (size == 0) return;
+
+    // Insert keeping the list sorted by offset
+    auto it = std::lower_bound(freeBlocks.begin(), freeBlocks.end(), offset,
+        [](const Block& block, size_t value) { return block.offset < value; });
+    it = freeBlocks.insert(it, { offset, size });
+
+    // Merge with the following block
+    auto next = it + 1;
+    if (next != freeBlocks.end() && it->offset + it->size == next->offset) {
+        it->size += next->size;
+        freeBlocks.erase(next);
+    }
+    // Merge with the preceding block
+    if (it != freeBlocks.begin()) {
+        auto prev = it - 1;
+        if (prev->offset + prev->size == it->offset) {
+            prev->size += it->size;
+            freeBlocks.erase(it);
+        }
+    }
+}
+
+void FreeListAllocator::grow(size_t newCapacity) {
+    if (newCapacity <= capacity) return;
+    size_t oldCapacity = capacity;
+    capacity = newCapacity;
+    release(oldCapacity, newCapacity - oldCapacity);
+}
+
+void FreeListAllocator::reset(size_t usedSize, size_t newCapacity) {
+    capacity = newCapacity;
+    freeBlocks.clear();
+    if (usedSize < capacity) freeBlocks.push_back({ usedSize, capacity - usedSize });
+}
+
+size_t FreeListAllocator::getFreeSize() const {
+    size_t total = 0;
+    for (const Block& block : freeBlocks) total += block.size;
+    return total;
+}
+
+bool FreeListAllocator::isCompact() const {
+    if (freeBlocks.empty()) return true;
+    const Block& block = freeBlocks.front();
+    return freeBlocks.size() == 1 && block.offset + block.size == capacity;
+}
+
+// --- GeometryArena ---
+
+GeometryArena::GeometryArena(size_t vertexCapacity, size_t indexCapacityBytes, VertexFormat format)
+    : format(format), stride(getVertexStride(format)), vertexAllocator(vertexCapacity), indexAllocator(indexCapacityBytes) {
+    vao.Unbind(); // See reallocate()
+    vbo_ptr = std::make_unique<VBO>(nullptr, vertexCapacity * stride);
+    ebo_ptr = std::make_unique<EBO>(nullptr, indexCapacityBytes);
+    linkAttributes(vao);
+}
+
+void GeometryArena::linkAttributes(VAO& target) {
+    // Same layout as every other Mesh
+    Mesh::linkLayout(target, *vbo_ptr, *ebo_ptr, format);
+}
+
+ArenaRange* GeometryArena::allocate(const void* vertexData, size_t vertexCount, const void* indexData, size_t indexBytes) {
+    ArenaRange* range = reserve(vertexCount, indexBytes);
+
+    vbo_ptr->Bind();
+    glBufferSubData(GL_ARRAY_BUFFER, range->baseVertex * stride, vertexCount * stride, vertexData);
+    vbo_ptr->Unbind();
+    // Bind the element buffer through the VAO, it is not allowed to change the VAO's EBO binding otherwise
+    vao.Bind();
+    glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, range->indexOffset, indexBytes, indexData);
+    vao.Unbind();
+    return range;
+}
+
+ArenaRange* GeometryArena::reserve(size_t vertexCount, size_t indexBytes) {
+    // Rounded up to 4 bytes, so every range starts at an offset valid for 32-bit indices as well
+    size_t indexSize = (indexBytes + 3) & ~(size_t)3;
+    size_t vertexOffset = 0, indexOffset = 0;
+
+    // Grow (doubling) until both allocations fit
+    while (true) {
+        bool vertexFits = vertexAllocator.allocate(vertexCount, vertexOffset);
+        bool indexFits = indexAllocator.allocate(indexSize, indexOffset);
+        if (vertexFits && indexFits) break;
+
+        if (vertexFits) vertexAllocator.release(vertexOffset, vertexCount);
+        if (indexFits) indexAllocator.release(indexOffset, indexSize);
+
+        size_t newVertexCapacity = vertexAllocator.getCapacity();
+        size_t newIndexCapacity = indexAllocator.getCapacity();
+        if (!vertexFits) newVertexCapacity = std::max(newVertexCapacity * 2, newVertexCapacity + vertexCount);
+        if (!indexFits) newIndexCapacity = std::max(newIndexCapacity * 2, newIndexCapacity + indexSize);
+        reallocate(newVertexCapacity, newIndexCapacity, false);
+    }
+
+    auto range = std::make_unique<ArenaRange>();
+    range->baseVertex = static_cast<GLint>(vertexOffset);
+    range->vertexCount = static_cast<GLsizei>(vertexCount);
+    range->indexOffset = static_cast<GLsizeiptr>(indexOffset);
+    range->indexBytes = static_cast<GLsizeiptr>(indexSize);
+    ranges.push_back(std::move(range));
+    return ranges.back().get();
+}
+
+void GeometryArena::mapRange(ArenaRange* range, void*& vertices, void*& indices) {
+    // Only the range is invalidated, the rest of the buffers may still be in use by the GPU
+    const GLbitfield access = GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT;
+    vbo_ptr->Bind();
+    vertices = glMapBufferRange(GL_ARRAY_BUFFER, range->baseVertex * stride, range->vertexCount * stride, access);
+    // The copy-write target leaves the VAO's element buffer binding alone
+    GLStateCache::bindBuffer(GL_COPY_WRITE_BUFFER, ebo_ptr->ID);
+    indices = glMapBufferRange(GL_COPY_WRITE_BUFFER, range->indexOffset, range->indexBytes, access);
+}
+
+void GeometryArena::unmapRange() {
+    bool vertexUnmapped = glUnmapBuffer(GL_ARRAY_BUFFER) == GL_TRUE;
+    bool indexUnmapped = glUnmapBuffer(GL_COPY_WRITE_BUFFER) == GL_TRUE;
+    if (!vertexUnmapped || !indexUnmapped) {
+        std::cerr << "Error: GeometryArena buffer contents lost while mapped." << std::endl;
+    }
+    vbo_ptr->Unbind();
+    GLStateCache::bindBuffer(GL_COPY_WRITE_BUFFER, 0);
+}
+
+void GeometryArena::release(ArenaRange* range) {
+    auto it = std::find_if(ranges.begin(), ranges.end(),
+        [range](const std::unique_ptr<ArenaRange>& r) { return r.get() == range; });
+    if (it == ranges.end()) {
+        std::cerr << "Error: Trying to release a range that does not belong to this GeometryArena." << std::endl;
+        return;
+    }
+    vertexAllocator.release(range->baseVertex, range->vertexCount);
+    indexAllocator.release(range->indexOffset, range->indexBytes);
+    ranges.erase(it);
+}
+
+void GeometryArena::defragment() {
+    // Nothing to do if the free space is already one block at the end of each buffer
+    if (isCompact()) return;
+    reallocate(vertexAllocator.getCapacity(), indexAllocator.getCapacity(), true);
+}
+
+void GeometryArena::reallocate(size_t newVertexCapacity, size_t newIndexCapacity, bool compact) {
+    // Creating an EBO binds it to GL_ELEMENT_ARRAY_BUFFER, which must not hit whatever VAO is bound
+    vao.Unbind();
+    auto newVbo = std::make_unique<VBO>(nullptr, newVertexCapacity * stride);
+    auto newEbo = std::make_unique<EBO>(nullptr, newIndexCapacity);
+
+    // Copy buffer-to-buffer on the GPU, no round trip through system memory
+    if (compact) {
+        // Pack live ranges in their current order
+        std::vector<ArenaRange*> sorted;
+        for (auto& range : ranges) sorted.push_back(range.get());
+        std::sort(sorted.begin(), sorted.end(),
+            [](const ArenaRange* a, const ArenaRange* b) { return a->baseVertex < b->baseVertex; });
+
+        size_t vertexEnd = 0;
+        GLStateCache::bindBuffer(GL_COPY_READ_BUFFER, vbo_ptr->ID);
+        GLStateCache::bindBuffer(GL_COPY_WRITE_BUFFER, newVbo->ID);
+        for (ArenaRange* range : sorted) {
+            glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER,
+                range->baseVertex * stride, vertexEnd * stride, range->vertexCount * stride);
+            range->baseVertex = static_cast<GLint>(vertexEnd);
+            vertexEnd += range->vertexCount;
+        }
+
+        std::sort(sorted.begin(), sorted.end(),
+            [](const ArenaRange* a, const ArenaRange* b) { return a->indexOffset < b->indexOffset; });
+
+        size_t indexEnd = 0;
+        GLStateCache::bindBuffer(GL_COPY_READ_BUFFER, ebo_ptr->ID);
+        GLStateCache::bindBuffer(GL_COPY_WRITE_BUFFER, newEbo->ID);
+        for (ArenaRange* range : sorted) {
+            glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER,
+                range->indexOffset, indexEnd, range->indexBytes);
+            range->indexOffset = static_cast<GLsizeiptr>(indexEnd);
+            indexEnd += range->indexBytes;
+        }
+
+        vertexAllocator.reset(vertexEnd, newVertexCapacity);
+        indexAllocator.reset(indexEnd, newIndexCapacity);
+    } else {
+        // Plain growth: same offsets, copy everything
+        GLStateCache::bindBuffer(GL_COPY_READ_BUFFER, vbo_ptr->ID);
+        GLStateCache::bindBuffer(GL_COPY_WRITE_BUFFER, newVbo->ID);
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, vertexAllocator.getCapacity() * stride);
+        GLStateCache::bindBuffer(GL_COPY_READ_BUFFER, ebo_ptr->ID);
+        GLStateCache::bindBuffer(GL_COPY_WRITE_BUFFER, newEbo->ID);
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, indexAllocator.getCapacity());
+
+        vertexAllocator.grow(newVertexCapacity);
+        indexAllocator.grow(newIndexCapacity);
+    }
+    GLStateCache::bindBuffer(GL_COPY_READ_BUFFER, 0);
+    GLStateCache::bindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+    vbo_ptr->Delete();
+    ebo_ptr->Delete();
+    vbo_ptr = std::move(newVbo);
+    ebo_ptr = std::move(newEbo);
+    linkAttributes(vao);
+    bufferVersion++;
+}
+
+void GeometryArena::Bind() {
+    vao.Bind();
+}
+
+void GeometryArena::Delete() {
+    if (vbo_ptr) vbo_ptr->Delete();
+    if (ebo_ptr) ebo_ptr->Delete();
+    vao.Delete();
+    vbo_ptr.reset();
+    ebo_ptr.reset();
+}
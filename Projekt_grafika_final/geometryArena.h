@@ -0,0 +1,111 @@
+#ifndef GEOMETRY_ARENA_H
+#define GEOMETRY_ARENA_H
+
+#include <vector>
+#include <memory>
+#include <glad/glad.h>
+#include "VAO.h"
+#include "VBO.h"
+#include "EBO.h"
+#include "vertexFormat.h"
+
+// Sub-allocation of one mesh inside the arena buffers.
+// Indices are stored relative to the mesh (0..vertexCount-1) and drawn with baseVertex,
+// so a range can be moved around (defragment) without rewriting its indices.
+// The index space is managed in bytes, so 16-bit and 32-bit meshes share one element buffer.
+struct ArenaRange {
+    GLint baseVertex = 0;    // Offset of the first vertex, in vertices
+    GLsizei vertexCount = 0;
+    GLsizeiptr indexOffset = 0; // Offset of the first index, in bytes (multiple of 4)
+    GLsizeiptr indexBytes = 0;  // Allocated index space, in bytes (multiple of 4)
+};
+
+// First-fit free-list allocator working on abstract units (vertices or index bytes).
+// Neighbouring free blocks are merged on release.
+class FreeListAllocator {
+public:
+    explicit FreeListAllocator(size_t capacity = 0);
+
+    // Finds a free block of 'size' units. Returns false if no block is large enough.
+    bool allocate(size_t size, size_t& offset);
+    // Returns a block to the free list
+    void release(size_t offset, size_t size);
+    // Extends the managed space (new space is appended as free)
+    void grow(size_t newCapacity);
+    // Resets to a single used block [0, usedSize) followed by free space (after compaction)
+    void reset(size_t usedSize, size_t newCapacity);
+
+    size_t getCapacity() const { return capacity; }
+    size_t getFreeSize() const;
+    size_t getFreeBlockCount() const { return freeBlocks.size(); }
+    // True if all free space is one block at the end (nothing to gain from compaction)
+    bool isCompact() const;
+
+private:
+    struct Block {
+        size_t offset;
+        size_t size;
+    };
+    std::vector<Block> freeBlocks; // Sorted by offset
+    size_t capacity;
+};
+
+// One big vertex buffer + one big index buffer shared by many meshes.
+// All meshes in the arena use one vertex format (float or packed, see vertexFormat.h),
+// so every mesh in the arena is drawn through the same VAO with glDrawElementsBaseVertex.
+class GeometryArena {
+public:
+    // Capacities (in vertices and in index bytes) are initial sizes, the buffers grow when they run out of space
+    GeometryArena(size_t vertexCapacity, size_t indexCapacityBytes, VertexFormat format = VertexFormat::Float);
+
+    // Copies the geometry into the arena. vertexData holds vertexCount vertices in the arena's format,
+    // indexData holds indexBytes bytes of 16-bit or 32-bit indices.
+    // The returned range stays valid until release(), its offsets are updated in place by defragment() and by buffer growth.
+    ArenaRange* allocate(const void* vertexData, size_t vertexCount, const void* indexData, size_t indexBytes);
+    // Same as allocate() without uploading anything, the caller fills the range through mapRange()
+    ArenaRange* reserve(size_t vertexCount, size_t indexBytes);
+    // Maps the vertex and index space of a range for writing (one range at a time, until unmapRange())
+    void mapRange(ArenaRange* range, void*& vertices, void*& indices);
+    void unmapRange();
+    // Frees the space of a range (CPU-side bookkeeping only, no GL calls)
+    void release(ArenaRange* range);
+
+    // Moves all live ranges to the front of new buffers, removing the holes left by released meshes
+    void defragment();
+
+    // Binds the shared VAO (vertex layout + both buffers)
+    void Bind();
+    GLuint getVertexArrayID() const { return vao.ID; }
+    // Links the arena buffers into another VAO (used for instanced drawing)
+    void linkAttributes(VAO& target);
+    // Incremented every time the buffers are replaced (growth / defragment)
+    unsigned int getBufferVersion() const { return bufferVersion; }
+    // Deletes the GL buffers and the VAO. All meshes using the arena must be released first.
+    void Delete();
+
+    VertexFormat getFormat() const { return format; }
+    size_t getRangeCount() const { return ranges.size(); }
+    size_t getVertexCapacity() const { return vertexAllocator.getCapacity(); }
+    size_t getIndexCapacityBytes() const { return indexAllocator.getCapacity(); }
+    size_t getVertexFreeBlockCount() const { return vertexAllocator.getFreeBlockCount(); }
+    size_t getIndexFreeBlockCount() const { return indexAllocator.getFreeBlockCount(); }
+    // True if defragment() has nothing to do
+    bool isCompact() const { return vertexAllocator.isCompact() && indexAllocator.isCompact(); }
+
+private:
+    VertexFormat format;
+    GLsizei stride; // Bytes per vertex in the arena's format
+    VAO vao;
+    std::unique_ptr<VBO> vbo_ptr;
+    std::unique_ptr<EBO> ebo_ptr;
+    FreeListAllocator vertexAllocator;
+    FreeListAllocator indexAllocator; // In bytes
+    std::vector<std::unique_ptr<ArenaRange>> ranges;
+    unsigned int bufferVersion = 0;
+
+    // Creates new buffers with the given capacities and copies the live data over.
+    // With compact = true the ranges are packed tightly and their offsets updated.
+    void reallocate(size_t newVertexCapacity, size_t newIndexCapacity, bool compact);
+};
+
+#endif // GEOMETRY_ARENA_H
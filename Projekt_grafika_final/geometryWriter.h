@@ -0,0 +1,83 @@
+#ifndef GEOMETRY_WRITER_H
+#define GEOMETRY_WRITER_H
+
+#include <cstddef>
+#include <cmath>
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include "bounds.h"
+
+// Destination for generated geometry: a fixed-size vertex array (11 floats per vertex:
+// position, color, texture coordinates, normal) and a fixed-size index array (16 or 32 bit).
+// The memory belongs to the caller, e.g. a pre-sized std::vector, a GeometryArena slice or a
+// glMapBufferRange pointer. The writer never allocates; writes past the capacity are dropped
+// and reported through hasOverflowed().
+// The bounds of the written positions are accumulated on the way, so no extra pass is needed for them.
+class GeometryWriter {
+public:
+    GeometryWriter(GLfloat* vertices, size_t vertexCapacity, GLuint* indices, size_t indexCapacity)
+        : vertices(vertices), indices32(indices), indices16(nullptr),
+          vertexCapacity(vertexCapacity), indexCapacity(indexCapacity) {}
+    GeometryWriter(GLfloat* vertices, size_t vertexCapacity, GLushort* indices, size_t indexCapacity)
+        : vertices(vertices), indices32(nullptr), indices16(indices),
+          vertexCapacity(vertexCapacity), indexCapacity(indexCapacity) {}
+
+    // Writes one complete vertex
+    void addVertex(const glm::vec3& pos, const glm::vec3& col, const glm::vec2& tex, const glm::vec3& norm) {
+        if (vertexCount == vertexCapacity) {
+            overflow = true;
+            return;
+        }
+        GLfloat* v = vertices + vertexCount * 11;
+        v[0] = pos.x; v[1] = pos.y; v[2] = pos.z;
+        v[3] = col.x; v[4] = col.y; v[5] = col.z;
+        v[6] = tex.x; v[7] = tex.y;
+        v[8] = norm.x; v[9] = norm.y; v[10] = norm.z;
+        vertexCount++;
+
+        box.expand(pos);
+        float distanceSq = glm::dot(pos, pos);
+        if (distanceSq > maxDistanceSq) maxDistanceSq = distanceSq;
+    }
+
+    // Writes the three indices of one triangle (counter-clockwise = front face)
+    void addTriangle(GLuint a, GLuint b, GLuint c) {
+        if (indexCount + 3 > indexCapacity) {
+            overflow = true;
+            return;
+        }
+        if (indices16) {
+            indices16[indexCount] = (GLushort)a;
+            indices16[indexCount + 1] = (GLushort)b;
+            indices16[indexCount + 2] = (GLushort)c;
+        } else {
+            indices32[indexCount] = a;
+            indices32[indexCount + 1] = b;
+            indices32[indexCount + 2] = c;
+        }
+        indexCount += 3;
+    }
+
+    // Number of vertices written so far (= index of the next vertex)
+    size_t getVertexCount() const { return vertexCount; }
+    size_t getIndexCount() const { return indexCount; }
+    // True once the whole destination has been filled
+    bool isComplete() const { return vertexCount == vertexCapacity && indexCount == indexCapacity; }
+    bool hasOverflowed() const { return overflow; }
+    // Box and sphere around all vertices written so far (in the shape's local space)
+    Bounds getBounds() const { return Bounds::fromBox(box, std::sqrt(maxDistanceSq)); }
+
+private:
+    GLfloat* vertices;
+    GLuint* indices32;
+    GLushort* indices16;
+    size_t vertexCapacity;
+    size_t indexCapacity;
+    size_t vertexCount = 0;
+    size_t indexCount = 0;
+    bool overflow = false;
+    BoundingBox box;
+    float maxDistanceSq = 0.0f; // Farthest vertex from the local origin, squared
+};
+
+#endif // GEOMETRY_WRITER_H
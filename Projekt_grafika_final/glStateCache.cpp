@@ -0,0 +1,162 @@
+#include "glStateCache.h"
+
+GLuint GLStateCache::program = GLStateCache::unknownName;
+GLuint GLStateCache::vertexArray = GLStateCache::unknownName;
+GLuint GLStateCache::buffers[GLStateCache::BufferTargetCount] = { unknownName, unknownName, unknownName, unknownName, unknownName };
+GLenum GLStateCache::activeUnit = GLStateCache::unknownEnum;
+GLuint GLStateCache::textures[GLStateCache::maxTextureUnits] = {
+    unknownName, unknownName, unknownName, unknownName, unknownName, unknownName, unknownName, unknownName,
+    unknownName, unknownName, unknownName, unknownName, unknownName, unknownName, unknownName, unknownName };
+signed char GLStateCache::capabilities[GLStateCache::CapabilityCount] = { -1, -1, -1 };
+GLenum GLStateCache::cullFace = GLStateCache::unknownEnum;
+GLenum GLStateCache::depthFunc = GLStateCache::unknownEnum;
+signed char GLStateCache::depthMask = -1;
+signed char GLStateCache::colorMask = -1;
+size_t GLStateCache::issuedCount = 0;
+size_t GLStateCache::filteredCount = 0;
+
+int GLStateCache::getBufferIndex(GLenum target) {
+    switch (target) {
+    case GL_ARRAY_BUFFER: return ArrayBuffer;
+    case GL_ELEMENT_ARRAY_BUFFER: return ElementBuffer;
+    case GL_COPY_READ_BUFFER: return CopyReadBuffer;
+    case GL_COPY_WRITE_BUFFER: return CopyWriteBuffer;
+    case GL_UNIFORM_BUFFER: return UniformBuffer;
+    default: return -1;
+    }
+}
+
+int GLStateCache::getCapabilityIndex(GLenum capability) {
+    switch (capability) {
+    case GL_CULL_FACE: return CullFace;
+    case GL_DEPTH_TEST: return DepthTest;
+    case GL_BLEND: return Blend;
+    default: return -1;
+    }
+}
+
+void GLStateCache::useProgram(GLuint id) {
+    if (change(program, id)) glUseProgram(id);
+}
+
+void GLStateCache::bindVertexArray(GLuint id) {
+    if (!change(vertexArray, id)) return;
+    glBindVertexArray(id);
+    // Each vertex array has its own element buffer binding
+    buffers[ElementBuffer] = unknownName;
+}
+
+void GLStateCache::bindBuffer(GLenum target, GLuint buffer) {
+    int index = getBufferIndex(target);
+    if (index < 0) {
+        issuedCount++;
+        glBindBuffer(target, buffer);
+        return;
+    }
+    if (change(buffers[index], buffer)) glBindBuffer(target, buffer);
+}
+
+void GLStateCache::bindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size) {
+    issuedCount++;
+    glBindBufferRange(target, index, buffer, offset, size);
+    int bufferIndex = getBufferIndex(target);
+    if (bufferIndex >= 0) buffers[bufferIndex] = buffer;
+}
+
+void GLStateCache::activeTexture(GLenum unit) {
+    if (change(activeUnit, unit)) glActiveTexture(unit);
+}
+
+void GLStateCache::bindTexture(GLenum target, GLuint texture) {
+    GLuint unitIndex = activeUnit - GL_TEXTURE0;
+    if (target != GL_TEXTURE_2D || activeUnit == unknownEnum || unitIndex >= maxTextureUnits) {
+        issuedCount++;
+        glBindTexture(target, texture);
+        return;
+    }
+    if (change(textures[unitIndex], texture)) glBindTexture(target, texture);
+}
+
+void GLStateCache::bindTexture(GLenum unit, GLenum target, GLuint texture) {
+    GLuint unitIndex = unit - GL_TEXTURE0;
+    if (target == GL_TEXTURE_2D && unitIndex < maxTextureUnits && textures[unitIndex] == texture) {
+        filteredCount++;
+        return;
+    }
+    activeTexture(unit);
+    bindTexture(target, texture);
+}
+
+void GLStateCache::setEnabled(GLenum capability, bool enabled) {
+    int index = getCapabilityIndex(capability);
+    if (index >= 0 && !change(capabilities[index], static_cast<signed char>(enabled ? 1 : 0))) return;
+    if (index < 0) issuedCount++;
+    if (enabled) glEnable(capability);
+    else glDisable(capability);
+}
+
+bool GLStateCache::isEnabled(GLenum capability) {
+    int index = getCapabilityIndex(capability);
+    if (index >= 0 && capabilities[index] >= 0) return capabilities[index] != 0;
+    bool enabled = glIsEnabled(capability) != GL_FALSE;
+    if (index >= 0) capabilities[index] = enabled ? 1 : 0;
+    return enabled;
+}
+
+void GLStateCache::setCullFace(GLenum face) {
+    if (change(cullFace, face)) glCullFace(face);
+}
+
+void GLStateCache::setDepthFunc(GLenum func) {
+    if (change(depthFunc, func)) glDepthFunc(func);
+}
+
+void GLStateCache::setDepthMask(bool write) {
+    if (change(depthMask, static_cast<signed char>(write ? 1 : 0))) glDepthMask(write ? GL_TRUE : GL_FALSE);
+}
+
+void GLStateCache::setColorMask(bool write) {
+    GLboolean mask = write ? GL_TRUE : GL_FALSE;
+    if (change(colorMask, static_cast<signed char>(write ? 1 : 0))) glColorMask(mask, mask, mask, mask);
+}
+
+void GLStateCache::deleteProgram(GLuint id) {
+    glDeleteProgram(id);
+    // A program in use is only flagged for deletion and stays current: whatever is bound next must go through
+    if (program == id) program = unknownName;
+}
+
+void GLStateCache::deleteVertexArray(GLuint id) {
+    glDeleteVertexArrays(1, &id);
+    if (vertexArray == id) {
+        vertexArray = 0;
+        buffers[ElementBuffer] = unknownName;
+    }
+}
+
+void GLStateCache::deleteBuffer(GLuint id) {
+    glDeleteBuffers(1, &id);
+    for (GLuint& buffer : buffers) {
+        if (buffer == id) buffer = 0;
+    }
+}
+
+void GLStateCache::deleteTexture(GLuint id) {
+    glDeleteTextures(1, &id);
+    for (GLuint& texture : textures) {
+        if (texture == id) texture = 0;
+    }
+}
+
+void GLStateCache::invalidate() {
+    program = unknownName;
+    vertexArray = unknownName;
+    for (GLuint& buffer : buffers) buffer = unknownName;
+    activeUnit = unknownEnum;
+    for (GLuint& texture : textures) texture = unknownName;
+    for (signed char& capability : capabilities) capability = -1;
+    cullFace = unknownEnum;
+    depthFunc = unknownEnum;
+    depthMask = -1;
+    colorMask = -1;
+}
@@ -0,0 +1,91 @@
+#ifndef GL_STATE_CACHE_H
+#define GL_STATE_CACHE_H
+
+#include <cstddef>
+#include <glad/glad.h>
+
+// Shadow copy of the OpenGL binding and fixed-function state the renderer changes. Every bind made by
+// VAO, VBO, EBO, Texture and Shader goes through here, and a call that would set what is already set
+// never reaches the driver. Draw code can therefore bind what it needs without unbinding afterwards:
+// consecutive draws sharing a program, texture or vertex array cost no GL calls for them.
+//
+// Tracked: the program, the vertex array, the array / element / copy / uniform buffer targets, the
+// GL_TEXTURE_2D binding of the first maxTextureUnits units and the active unit, GL_CULL_FACE,
+// GL_DEPTH_TEST and GL_BLEND, the cull face, the depth function and the depth and colour masks.
+// Everything starts unknown, so the first call for each always goes through. The element buffer
+// binding is vertex array state: it becomes unknown whenever another vertex array is bound.
+//
+// All of it assumes one GL context, and that nothing changes this state behind the cache's back
+// (call invalidate() after code that does). Deleted objects must go through the delete functions,
+// which revert their bindings to 0 the way GL does.
+class GLStateCache {
+public:
+    static const GLuint maxTextureUnits = 16;
+
+    static void useProgram(GLuint program);
+    static void bindVertexArray(GLuint vertexArray);
+    static void bindBuffer(GLenum target, GLuint buffer);
+    // Always issued (the indexed bindings are not tracked); also sets the target's generic binding, as GL does
+    static void bindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size);
+    // unit is GL_TEXTURE0 + i
+    static void activeTexture(GLenum unit);
+    // Binds on the active unit
+    static void bindTexture(GLenum target, GLuint texture);
+    // Binds on the given unit, switching the active unit only if that binding changes
+    static void bindTexture(GLenum unit, GLenum target, GLuint texture);
+
+    static void setEnabled(GLenum capability, bool enabled);
+    // From the shadow copy when known (no glIsEnabled round trip)
+    static bool isEnabled(GLenum capability);
+    static void setCullFace(GLenum face);
+    static void setDepthFunc(GLenum func);
+    static void setDepthMask(bool write);
+    // All four channels at once
+    static void setColorMask(bool write);
+
+    static void deleteProgram(GLuint program);
+    static void deleteVertexArray(GLuint vertexArray);
+    static void deleteBuffer(GLuint buffer);
+    static void deleteTexture(GLuint texture);
+
+    // Forgets everything (e.g. after a new context or foreign GL code)
+    static void invalidate();
+
+    // Calls passed on to GL and calls dropped as redundant since the last reset
+    static size_t getIssuedCount() { return issuedCount; }
+    static size_t getFilteredCount() { return filteredCount; }
+    static void resetCounters() { issuedCount = filteredCount = 0; }
+
+private:
+    static const GLuint unknownName = ~0u;
+    static const GLenum unknownEnum = ~0u;
+    enum BufferTarget { ArrayBuffer, ElementBuffer, CopyReadBuffer, CopyWriteBuffer, UniformBuffer, BufferTargetCount };
+    enum Capability { CullFace, DepthTest, Blend, CapabilityCount };
+
+    static GLuint program;
+    static GLuint vertexArray;
+    static GLuint buffers[BufferTargetCount];
+    static GLenum activeUnit;
+    static GLuint textures[maxTextureUnits];
+    static signed char capabilities[CapabilityCount]; // -1 unknown, 0 disabled, 1 enabled
+    static GLenum cullFace, depthFunc;
+    static signed char depthMask, colorMask;
+    static size_t issuedCount, filteredCount;
+
+    // Index into buffers / capabilities, -1 for the ones not tracked
+    static int getBufferIndex(GLenum target);
+    static int getCapabilityIndex(GLenum capability);
+    // Counts the call; true if it has to be issued (and stores the new value)
+    template <typename T>
+    static bool change(T& current, T value) {
+        if (current == value) {
+            filteredCount++;
+            return false;
+        }
+        current = value;
+        issuedCount++;
+        return true;
+    }
+};
+
+#endif // GL_STATE_CACHE_H
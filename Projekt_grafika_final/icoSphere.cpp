@@ -0,0 +1,151 @@
+#include "IcoSphere.h"
+#include <cmath>
+#include <cstdint>
+#include <algorithm>
+#include <unordered_map>
+#include <glm/gtc/constants.hpp>
+
+IcoSphere::IcoSphere(float r, unsigned int subdivisions, const glm::vec3& color, bool seamUVs)
+    : radius(r), subdivisions(subdivisions), sphereColor(color), seamUVs(seamUVs) {
+    Type = ShapeType::SHAPE_TYPE_SPHERE;
+}
+
+std::string IcoSphere::getMeshKey() const {
+    return makeMeshKey("IcoSphere", { radius, (float)subdivisions, sphereColor.r, sphereColor.g, sphereColor.b, seamUVs ? 1.0f : 0.0f });
+}
+
+size_t IcoSphere::getBaseVertexCount(unsigned int subdivisions) {
+    return 10 * ((size_t)1 << (2 * subdivisions)) + 2;
+}
+
+size_t IcoSphere::getTriangleCount(unsigned int subdivisions) {
+    return 20 * ((size_t)1 << (2 * subdivisions));
+}
+
+// Same mapping as Sphere: u runs against the angle around Z, v from the south (0) to the north pole (1)
+static glm::vec2 sphereTexCoord(const glm::vec3& d) {
+    float angle = atan2f(d.y, d.x);
+    if (angle < 0.0f) angle += 2.0f * glm::pi<float>();
+    float u = 1.0f - angle / (2.0f * glm::pi<float>());
+    float v = 0.5f + asinf(std::max(-1.0f, std::min(1.0f, d.z))) / glm::pi<float>();
+    return glm::vec2(u, v);
+}
+
+void IcoSphere::buildMesh() const {
+    // Icosahedron: 3 orthogonal golden rectangles, faces counter-clockwise seen from outside
+    const float t = (1.0f + sqrtf(5.0f)) / 2.0f;
+    const glm::vec3 baseVertices[12] = {
+        {-1, t, 0}, {1, t, 0}, {-1, -t, 0}, {1, -t, 0},
+        {0, -1, t}, {0, 1, t}, {0, -1, -t}, {0, 1, -t},
+        {t, 0, -1}, {t, 0, 1}, {-t, 0, -1}, {-t, 0, 1}
+    };
+    const GLuint baseFaces[60] = {
+        0, 11, 5,  0, 5, 1,  0, 1, 7,  0, 7, 10,  0, 10, 11,
+        1, 5, 9,  5, 11, 4,  11, 10, 2,  10, 7, 6,  7, 1, 8,
+        3, 9, 4,  3, 4, 2,  3, 2, 6,  3, 6, 8,  3, 8, 9,
+        4, 9, 5,  2, 4, 11,  6, 2, 10,  8, 6, 7,  9, 8, 1
+    };
+
+    directions.clear();
+    directions.reserve(getBaseVertexCount(subdivisions));
+    for (const glm::vec3& v : baseVertices) directions.push_back(glm::normalize(v));
+    triangles.assign(baseFaces, baseFaces + 60);
+
+    // Subdivision: every edge gets one midpoint, shared by the two triangles on either side of it
+    std::unordered_map<uint64_t, GLuint> midpoints;
+    std::vector<GLuint> next;
+    for (unsigned int level = 0; level < subdivisions; ++level) {
+        midpoints.clear();
+        midpoints.reserve(triangles.size()); // Edges = 3/2 * triangles = indices / 2
+        next.clear();
+        next.reserve(triangles.size() * 4);
+
+        auto midpoint = [&](GLuint a, GLuint b) {
+            uint64_t key = a < b ? ((uint64_t)a << 32) | b : ((uint64_t)b << 32) | a;
+            auto it = midpoints.find(key);
+            if (it != midpoints.end()) return it->second;
+            GLuint index = (GLuint)directions.size();
+            directions.push_back(glm::normalize(directions[a] + directions[b]));
+            midpoints.emplace(key, index);
+            return index;
+        };
+
+        for (size_t i = 0; i < triangles.size(); i += 3) {
+            GLuint a = triangles[i], b = triangles[i + 1], c = triangles[i + 2];
+            GLuint ab = midpoint(a, b), bc = midpoint(b, c), ca = midpoint(c, a);
+            GLuint split[12] = { a, ab, ca,  b, bc, ab,  c, ca, bc,  ab, bc, ca };
+            next.insert(next.end(), split, split + 12);
+        }
+        triangles.swap(next);
+    }
+
+    texCoords.resize(directions.size());
+    for (size_t i = 0; i < directions.size(); ++i) texCoords[i] = sphereTexCoord(directions[i]);
+    if (!seamUVs) return;
+
+    // u is undefined at the poles (they are handled separately below)
+    auto isPole = [&](GLuint index) {
+        return std::fabs(directions[index].x) <= 1e-6f && std::fabs(directions[index].y) <= 1e-6f;
+    };
+
+    // Seam: a triangle whose u values span more than half the texture crosses u = 0/1. Its vertices
+    // on the low side get a copy with u + 1, so the texture is not squeezed backwards across the sphere.
+    std::unordered_map<GLuint, GLuint> seamCopies;
+    size_t baseCount = directions.size();
+    for (size_t i = 0; i < triangles.size(); i += 3) {
+        float uMin = 1.0f, uMax = 0.0f;
+        for (int k = 0; k < 3; ++k) {
+            if (isPole(triangles[i + k])) continue;
+            float u = texCoords[triangles[i + k]].x;
+            uMin = std::min(uMin, u);
+            uMax = std::max(uMax, u);
+        }
+        if (uMax - uMin <= 0.5f) continue;
+        for (int k = 0; k < 3; ++k) {
+            GLuint index = triangles[i + k];
+            if (index >= baseCount || texCoords[index].x >= 0.5f || isPole(index)) continue;
+            auto it = seamCopies.find(index);
+            if (it == seamCopies.end()) {
+                it = seamCopies.emplace(index, (GLuint)directions.size()).first;
+                directions.push_back(directions[index]);
+                texCoords.push_back(glm::vec2(texCoords[index].x + 1.0f, texCoords[index].y));
+            }
+            triangles[i + k] = it->second;
+        }
+    }
+
+    // Poles: u is undefined there, so each triangle gets its own pole vertex with the u of its other two corners
+    for (size_t i = 0; i < triangles.size(); i += 3) {
+        for (int k = 0; k < 3; ++k) {
+            GLuint index = triangles[i + k];
+            if (!isPole(index)) continue;
+            float u = 0.5f * (texCoords[triangles[i + (k + 1) % 3]].x + texCoords[triangles[i + (k + 2) % 3]].x);
+            triangles[i + k] = (GLuint)directions.size();
+            directions.push_back(directions[index]);
+            texCoords.push_back(glm::vec2(u, texCoords[index].y));
+        }
+    }
+}
+
+void IcoSphere::countGeometry(size_t& vertexCount, size_t& indexCount) const {
+    buildMesh();
+    vertexCount = directions.size();
+    indexCount = triangles.size();
+}
+
+void IcoSphere::writeGeometry(GeometryWriter& writer) const {
+    if (directions.empty()) buildMesh(); // countGeometry() was not called first
+
+    for (size_t i = 0; i < directions.size(); ++i) {
+        // On a unit sphere the normal is the direction itself
+        writer.addVertex(directions[i] * radius, sphereColor, texCoords[i], directions[i]);
+    }
+    for (size_t i = 0; i < triangles.size(); i += 3) {
+        writer.addTriangle(triangles[i], triangles[i + 1], triangles[i + 2]);
+    }
+
+    // The mesh now lives in the writer's destination
+    directions = std::vector<glm::vec3>();
+    texCoords = std::vector<glm::vec2>();
+    triangles = std::vector<GLuint>();
+}
@@ -0,0 +1,39 @@
+#ifndef ICOSPHERE_H
+#define ICOSPHERE_H
+
+#include "Shape.h"
+#include <vector>
+
+// Sphere built by recursively subdividing an icosahedron (every triangle split into 4, new vertices
+// pushed onto the sphere). Triangles are nearly uniform, so it reaches the silhouette error of a UV
+// Sphere with fewer vertices: no crowded poles and no duplicated seam column.
+// Uses the same axes and UV mapping as Sphere (poles on Z), so textures like world.png fit both.
+class IcoSphere : public Shape {
+private:
+    float radius;
+    unsigned int subdivisions; // 0 = icosahedron (12 vertices), each level quadruples the triangles
+    glm::vec3 sphereColor;
+    bool seamUVs; // Duplicate vertices along the texture seam and at the poles (needed for textured spheres)
+
+    // Unit directions, texture coordinates and triangles, built by countGeometry() and used by writeGeometry()
+    // (the vertex count is only known after subdivision and seam handling)
+    mutable std::vector<glm::vec3> directions;
+    mutable std::vector<glm::vec2> texCoords;
+    mutable std::vector<GLuint> triangles;
+
+    void buildMesh() const;
+
+protected:
+    void countGeometry(size_t& vertexCount, size_t& indexCount) const override;
+    void writeGeometry(GeometryWriter& writer) const override;
+    std::string getMeshKey() const override;
+
+public:
+    IcoSphere(float r, unsigned int subdivisions, const glm::vec3& color = glm::vec3(1.0f), bool seamUVs = true);
+
+    // Vertex and triangle counts before seam handling: 10 * 4^n + 2 and 20 * 4^n
+    static size_t getBaseVertexCount(unsigned int subdivisions);
+    static size_t getTriangleCount(unsigned int subdivisions);
+};
+
+#endif // ICOSPHERE_H
@@ -1,31 +1,31 @@
-	#ifndef INCLUDE_H
-	#define INCLUDE_H
-
-	#include <glad/glad.h>
-	#include <GLFW/glfw3.h>
-	#include <glm/glm.hpp>
-	#include <stb/stb_image.h>
-	#include <time.h>
-	#include <memory>   // For std::unique_ptr
-	#include <iostream> // For std::cout, std::endl
-	#include <vector>   // For std::vector
-
-	#endif // INCLUDE_H
-
-	#ifndef INCLUDE_H_NOT_DEFINED
-	#define INCLUDE_H_NOT_DEFINED
-
-	#include "shaderClass.h"
-	#include "texture.h"
-	#include "camera.h"
-	#include "VAO.h"
-	#include "VBO.h"
-	#include "EBO.h"
-	#include "shape.h"
-	#include "cube.h"
-	#include "pyramid.h"
-	#include "plane.h"
-	#include "sphere.h"
-	#include "cylinder.h"
-
+	#ifndef INCLUDE_H
+	#define INCLUDE_H
+
+	#include <glad/glad.h>
+	#include <GLFW/glfw3.h>
+	#include <glm/glm.hpp>
+	#include <stb/stb_image.h>
+	#include <time.h>
+	#include <memory>   // For std::unique_ptr
+	#include <iostream> // For std::cout, std::endl
+	#include <vector>   // For std::vector
+
+	#endif // INCLUDE_H
+
+	#ifndef INCLUDE_H_NOT_DEFINED
+	#define INCLUDE_H_NOT_DEFINED
+
+	#include "shaderClass.h"
+	#include "texture.h"
+	#include "camera.h"
+	#include "VAO.h"
+	#include "VBO.h"
+	#include "EBO.h"
+	#include "shape.h"
+	#include "cube.h"
+	#include "pyramid.h"
+	#include "plane.h"
+	#include "sphere.h"
+	#include "cylinder.h"
+
 	#endif // INCLUDE_H_NOT_DEFINED
\ No newline at end of file
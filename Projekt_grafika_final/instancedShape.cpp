@@ -0,0 +1,106 @@
+#include "instancedShape.h"
+#include <iostream>
+
+InstancedShape::InstancedShape(std::unique_ptr<Shape> prototype)
+    : prototype(std::move(prototype)) {
+}
+
+InstancedShape::~InstancedShape() {
+    cleanup();
+}
+
+size_t InstancedShape::addInstance(const glm::mat4& model) {
+    instanceMatrices.push_back(model);
+    instancesDirty = true;
+    return instanceMatrices.size() - 1;
+}
+
+void InstancedShape::setInstance(size_t index, const glm::mat4& model) {
+    instanceMatrices[index] = model;
+    instancesDirty = true;
+}
+
+void InstancedShape::clearInstances() {
+    instanceMatrices.clear();
+    instancesDirty = true;
+}
+
+void InstancedShape::setupMesh() {
+    prototype->setupMesh();
+    if (!prototype->getMesh()) {
+        std::cerr << "Error: Prototype mesh could not be created. Cannot setup InstancedShape." << std::endl;
+        return;
+    }
+
+    vao_ptr = std::make_unique<VAO>();
+    linkVAO();
+}
+
+void InstancedShape::linkVAO() {
+    Mesh& mesh = *prototype->getMesh();
+
+    // Layouts 0-3 come from the prototype mesh (own buffers or the geometry arena)
+    mesh.linkAttributes(*vao_ptr);
+
+    // (Re)create the instance buffer with room for all current instances
+    if (instanceVbo_ptr) instanceVbo_ptr->Delete();
+    instanceCapacity = instanceMatrices.size();
+    instanceVbo_ptr = std::make_unique<VBO>(
+        instanceMatrices.empty() ? nullptr : (GLfloat*)instanceMatrices.data(),
+        instanceCapacity * sizeof(glm::mat4));
+    instancesDirty = false;
+
+    // Layouts 4-7: one column of the model matrix each, advancing once per instance
+    vao_ptr->Bind();
+    for (GLuint column = 0; column < 4; ++column) {
+        vao_ptr->LinkAttrib(*instanceVbo_ptr, 4 + column, 4, GL_FLOAT, sizeof(glm::mat4),
+            (void*)(column * sizeof(glm::vec4)));
+        glVertexAttribDivisor(4 + column, 1);
+    }
+    vao_ptr->Unbind();
+
+    linkedBufferVersion = mesh.getBufferVersion();
+}
+
+void InstancedShape::uploadInstances() {
+    if (instanceMatrices.size() > instanceCapacity) {
+        // Buffer too small: linkVAO() recreates it at the new size
+        linkVAO();
+        return;
+    }
+    instanceVbo_ptr->Bind();
+    glBufferSubData(GL_ARRAY_BUFFER, 0, instanceMatrices.size() * sizeof(glm::mat4), instanceMatrices.data());
+    instanceVbo_ptr->Unbind();
+    instancesDirty = false;
+}
+
+void InstancedShape::draw(Shader& shader) {
+    if (!vao_ptr) {
+        std::cerr << "Error: InstancedShape not initialized. Cannot draw." << std::endl;
+        return;
+    }
+    if (instanceMatrices.empty()) return;
+
+    Mesh& mesh = *prototype->getMesh();
+    // The arena replaced its buffers (growth / defragment), the VAO points at deleted ones
+    if (mesh.getBufferVersion() != linkedBufferVersion) linkVAO();
+    if (instancesDirty) uploadInstances();
+
+    shader.Activate();
+    mesh.applyDequant(shader);
+
+    GLStateCache::bindTexture(GL_TEXTURE0, GL_TEXTURE_2D, texture ? texture->ID : 0);
+
+    vao_ptr->Bind();
+    mesh.drawInstanced((GLsizei)instanceMatrices.size());
+}
+
+void InstancedShape::cleanup() {
+    if (instanceVbo_ptr) instanceVbo_ptr->Delete();
+    if (vao_ptr) vao_ptr->Delete();
+    instanceVbo_ptr.reset();
+    vao_ptr.reset();
+    instanceCapacity = 0;
+    instancesDirty = true;
+    if (prototype) prototype->cleanup();
+}
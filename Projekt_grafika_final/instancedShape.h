@@ -0,0 +1,61 @@
+#ifndef INSTANCED_SHAPE_H
+#define INSTANCED_SHAPE_H
+
+#include <vector>
+#include <memory>
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include "shape.h"
+#include "shaderClass.h"
+#include "texture.h"
+#include "VAO.h"
+#include "VBO.h"
+
+// Draws many copies of one shape with a single glDrawElementsInstanced call.
+// The per-instance model matrices live in an instance vertex buffer (layouts 4-7, divisor 1),
+// so it must be drawn with a shader that reads the model matrix from attributes (instanced.vert).
+class InstancedShape {
+public:
+    // Takes ownership of the prototype shape whose mesh is repeated
+    explicit InstancedShape(std::unique_ptr<Shape> prototype);
+    ~InstancedShape();
+
+    // Instance management (changes are uploaded on the next draw)
+    size_t addInstance(const glm::mat4& model);
+    void setInstance(size_t index, const glm::mat4& model);
+    void clearInstances();
+    size_t getInstanceCount() const { return instanceMatrices.size(); }
+    const glm::mat4& getInstance(size_t index) const { return instanceMatrices[index]; }
+
+    // Texture shared by all instances
+    void setTexture(Texture* tex) { texture = tex; }
+    Texture* getTexture() const { return texture; }
+
+    // Shape whose mesh is repeated (SceneBuilder prepares its geometry on a worker thread)
+    Shape* getPrototype() const { return prototype.get(); }
+
+    // Sets up the prototype's mesh and the instanced VAO
+    void setupMesh();
+
+    // Draws all instances in one call
+    void draw(Shader& shader);
+
+    // Releases the instanced VAO, the instance buffer and the prototype's mesh
+    void cleanup();
+
+private:
+    std::unique_ptr<Shape> prototype;
+    std::vector<glm::mat4> instanceMatrices;
+    Texture* texture = nullptr;
+
+    std::unique_ptr<VAO> vao_ptr;          // Mesh attributes (0-3) + instance attributes (4-7)
+    std::unique_ptr<VBO> instanceVbo_ptr;  // Per-instance model matrices
+    size_t instanceCapacity = 0;           // Number of matrices the instance buffer can hold
+    bool instancesDirty = true;
+    unsigned int linkedBufferVersion = 0;  // Mesh buffer version the VAO was linked against
+
+    void linkVAO();
+    void uploadInstances();
+};
+
+#endif // INSTANCED_SHAPE_H
@@ -1,15 +1,32 @@
-#version 330 core
-// Input vertex position attribute.
-layout (location = 0) in vec3 aPos;
-
-// Model matrix uniform.
-uniform mat4 model;
-
-// Camera matrix uniform.
-uniform mat4 camMatrix;
-
-void main()
-{
-    // Calculate the final vertex position.
-    gl_Position = camMatrix * model * vec4(aPos, 1.0f);
+#version 330 core
+#ifdef PACKED_VERTICES
+// Input vertex position attribute (packed: snorm16 relative to the mesh bounding box).
+layout (location = 0) in vec4 aPos;
+
+// Bounding box center and half extent of the mesh.
+uniform vec3 meshPosOffset;
+uniform vec3 meshPosScale;
+
+vec3 getPosition() { return meshPosOffset + aPos.xyz * meshPosScale; }
+#else
+// Input vertex position attribute.
+layout (location = 0) in vec3 aPos;
+
+vec3 getPosition() { return aPos; }
+#endif
+
+// Model matrix uniform.
+uniform mat4 model;
+
+// Per-frame camera data, shared by all programs (std140, must match FrameDataBlock in frameUniforms.h)
+layout (std140) uniform FrameData
+{
+    mat4 camMatrix; // Combined view * projection matrix
+    vec3 camPos;    // Camera position in world space
+};
+
+void main()
+{
+    // Calculate the final vertex position.
+    gl_Position = camMatrix * model * vec4(getPosition(), 1.0f);
 }
\ No newline at end of file
@@ -0,0 +1,93 @@
+#include "lodShape.h"
+#include <cmath>
+#include <algorithm>
+#include <limits>
+#include <glm/gtc/constants.hpp>
+#include "Sphere.h"
+#include "Cylinder.h"
+
+const float LodShape::maxErrorPixels = 0.5f;
+const float LodShape::hysteresis = 0.15f;
+
+LodShape::LodShape(std::vector<std::unique_ptr<Shape>> levels, std::vector<float> switchPixels, float boundingRadius)
+    : levels(std::move(levels)), switchPixels(std::move(switchPixels)), boundingRadius(boundingRadius) {
+    this->switchPixels.resize(this->levels.empty() ? 0 : this->levels.size() - 1, 0.0f);
+}
+
+float LodShape::switchRadiusForSectors(unsigned int sectors) {
+    // A regular n-gon inscribed in a circle of radius r deviates from it by r * (1 - cos(pi / n))
+    return maxErrorPixels / (1.0f - cosf(glm::pi<float>() / sectors));
+}
+
+std::unique_ptr<LodShape> LodShape::createSphere(float radius, unsigned int sectors, unsigned int stacks,
+                                                 const glm::vec3& color, int levelCount) {
+    std::vector<std::unique_ptr<Shape>> levels;
+    std::vector<float> switchPixels;
+    for (int i = 0; i < levelCount && sectors >= 6 && stacks >= 3; ++i) {
+        if (i > 0) switchPixels.push_back(switchRadiusForSectors(sectors));
+        levels.push_back(std::make_unique<Sphere>(radius, sectors, stacks, color));
+        sectors /= 2;
+        stacks /= 2;
+    }
+    return std::make_unique<LodShape>(std::move(levels), std::move(switchPixels), radius);
+}
+
+std::unique_ptr<LodShape> LodShape::createCylinder(float baseRadius, float topRadius, float height, unsigned int sectors,
+                                                   unsigned int stacks, bool smooth, const glm::vec3& color, int levelCount) {
+    std::vector<std::unique_ptr<Shape>> levels;
+    std::vector<float> switchPixels;
+    for (int i = 0; i < levelCount && sectors >= 6; ++i) {
+        if (i > 0) switchPixels.push_back(switchRadiusForSectors(sectors));
+        levels.push_back(std::make_unique<Cylinder>(baseRadius, topRadius, height, sectors, stacks, smooth, color));
+        sectors /= 2;
+    }
+    float maxRadius = std::max(baseRadius, topRadius);
+    float boundingRadius = std::sqrt(maxRadius * maxRadius + height * height / 4.0f); // Cylinder is centered on its origin
+    return std::make_unique<LodShape>(std::move(levels), std::move(switchPixels), boundingRadius);
+}
+
+void LodShape::setTexture(Texture* tex) {
+    for (auto& level : levels) level->setTexture(tex);
+}
+
+Bounds LodShape::getWorldBounds() const {
+    BoundingBox box;
+    box.expand(glm::vec3(-boundingRadius));
+    box.expand(glm::vec3(boundingRadius));
+    return Bounds::fromBox(box, boundingRadius).transformed(modelMatrix);
+}
+
+float LodShape::getScreenRadius(const Camera& camera) const {
+    // World-space bounding sphere: origin of the model, radius scaled by the largest axis scale
+    glm::vec3 center = glm::vec3(modelMatrix[3]);
+    float scale = std::max(glm::length(glm::vec3(modelMatrix[0])),
+                  std::max(glm::length(glm::vec3(modelMatrix[1])), glm::length(glm::vec3(modelMatrix[2]))));
+    float radius = boundingRadius * scale;
+
+    float distance = glm::length(center - camera.Position);
+    if (distance <= radius) return std::numeric_limits<float>::infinity();
+
+    // projection[1][1] = cot(fovY / 2): world size at distance 1 -> normalized device coordinates
+    return radius / distance * camera.projection[1][1] * (camera.height * 0.5f);
+}
+
+Shape* LodShape::select(const Camera& camera) {
+    if (levels.empty()) return nullptr;
+    float pixels = getScreenRadius(camera);
+
+    // Contribution culling, entered below cullPixels and left only above the band
+    if (culled) {
+        culled = pixels <= cullPixels * (1.0f + hysteresis);
+    } else {
+        culled = pixels < cullPixels * (1.0f - hysteresis);
+    }
+    if (culled) return nullptr;
+
+    int last = getLevelCount() - 1;
+    while (currentLevel < last && pixels < switchPixels[currentLevel] * (1.0f - hysteresis)) currentLevel++;
+    while (currentLevel > 0 && pixels > switchPixels[currentLevel - 1] * (1.0f + hysteresis)) currentLevel--;
+
+    Shape* shape = levels[currentLevel].get();
+    shape->modelMatrix = modelMatrix;
+    return shape;
+}
@@ -0,0 +1,70 @@
+#ifndef LOD_SHAPE_H
+#define LOD_SHAPE_H
+
+#include <vector>
+#include <memory>
+#include <glm/glm.hpp>
+#include "shape.h"
+#include "camera.h"
+#include "texture.h"
+
+// Discrete level-of-detail chain: the same parametric shape at several tessellations, one of which
+// is drawn per frame depending on its projected size on screen. Objects smaller than cullPixels are
+// not drawn at all (contribution culling). Levels share meshes through the MeshCache like normal shapes.
+class LodShape {
+public:
+    // levels: finest first. switchPixels[i]: screen radius (pixels) below which level i + 1 replaces level i.
+    // boundingRadius: radius of a sphere around the shape's origin containing the whole shape (object space).
+    LodShape(std::vector<std::unique_ptr<Shape>> levels, std::vector<float> switchPixels, float boundingRadius);
+
+    // Chains halving the sector (and stack) count per level, with switch distances chosen so the
+    // silhouette error of the coarser level stays below maxErrorPixels
+    static std::unique_ptr<LodShape> createSphere(float radius, unsigned int sectors, unsigned int stacks,
+                                                  const glm::vec3& color = glm::vec3(1.0f), int levelCount = 3);
+    static std::unique_ptr<LodShape> createCylinder(float baseRadius, float topRadius, float height, unsigned int sectors,
+                                                    unsigned int stacks = 1, bool smooth = true,
+                                                    const glm::vec3& color = glm::vec3(1.0f), int levelCount = 3);
+
+    glm::mat4 modelMatrix = glm::mat4(1.0f);
+
+    // Texture used by every level
+    void setTexture(Texture* tex);
+
+    // Picks the level for this frame from the camera (call after Camera::updateMatrix) and returns it with
+    // modelMatrix applied, or nullptr if the object is too small to draw. Switching uses a hysteresis band
+    // around each threshold, so an object hovering at a boundary does not pop back and forth.
+    Shape* select(const Camera& camera);
+
+    // Box and sphere around the bounding sphere, placed with modelMatrix (covers every level)
+    Bounds getWorldBounds() const;
+
+    // Projected radius in pixels of the bounding sphere (unbounded when the camera is inside it)
+    float getScreenRadius(const Camera& camera) const;
+
+    // Current level (-1 = culled)
+    int getCurrentLevel() const { return culled ? -1 : currentLevel; }
+    int getLevelCount() const { return static_cast<int>(levels.size()); }
+    Shape* getLevel(int level) const { return levels[level].get(); }
+
+    // Screen radius (pixels) below which the object is not drawn (0 disables contribution culling)
+    void setCullPixels(float pixels) { cullPixels = pixels; }
+
+    // Largest allowed silhouette error (pixels) used by the create functions
+    static const float maxErrorPixels;
+    // Relative width of the band around each threshold in which the current level is kept
+    static const float hysteresis;
+
+private:
+    std::vector<std::unique_ptr<Shape>> levels;
+    std::vector<float> switchPixels;
+    float boundingRadius;
+    float cullPixels = 1.0f;
+
+    int currentLevel = 0;
+    bool culled = false;
+
+    // Screen radius at which a circle approximated by 'sectors' segments deviates by maxErrorPixels
+    static float switchRadiusForSectors(unsigned int sectors);
+};
+
+#endif // LOD_SHAPE_H
@@ -1,456 +1,744 @@
-// main.cpp - Art Gallery Demo (Compatible with new multi-light shader, using 1 light, original rotations)
-#include <iostream>
-#include <vector>
-#include <memory>
-#include <string>
-#include <glad/glad.h>
-#include <GLFW/glfw3.h>
-#include <ctime>
-#include <glm/glm.hpp>
-#include <glm/gtc/matrix_transform.hpp>
-#include <glm/gtc/type_ptr.hpp>
-
-#include "shaderClass.h"
-#include "texture.h"
-#include "camera.h"
-#include "Shape.h"
-#include "Cube.h"
-#include "Plane.h"
-#include "Pyramid.h"
-#include "Sphere.h"
-#include "Cylinder.h"
-#include "light.h"
-#include "TrapezoidPrism.h"
-
-// Constants
-const unsigned int SCR_WIDTH = 1920;
-const unsigned int SCR_HEIGHT = 1080;
-const float globalScale = 0.6f; // Global scale factor for all objects
-
-int main() {
-    srand(static_cast<unsigned int>(time(0))); // Initialize random seed
-
-    // --- GLFW and GLAD Initialization ---
-    if (!glfwInit()) {
-        std::cerr << "Failed to initialize GLFW" << std::endl;
-        return -1;
-    }
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-
-    GLFWwindow* window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "Art Gallery - Single Light (Multi-Light Shader)", NULL, NULL);
-    if (window == NULL) {
-        std::cerr << "Failed to create GLFW window" << std::endl;
-        glfwTerminate();
-        return -1;
-    }
-    glfwMakeContextCurrent(window);
-
-    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
-        std::cerr << "Failed to initialize GLAD" << std::endl;
-        glfwTerminate();
-        return -1;
-    }
-
-    glViewport(0, 0, SCR_WIDTH, SCR_HEIGHT);
-    glEnable(GL_DEPTH_TEST);
-    glEnable(GL_CULL_FACE);
-    glCullFace(GL_BACK);
-    glFrontFace(GL_CCW);
-
-    // --- Shaders ---
-    Shader objectShader("default.vert", "default.frag"); // Uses the shader prepared for multiple lights
-    Shader lightSourceShader("light.vert", "light.frag");
-
-    // --- Camera ---
-    Camera camera(SCR_WIDTH, SCR_HEIGHT, glm::vec3(-0.100214, 1.61599, 5.2313));
-
-    // --- Textures ---
-    Texture floorTexture("floor.jpg", GL_TEXTURE_2D, GL_TEXTURE0, GL_RGBA, GL_UNSIGNED_BYTE);
-    Texture wallTexture("red.jpg", GL_TEXTURE_2D, GL_TEXTURE0, GL_RGBA, GL_UNSIGNED_BYTE);
-    Texture metalTexture("marble.jpg", GL_TEXTURE_2D, GL_TEXTURE0, GL_RGBA, GL_UNSIGNED_BYTE);
-    Texture WorldTexture("world.png", GL_TEXTURE_2D, GL_TEXTURE0, GL_RGBA, GL_UNSIGNED_BYTE);
-    Texture woodTextureH("wood_texture_horizontal.png", GL_TEXTURE_2D, GL_TEXTURE0, GL_RGBA, GL_UNSIGNED_BYTE);
-    Texture woodTextureV("wood_texture_vertical.png", GL_TEXTURE_2D, GL_TEXTURE0, GL_RGBA, GL_UNSIGNED_BYTE);
-
-    Texture artTexture1("art1.png", GL_TEXTURE_2D, GL_TEXTURE0, GL_RGBA, GL_UNSIGNED_BYTE);
-    Texture artTexture2("art2.png", GL_TEXTURE_2D, GL_TEXTURE0, GL_RGBA, GL_UNSIGNED_BYTE);
-    Texture artTexture3("art3.png", GL_TEXTURE_2D, GL_TEXTURE0, GL_RGBA, GL_UNSIGNED_BYTE);
-    Texture artTexture4("art4.png", GL_TEXTURE_2D, GL_TEXTURE0, GL_RGBA, GL_UNSIGNED_BYTE);
-    Texture artTexture5("art5.png", GL_TEXTURE_2D, GL_TEXTURE0, GL_RGBA, GL_UNSIGNED_BYTE);
-    Texture artTexture6("art6.png", GL_TEXTURE_2D, GL_TEXTURE0, GL_RGBA, GL_UNSIGNED_BYTE);
-    Texture artTexture7("art7.png", GL_TEXTURE_2D, GL_TEXTURE0, GL_RGBA, GL_UNSIGNED_BYTE);
-    Texture artTexture8("art8.png", GL_TEXTURE_2D, GL_TEXTURE0, GL_RGBA, GL_UNSIGNED_BYTE);
-    Texture artTexture9("art9.png", GL_TEXTURE_2D, GL_TEXTURE0, GL_RGBA, GL_UNSIGNED_BYTE);
-    Texture artTexture10("art10.png", GL_TEXTURE_2D, GL_TEXTURE0, GL_RGBA, GL_UNSIGNED_BYTE);
-    Texture artTexture11("art11.png", GL_TEXTURE_2D, GL_TEXTURE0, GL_RGBA, GL_UNSIGNED_BYTE);
-
-    // Check if textures loaded (abbreviated)
-    if (floorTexture.ID == 0) std::cerr << "Warning: floorTexture failed to load." << std::endl;
-    // ... (rest of checks, assuming they are present and correct)
-    if (artTexture9.ID == 0) std::cerr << "Warning: artTexture9 (formerly artTexturePlaster) failed to load." << std::endl;
-
-    objectShader.Activate();
-    if (floorTexture.ID != 0) floorTexture.texUnit(objectShader, "tex0", 0);
-    else if (wallTexture.ID != 0) wallTexture.texUnit(objectShader, "tex0", 0);
-    else std::cerr << "WARNING: No valid textures to set 'tex0' sampler uniform for objectShader." << std::endl;
-
-    // --- Gallery Structure ---
-    std::vector<std::unique_ptr<Shape>> galleryWalls;
-    std::vector<std::unique_ptr<Shape>> artworks;
-    std::vector<std::unique_ptr<Shape>> otherObjects;
-
-    float galleryWidth = 10.0f;
-    float galleryDepth = 12.0f;
-    float galleryHeight = 4.0f;
-    float artDisplayHeight = galleryHeight / 2.0f - 0.2f;
-
-    // wall_frame parameters
-    float wall_frameHeight = 0.2f;
-    float wall_frameDepth = 0.1f;
-    float wall_frameBaseWidth = 0.1f;
-    float wall_frameTopWidth = 0.0f;
-
-    glm::vec3 wall_frameColor(0.3f, 0.2f, 0.1f);
-
-    // Create TrapezoidPrism objects for each wall
-    auto addWallwall_frame = [&](float width, float height, float depthTop, float depthBottom, const glm::vec3& color, const glm::vec3& position, const glm::vec3& rotation) {
-        auto wall_frame = std::make_unique<TrapezoidPrism>(width, height, depthTop, depthBottom, color);
-        wall_frame->setTexture(&woodTextureH);
-        wall_frame->modelMatrix = glm::translate(glm::mat4(1.0f), position);
-        wall_frame->modelMatrix = glm::rotate(wall_frame->modelMatrix, glm::radians(rotation.x), glm::vec3(1.0f, 0.0f, 0.0f));
-        wall_frame->modelMatrix = glm::rotate(wall_frame->modelMatrix, glm::radians(rotation.y), glm::vec3(0.0f, 1.0f, 0.0f));
-        wall_frame->modelMatrix = glm::rotate(wall_frame->modelMatrix, glm::radians(rotation.z), glm::vec3(0.0f, 0.0f, 1.0f));
-        wall_frame->setupMesh();
-        otherObjects.push_back(std::move(wall_frame));
-    };
-
-    // Wall 1: along -Z axis
-    addWallwall_frame(galleryWidth, wall_frameHeight, wall_frameTopWidth, wall_frameDepth, wall_frameColor, glm::vec3(0.0f, 0.0f, -galleryDepth / 2.0f - wall_frameDepth / 2.0f), glm::vec3(0.0f, 0.0f, 0.0f));
-
-    // Wall 2: along -X axis
-    addWallwall_frame(galleryDepth, wall_frameHeight, wall_frameTopWidth, wall_frameDepth, wall_frameColor, glm::vec3(-galleryWidth / 2.0f - wall_frameDepth / 2.0f, 0.0f, 0.0f), glm::vec3(0.0f, 90.0f, 0.0f));
-
-    // Wall 3: along +X axis
-    addWallwall_frame(galleryDepth, wall_frameHeight, wall_frameTopWidth, wall_frameDepth, wall_frameColor, glm::vec3(galleryWidth / 2.0f + wall_frameDepth / 2.0f, 0.0f, 0.0f), glm::vec3(0.0f, -90.0f, 0.0f));
-
-    // Wall 4: along +Z axis
-    addWallwall_frame(galleryWidth, wall_frameHeight, wall_frameTopWidth, wall_frameDepth, wall_frameColor, glm::vec3(0.0f, 0.0f, galleryDepth / 2.0f + wall_frameDepth / 2.0f), glm::vec3(0.0f, 180.0f, 0.0f));
-
-    // Floor
-    auto floor_obj = std::make_unique<Plane>(galleryWidth, galleryDepth, glm::vec3(1.0f), glm::vec2(5.0f, 6.0f)); // Renamed variable from 'floor' to 'floor_obj'
-    if (floorTexture.ID != 0) floor_obj->setTexture(&floorTexture);
-    floor_obj->setupMesh();
-    otherObjects.push_back(std::move(floor_obj));
-
-    // Ceiling
-    auto ceiling = std::make_unique<Plane>(galleryWidth, galleryDepth, glm::vec3(1.0f), glm::vec2(1.0f, 1.0f));
-    ceiling->modelMatrix = glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, galleryHeight, 0.0f));
-    ceiling->modelMatrix = glm::rotate(ceiling->modelMatrix, glm::radians(180.0f), glm::vec3(1.0f, 0.0f, 0.0f));
-    if (wallTexture.ID != 0) ceiling->setTexture(&wallTexture);
-    ceiling->setupMesh();
-    otherObjects.push_back(std::move(ceiling));
-
-    // Walls (original lambda createWall and its calls)
-    auto createWall = [&](const glm::vec3& position, const glm::vec3& rotation, float width, float height, glm::vec2 texRepeat) {
-        auto wall = std::make_unique<Plane>(width, height, glm::vec3(0.8f), texRepeat);
-        if (wallTexture.ID != 0) wall->setTexture(&wallTexture);
-        wall->modelMatrix = glm::translate(glm::mat4(1.0f), position);
-        wall->modelMatrix = glm::rotate(wall->modelMatrix, glm::radians(rotation.x), glm::vec3(1.0f, 0.0f, 0.0f));
-        wall->modelMatrix = glm::rotate(wall->modelMatrix, glm::radians(rotation.y), glm::vec3(0.0f, 1.0f, 0.0f));
-        wall->modelMatrix = glm::rotate(wall->modelMatrix, glm::radians(rotation.z), glm::vec3(0.0f, 0.0f, 1.0f));
-        wall->setupMesh();
-        galleryWalls.push_back(std::move(wall));
-    };
-
-    createWall(glm::vec3(0.0f, galleryHeight / 2.0f, -galleryDepth / 2.0f), glm::vec3(90.0f, 0.0f, 0.0f), galleryWidth, galleryHeight, glm::vec2(1.0f, 1.0f));
-    createWall(glm::vec3(-galleryWidth / 2.0f, galleryHeight / 2.0f, 0.0f), glm::vec3(90.0f, 180.0f, 90.0f), galleryDepth, galleryHeight, glm::vec2(1.0f, 1.0f));
-    createWall(glm::vec3(galleryWidth / 2.0f, galleryHeight / 2.0f, 0.0f), glm::vec3(90.0f, 180.0f, -90.0f), galleryDepth, galleryHeight, glm::vec2(1.0f, 1.0f));
-    createWall(glm::vec3(0.0f, galleryHeight / 2.0f, galleryDepth / 2.0f), glm::vec3(90.0f, 180.0f, 180.0f), galleryWidth, galleryHeight, glm::vec2(1.0f, 1.0f));
-
-    // --- Artworks --- (original lambda addArt and its calls)
-    float artHeightDefault = 1.5f;
-    float artWidthDefault = 1.0f;
-    float artDepthOffset = 0.051f;
-
-    auto addArt = [&](float width, float height, Texture& texture, glm::vec3 translation, const std::vector<std::pair<float, glm::vec3>>& rotations) {
-        auto art = std::make_unique<Plane>(width, height, glm::vec3(1.0f), glm::vec2(1.0f));
-        if (texture.ID != 0) art->setTexture(&texture);
-        glm::mat4 model = glm::translate(glm::mat4(1.0f), translation);
-        for (size_t i = 0; i < rotations.size(); ++i)
-            model = glm::rotate(model, glm::radians(rotations[i].first), rotations[i].second);
-        art->modelMatrix = model;
-        art->setupMesh();
-        artworks.push_back(std::move(art));
-    };
-
-    addArt(artWidthDefault, artHeightDefault, artTexture1,
-        { -2.0f, artDisplayHeight, -galleryDepth / 2.0f + artDepthOffset },
-        { {90.0f, {1.0f, 0.0f, 0.0f}} });
-
-    addArt(artHeightDefault * 6.5f, artWidthDefault * 3.0f, artTexture2,
-        { -galleryWidth / 2.0f + artDepthOffset, artDisplayHeight + 0.2f, 0.0f },
-        { {90.0f, {1.0f, 0.0f, 0.0f}}, {-90.0f, {0.0f, 0.0f, 1.0f}}, {180.0f, {0.0f, 1.0f, 0.0f}} });
-
-    addArt(artWidthDefault, artHeightDefault, artTexture3,
-        { 0.0f, artDisplayHeight, -galleryDepth / 2.0f + artDepthOffset },
-        { {90.0f, {1.0f, 0.0f, 0.0f}}, {180.0f, {0.0f, 1.0f, 0.0f}} });
-
-    addArt(artWidthDefault * 1.2f, artHeightDefault * 0.8f, artTexture4,
-        { 2.5f, artDisplayHeight, -galleryDepth / 2.0f + artDepthOffset },
-        { {90.0f, {1.0f, 0.0f, 0.0f}}, {180.0f, {0.0f, 1.0f, 0.0f}} });
-
-    addArt(artHeightDefault, artWidthDefault, artTexture5,
-        { galleryWidth / 2.0f - artDepthOffset, artDisplayHeight, 0.0f },
-        { {90.0f, {1.0f, 0.0f, 0.0f}}, {90.0f, {0.0f, 0.0f, 1.0f}}, {180.0f, {0.0f, 1.0f, 0.0f}} });
-
-    addArt(artHeightDefault * 1.2f, artWidthDefault * 1.2f, artTexture6,
-        { galleryWidth / 2.0f - artDepthOffset, artDisplayHeight, -3.0f },
-        { {90.0f, {1.0f, 0.0f, 0.0f}}, {90.0f, {0.0f, 0.0f, 1.0f}}, {180.0f, {0.0f, 1.0f, 0.0f}} });
-
-    addArt(artWidthDefault, artHeightDefault, artTexture7,
-        { -2.0f, artDisplayHeight, galleryDepth / 2.0f - artDepthOffset },
-        { {-90.0f, {1.0f, 0.0f, 0.0f}} });
-
-    addArt(artWidthDefault, artHeightDefault, artTexture8,
-        { 0.0f, artDisplayHeight, galleryDepth / 2.0f - artDepthOffset },
-        { {-90.0f, {1.0f, 0.0f, 0.0f}} });
-
-    addArt(artWidthDefault, artHeightDefault, artTexture9,
-        { 2.0f, artDisplayHeight, galleryDepth / 2.0f - artDepthOffset },
-        { {-90.0f, {1.0f, 0.0f, 0.0f}} });
-
-    addArt(artHeightDefault, artWidthDefault, artTexture11,
-        { galleryWidth / 2.0f - artDepthOffset, artDisplayHeight, 3.0f },
-        { {90.0f, {1.0f, 0.0f, 0.0f}}, {90.0f, {0.0f, 0.0f, 1.0f}}, {180.0f, {0.0f, 1.0f, 0.0f}} });
-
-    // --- 3D Frames for all artworks ---
-    float frameThickness = 0.05f; // Thickness of the frame bars
-    float frameDepth = 0.07f;     // How much the frame protrudes from the wall
-    glm::vec3 frameColor(0.2f, 0.12f, 0.05f); // Fallback color
-
-    // Helper: artwork parameters (width, height, translation, rotations, texture)
-    struct ArtFrameParams {
-        float width, height;
-        glm::vec3 translation;
-        std::vector<std::pair<float, glm::vec3>> rotations;
-    };
-    std::vector<ArtFrameParams> artParams = {
-        // artTexture1
-        {artWidthDefault, artHeightDefault, {-2.0f, artDisplayHeight, -galleryDepth / 2.0f + artDepthOffset}, { {90.0f, {1.0f, 0.0f, 0.0f}} }},
-        // artTexture2
-        {artHeightDefault * 6.5f, artWidthDefault * 3.0f, {-galleryWidth / 2.0f + artDepthOffset, artDisplayHeight + 0.2f, 0.0f}, { {90.0f, {1.0f, 0.0f, 0.0f}}, {-90.0f, {0.0f, 0.0f, 1.0f}}, {180.0f, {0.0f, 1.0f, 0.0f}} }},
-        // artTexture3
-        {artWidthDefault, artHeightDefault, {0.0f, artDisplayHeight, -galleryDepth / 2.0f + artDepthOffset}, { {90.0f, {1.0f, 0.0f, 0.0f}}, {180.0f, {0.0f, 1.0f, 0.0f}} }},
-        // artTexture4
-        {artWidthDefault * 1.2f, artHeightDefault * 0.8f, {2.5f, artDisplayHeight, -galleryDepth / 2.0f + artDepthOffset}, { {90.0f, {1.0f, 0.0f, 0.0f}}, {180.0f, {0.0f, 1.0f, 0.0f}} }},
-        // artTexture5
-        {artHeightDefault, artWidthDefault, {galleryWidth / 2.0f - artDepthOffset, artDisplayHeight, 0.0f}, { {90.0f, {1.0f, 0.0f, 0.0f}}, {90.0f, {0.0f, 0.0f, 1.0f}}, {180.0f, {0.0f, 1.0f, 0.0f}} }},
-        // artTexture6
-        {artHeightDefault * 1.2f, artWidthDefault * 1.2f, {galleryWidth / 2.0f - artDepthOffset, artDisplayHeight, -3.0f}, { {90.0f, {1.0f, 0.0f, 0.0f}}, {90.0f, {0.0f, 0.0f, 1.0f}}, {180.0f, {0.0f, 1.0f, 0.0f}} }},
-        // artTexture7
-        {artWidthDefault, artHeightDefault, {-2.0f, artDisplayHeight, galleryDepth / 2.0f - artDepthOffset}, { {-90.0f, {1.0f, 0.0f, 0.0f}} }},
-        // artTexture8
-        {artWidthDefault, artHeightDefault, {0.0f, artDisplayHeight, galleryDepth / 2.0f - artDepthOffset}, { {-90.0f, {1.0f, 0.0f, 0.0f}} }},
-        // artTexture9
-        {artWidthDefault, artHeightDefault, {2.0f, artDisplayHeight, galleryDepth / 2.0f - artDepthOffset}, { {-90.0f, {1.0f, 0.0f, 0.0f}} }},
-        // artTexture11
-        {artHeightDefault, artWidthDefault, {galleryWidth / 2.0f - artDepthOffset, artDisplayHeight, 3.0f}, { {90.0f, {1.0f, 0.0f, 0.0f}}, {90.0f, {0.0f, 0.0f, 1.0f}}, {180.0f, {0.0f, 1.0f, 0.0f}} }},
-    };
-
-    for (size_t idx = 0; idx < artParams.size(); ++idx)
-    {
-        // Skip frame for the largest artwork (index 1)
-        if (idx == 1) continue;
-        const auto& art = artParams[idx];
-        float frameWidth = art.width + 0.10f;
-        float frameHeight = art.height + 0.10f;
-        float halfW = frameWidth / 2.0f;
-        float halfH = frameHeight / 2.0f;
-
-        // Build the base transform: translation + rotations (artwork's local space)
-        glm::vec3 protrudeVec(0.0f);
-        float protrude = frameDepth / 2.0f;
-
-        // Determine protrude direction based on artwork position (wall)
-        if (art.translation.z < -galleryDepth / 4.0f) { protrudeVec = glm::vec3(0, 0, protrude); }
-        else if (art.translation.z > galleryDepth / 4.0f) { protrudeVec = glm::vec3(0, 0, -protrude); }
-        else if (art.translation.x < -galleryWidth / 4.0f) { protrudeVec = glm::vec3(protrude, 0, 0); }
-        else if (art.translation.x > galleryWidth / 4.0f) { protrudeVec = glm::vec3(-protrude, 0, 0); }
-        else { protrudeVec = glm::vec3(0, 0, protrude); }
-
-        glm::mat4 baseModel = glm::translate(glm::mat4(1.0f), art.translation + protrudeVec);
-        for (const auto& rot : art.rotations) baseModel = glm::rotate(baseModel, glm::radians(rot.first), rot.second);
-        baseModel = glm::rotate(baseModel, glm::radians(90.0f), glm::vec3(1.0f, 0.0f, 0.0f));
-
-        // Vertical bars (left and right)
-        for (int i = 0; i < 2; ++i) {
-            float xOffset = (halfW - frameThickness / 2.0f) * (i == 0 ? 1.0f : -1.0f);
-            glm::mat4 model = baseModel * glm::translate(glm::mat4(1.0f), glm::vec3(xOffset, 0.0f, 0.0f));
-            auto bar = std::make_unique<Cube>(
-                frameThickness, frameHeight, frameDepth, frameColor
-            );
-            if (woodTextureV.ID != 0) bar->setTexture(&woodTextureV);
-            bar->modelMatrix = model;
-            bar->setupMesh();
-            otherObjects.push_back(std::move(bar));
-        }
-
-        // Horizontal bars (top and bottom)
-        float horizontalBarLength = frameWidth - 2 * frameThickness;
-        for (int i = 0; i < 2; ++i) {
-            float yOffset = (halfH - frameThickness / 2.0f) * (i == 0 ? 1.0f : -1.0f);
-            glm::mat4 model = baseModel * glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, yOffset, 0.0f));
-            auto bar = std::make_unique<Cube>(
-                horizontalBarLength, frameThickness, frameDepth, frameColor
-            );
-            if (woodTextureH.ID != 0) bar->setTexture(&woodTextureH);
-            bar->modelMatrix = model;
-            bar->setupMesh();
-            otherObjects.push_back(std::move(bar));
-        }
-    }
-
-    // --- Sculpture --- (original code)
-    auto pedestal = std::make_unique<Cylinder>(0.3f, 0.3f, 1.0f, 24, 1, true, glm::vec3(0.4f));
-    if (metalTexture.ID != 0) pedestal->setTexture(&metalTexture);
-    pedestal->modelMatrix = glm::translate(glm::mat4(1.0f), glm::vec3(1.5f, 0.5f, -1.0f));
-    pedestal->setupMesh();
-    otherObjects.push_back(std::move(pedestal));
-
-    glm::vec3 sculptureBasePosition = glm::vec3(1.5f, 1.0f + 0.4f + 0.05f, -1.0f);
-    auto sculpture_temp = std::make_unique<Sphere>(0.4f, 32, 16, glm::vec3(0.7f, 0.1f, 0.1f));
-    Sphere* sculpturePtr = sculpture_temp.get();
-    if (WorldTexture.ID != 0) sculpturePtr->setTexture(&WorldTexture);
-    sculpturePtr->modelMatrix = glm::translate(glm::mat4(1.0f), sculptureBasePosition);
-    sculpturePtr->modelMatrix = glm::rotate(glm::mat4(sculpturePtr->modelMatrix), glm::radians(-90.0f), glm::vec3(0.0, 0.0, 1.0));
-    sculpturePtr->setupMesh();
-    otherObjects.push_back(std::move(sculpture_temp));
-
-    glm::vec3 pedestal2Position = glm::vec3(-2.5f, 0.5f, -1.5f); // New position for the second pedestal
-    auto pedestal2 = std::make_unique<Cylinder>(0.3f, 0.3f, 1.0f, 24, 1, true, glm::vec3(0.3f, 0.3f, 0.35f)); // Different pedestal color
-    if (metalTexture.ID != 0) pedestal2->setTexture(&metalTexture); // You can use the same or a different texture
-    pedestal2->modelMatrix = glm::translate(glm::mat4(1.0f), pedestal2Position);
-    pedestal2->setupMesh();
-    otherObjects.push_back(std::move(pedestal2));
-
-    glm::vec3 pyramidPosition = glm::vec3(pedestal2Position.x, pedestal2Position.y + 0.5f + 0.4f, pedestal2Position.z); // On the pedestal (pedestal height 1.0/2 + pyramid height 0.8/2)
-    auto pyramidSculpture = std::make_unique<Pyramid>(glm::vec3(0.7f, 0.2f, 0.2f), glm::vec3(0.9f, 0.5f, 0.5f)); // Pyramid colors
-
-    if (artTexture10.ID != 0) pyramidSculpture->setTexture(&artTexture10);
-    pyramidSculpture->setupMesh();
-    Pyramid* pyramidPtr = pyramidSculpture.get();
-    // Store a pointer to the pyramid
-    otherObjects.push_back(std::move(pyramidSculpture));
-
-    // --- Light Source (using PointLightData from light.h for a single light) ---
-    PointLightData mainLight( // Name changed from pointLight to mainLight for clarity
-        glm::vec3(0.0f, galleryHeight - 0.1f, 0.0f), // Initial position
-        glm::vec4(0.9f, 0.9f, 0.8f, 1.0f)           // Color
-    );
-    // mainLight.visualRepresentation is created in the PointLightData constructor
-
-    // --- Render Loop ---
-    while (!glfwWindowShouldClose(window)) {
-        float currentFrame = static_cast<float>(glfwGetTime());
-
-        camera.Inputs(window);
-        camera.updateMatrix(45.0f, 0.1f, 100.0f);
-
-        // Animate light
-        mainLight.position.x = sin(currentFrame * 0.3f) * 3.0f;
-        mainLight.position.z = cos(currentFrame * 0.3f) * 3.0f;
-        // Update model matrix for light visualization
-
-
-        // Animate sculpture
-        if (sculpturePtr) {
-            glm::mat4 initialTranslation = glm::translate(glm::mat4(1.0f), sculptureBasePosition);
-            float rotationSpeed = 1.5f;
-            glm::mat4 rotationMatrix = glm::rotate(glm::mat4(1.0f), rotationSpeed * currentFrame, glm::vec3(0.0f, 1.0f, 0.0f));
-            sculpturePtr->modelMatrix = initialTranslation * rotationMatrix;
-        }
-        if (mainLight.visualRepresentation) {
-            mainLight.visualRepresentation->modelMatrix = glm::translate(glm::mat4(1.0f), mainLight.position);
-        }
-
-        if (pyramidPtr) {
-            glm::mat4 scaleMat = glm::scale(glm::mat4(1.0f), glm::vec3(globalScale));
-            glm::mat4 initialOrientationMat = glm::rotate(glm::mat4(1.0f), glm::radians(12.0f), glm::vec3(1.0f, 1.0f, 1.0f)); // Static initial orientation
-
-            // Pyramid's own rotation (around its local Y axis, after initialOrientationMat)
-            float spinSpeed = 2.5f;
-            glm::mat4 spinRotation = glm::rotate(glm::mat4(1.0f), spinSpeed * currentFrame, glm::vec3(0.0f, 1.0f, 0.0f));
-
-            // Precession rotation - the entire system (already rotating pyramid) rotates around the global Y axis
-            float precessionSpeed = 0.5f;
-            glm::mat4 precessionRotation = glm::rotate(glm::mat4(1.0f), precessionSpeed * currentFrame, glm::vec3(0.0f, 1.0f, 0.0f));
-
-            glm::mat4 translationMat = glm::translate(glm::mat4(1.0f), pyramidPosition);
-
-            // Order: T * R_precession * R_own_rotation * R_initial_orientation * S
-            pyramidPtr->modelMatrix = translationMat * precessionRotation * spinRotation * initialOrientationMat * scaleMat;
-        }
-
-        glClearColor(0.05f, 0.86f, 0.86f, 1.0f);
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-        // --- Set Uniforms for Object Shader ---
-        objectShader.Activate();
-        camera.Matrix(objectShader, "camMatrix");
-        glUniform3fv(glGetUniformLocation(objectShader.ID, "camPos"), 1, glm::value_ptr(camera.Position));
-
-        // Send the data of ONE light as the first in the shader's array
-        glUniform1i(glGetUniformLocation(objectShader.ID, "numActiveLights"), 1); // Only one active light
-        glUniform3fv(glGetUniformLocation(objectShader.ID, "pointLights[0].position"), 1, glm::value_ptr(mainLight.position));
-        glUniform4fv(glGetUniformLocation(objectShader.ID, "pointLights[0].color"), 1, glm::value_ptr(mainLight.color));
-
-        // --- Draw Gallery Objects ---
-        for (const auto& wall : galleryWalls) wall->draw(objectShader);
-        for (const auto& art : artworks) art->draw(objectShader);
-        for (const auto& obj : otherObjects) {
-            bool isCylinder = (dynamic_cast<Cylinder*>(obj.get()) != nullptr);
-            if (isCylinder) glDisable(GL_CULL_FACE);
-            obj->draw(objectShader);
-            if (isCylinder) glEnable(GL_CULL_FACE);
-        }
-
-        // --- Draw Light Source Visual ---
-        lightSourceShader.Activate();
-        camera.Matrix(lightSourceShader, "camMatrix");
-        // Draw light visualization, if it exists
-        if (mainLight.visualRepresentation) {
-            glUniform4fv(glGetUniformLocation(lightSourceShader.ID, "lightColor"), 1, glm::value_ptr(mainLight.color));
-            mainLight.visualRepresentation->draw(lightSourceShader);
-        }
-
-        camera.printData();
-
-        glfwSwapBuffers(window);
-        glfwPollEvents();
-    }
-
-    // --- Cleanup ---
-    galleryWalls.clear();
-    artworks.clear();
-    otherObjects.clear();
-    // mainLight.visualRepresentation will be automatically released by unique_ptr
-
-    floorTexture.Delete();
-    wallTexture.Delete();
-    metalTexture.Delete();
-    WorldTexture.Delete();
-
-    artTexture1.Delete(); artTexture2.Delete(); artTexture3.Delete();
-    artTexture4.Delete(); artTexture5.Delete(); artTexture6.Delete();
-    artTexture7.Delete(); artTexture8.Delete(); artTexture9.Delete();
-
-    objectShader.Delete();
-    lightSourceShader.Delete();
-
-    glfwDestroyWindow(window);
-    glfwTerminate();
-
-    return 0;
-}
+// main.cpp - Art Gallery Demo (Compatible with new multi-light shader, using 1 light, original rotations)
+#include <iostream>
+#include <vector>
+#include <memory>
+#include <string>
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <ctime>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include "shaderClass.h"
+#include "texture.h"
+#include "camera.h"
+#include "Shape.h"
+#include "Cube.h"
+#include "Plane.h"
+#include "Pyramid.h"
+#include "Sphere.h"
+#include "Cylinder.h"
+#include "light.h"
+#include "TrapezoidPrism.h"
+#include "meshCache.h"
+#include "meshFile.h"
+#include "meshOptimizer.h"
+#include "geometryArena.h"
+#include "instancedShape.h"
+#include "lodShape.h"
+#include "staticBatcher.h"
+#include "benchmark.h"
+#include "threadPool.h"
+#include "sceneBuilder.h"
+#include "frustumCuller.h"
+#include "bvh.h"
+#include "occlusionCuller.h"
+#include "portalSystem.h"
+#include "occlusionQueries.h"
+#include "scene.h"
+#include "collisionWorld.h"
+#include "renderQueue.h"
+#include "frameUniforms.h"
+
+// Constants
+const unsigned int SCR_WIDTH = 1920;
+const unsigned int SCR_HEIGHT = 1080;
+const float globalScale = 0.6f; // Global scale factor for all objects
+const bool usePackedVertices = true; // 20-byte quantized vertices instead of 44-byte floats (see vertexFormat.h)
+const bool useStaticBatching = true; // Merge static geometry into one mesh per texture (see staticBatcher.h)
+const bool useFrustumCulling = true; // Skip objects outside the view frustum (see frustumCuller.h)
+const bool useOcclusionCulling = true; // Skip objects hidden behind walls, floor and ceiling (see occlusionCuller.h)
+const bool usePortalCulling = true; // Skip rooms not seen through any door from the camera's room (see portalSystem.h)
+const bool useOcclusionQueries = false; // GPU occlusion queries + conditional rendering for the individually drawn objects (see occlusionQueries.h)
+const bool useCameraCollision = true; // Keep the camera out of walls, floor, ceiling and exhibits (see collisionWorld.h)
+const char* meshCacheDirectory = "meshcache"; // Generated meshes are stored here and mapped on later runs ("" = off, see meshFile.h)
+
+int main(int argc, char** argv) {
+    // "--benchmark": run the CPU microbenchmarks instead of the gallery (no window needed)
+    for (int i = 1; i < argc; ++i) {
+        if (std::string(argv[i]) == "--benchmark") {
+            return runBenchmarks();
+        }
+    }
+
+    srand(static_cast<unsigned int>(time(0))); // Initialize random seed
+
+    // --- GLFW and GLAD Initialization ---
+    if (!glfwInit()) {
+        std::cerr << "Failed to initialize GLFW" << std::endl;
+        return -1;
+    }
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+
+    GLFWwindow* window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "Art Gallery - Single Light (Multi-Light Shader)", NULL, NULL);
+    if (window == NULL) {
+        std::cerr << "Failed to create GLFW window" << std::endl;
+        glfwTerminate();
+        return -1;
+    }
+    glfwMakeContextCurrent(window);
+
+    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
+        std::cerr << "Failed to initialize GLAD" << std::endl;
+        glfwTerminate();
+        return -1;
+    }
+
+    glViewport(0, 0, SCR_WIDTH, SCR_HEIGHT);
+    GLStateCache::setEnabled(GL_DEPTH_TEST, true);
+    GLStateCache::setEnabled(GL_CULL_FACE, true);
+    GLStateCache::setCullFace(GL_BACK);
+    glFrontFace(GL_CCW);
+
+    // --- Geometry Arena ---
+    // All meshes below are sub-allocated from one vertex buffer and one index buffer,
+    // so the whole scene is drawn through a single VAO (the arena grows if needed)
+    const VertexFormat vertexFormat = usePackedVertices ? VertexFormat::Packed : VertexFormat::Float;
+    GeometryArena geometryArena(16 * 1024, 128 * 1024, vertexFormat); // 16K vertices, 128 KB of indices
+    Shape::setGeometryArena(&geometryArena);
+    Shape::setVertexFormat(vertexFormat);
+    Shape::setMeshCacheDirectory(meshCacheDirectory);
+
+    // --- Shaders ---
+    // The vertex shaders decode the packed format when compiled with PACKED_VERTICES
+    const char* shaderDefines = usePackedVertices ? "#define PACKED_VERTICES\n" : nullptr;
+    Shader objectShader("default.vert", "default.frag", shaderDefines); // Uses the shader prepared for multiple lights
+    Shader lightSourceShader("light.vert", "light.frag", shaderDefines);
+    Shader instancedShader("instanced.vert", "default.frag", shaderDefines); // Model matrix comes from per-instance attributes
+
+    // --- Camera ---
+    Camera camera(SCR_WIDTH, SCR_HEIGHT, glm::vec3(-0.100214, 1.61599, 5.2313));
+
+    // --- Textures ---
+    Texture floorTexture("floor.jpg", GL_TEXTURE_2D, GL_TEXTURE0, GL_RGBA, GL_UNSIGNED_BYTE);
+    Texture wallTexture("red.jpg", GL_TEXTURE_2D, GL_TEXTURE0, GL_RGBA, GL_UNSIGNED_BYTE);
+    Texture metalTexture("marble.jpg", GL_TEXTURE_2D, GL_TEXTURE0, GL_RGBA, GL_UNSIGNED_BYTE);
+    Texture WorldTexture("world.png", GL_TEXTURE_2D, GL_TEXTURE0, GL_RGBA, GL_UNSIGNED_BYTE);
+    Texture woodTextureH("wood_texture_horizontal.png", GL_TEXTURE_2D, GL_TEXTURE0, GL_RGBA, GL_UNSIGNED_BYTE);
+    Texture woodTextureV("wood_texture_vertical.png", GL_TEXTURE_2D, GL_TEXTURE0, GL_RGBA, GL_UNSIGNED_BYTE);
+
+    Texture artTexture1("art1.png", GL_TEXTURE_2D, GL_TEXTURE0, GL_RGBA, GL_UNSIGNED_BYTE);
+    Texture artTexture2("art2.png", GL_TEXTURE_2D, GL_TEXTURE0, GL_RGBA, GL_UNSIGNED_BYTE);
+    Texture artTexture3("art3.png", GL_TEXTURE_2D, GL_TEXTURE0, GL_RGBA, GL_UNSIGNED_BYTE);
+    Texture artTexture4("art4.png", GL_TEXTURE_2D, GL_TEXTURE0, GL_RGBA, GL_UNSIGNED_BYTE);
+    Texture artTexture5("art5.png", GL_TEXTURE_2D, GL_TEXTURE0, GL_RGBA, GL_UNSIGNED_BYTE);
+    Texture artTexture6("art6.png", GL_TEXTURE_2D, GL_TEXTURE0, GL_RGBA, GL_UNSIGNED_BYTE);
+    Texture artTexture7("art7.png", GL_TEXTURE_2D, GL_TEXTURE0, GL_RGBA, GL_UNSIGNED_BYTE);
+    Texture artTexture8("art8.png", GL_TEXTURE_2D, GL_TEXTURE0, GL_RGBA, GL_UNSIGNED_BYTE);
+    Texture artTexture9("art9.png", GL_TEXTURE_2D, GL_TEXTURE0, GL_RGBA, GL_UNSIGNED_BYTE);
+    Texture artTexture10("art10.png", GL_TEXTURE_2D, GL_TEXTURE0, GL_RGBA, GL_UNSIGNED_BYTE);
+    Texture artTexture11("art11.png", GL_TEXTURE_2D, GL_TEXTURE0, GL_RGBA, GL_UNSIGNED_BYTE);
+
+    // Check if textures loaded (abbreviated)
+    if (floorTexture.ID == 0) std::cerr << "Warning: floorTexture failed to load." << std::endl;
+    // ... (rest of checks, assuming they are present and correct)
+    if (artTexture9.ID == 0) std::cerr << "Warning: artTexture9 (formerly artTexturePlaster) failed to load." << std::endl;
+
+    objectShader.Activate();
+    if (floorTexture.ID != 0) floorTexture.texUnit(objectShader, "tex0", 0);
+    else if (wallTexture.ID != 0) wallTexture.texUnit(objectShader, "tex0", 0);
+    else std::cerr << "WARNING: No valid textures to set 'tex0' sampler uniform for objectShader." << std::endl;
+    instancedShader.Activate();
+    instancedShader.set(Uniforms::tex0, 0);
+
+    // --- Gallery Structure ---
+    std::vector<std::unique_ptr<Shape>> galleryWalls;
+    std::vector<std::unique_ptr<Shape>> artworks;
+    std::vector<std::unique_ptr<Shape>> otherObjects;
+    std::vector<std::unique_ptr<InstancedShape>> instancedObjects;
+    std::vector<std::unique_ptr<LodShape>> lodObjects; // Level of detail picked per frame from the screen size
+
+    // Shapes are only queued here; sceneBuilder.build() generates all geometry in parallel and then uploads it
+    ThreadPool threadPool;
+    SceneBuilder sceneBuilder(threadPool);
+    // Static geometry merged by the StaticBatcher is only generated: the batches are its meshes
+    auto addStatic = [&](auto* shape) {
+        if (useStaticBatching) sceneBuilder.addGeometryOnly(shape);
+        else sceneBuilder.add(shape);
+    };
+
+    float galleryWidth = 10.0f;
+    float galleryDepth = 12.0f;
+    float galleryHeight = 4.0f;
+    float artDisplayHeight = galleryHeight / 2.0f - 0.2f;
+
+    // wall_frame parameters
+    float wall_frameHeight = 0.2f;
+    float wall_frameDepth = 0.1f;
+    float wall_frameBaseWidth = 0.1f;
+    float wall_frameTopWidth = 0.0f;
+
+    glm::vec3 wall_frameColor(0.3f, 0.2f, 0.1f);
+
+    // Create TrapezoidPrism objects for each wall
+    auto addWallwall_frame = [&](float width, float height, float depthTop, float depthBottom, const glm::vec3& color, const glm::vec3& position, const glm::vec3& rotation) {
+        auto wall_frame = std::make_unique<TrapezoidPrism>(width, height, depthTop, depthBottom, color);
+        wall_frame->setTexture(&woodTextureH);
+        wall_frame->isStatic = true;
+        wall_frame->modelMatrix = glm::translate(glm::mat4(1.0f), position);
+        wall_frame->modelMatrix = glm::rotate(wall_frame->modelMatrix, glm::radians(rotation.x), glm::vec3(1.0f, 0.0f, 0.0f));
+        wall_frame->modelMatrix = glm::rotate(wall_frame->modelMatrix, glm::radians(rotation.y), glm::vec3(0.0f, 1.0f, 0.0f));
+        wall_frame->modelMatrix = glm::rotate(wall_frame->modelMatrix, glm::radians(rotation.z), glm::vec3(0.0f, 0.0f, 1.0f));
+        addStatic(wall_frame.get());
+        otherObjects.push_back(std::move(wall_frame));
+    };
+
+    // Wall 1: along -Z axis
+    addWallwall_frame(galleryWidth, wall_frameHeight, wall_frameTopWidth, wall_frameDepth, wall_frameColor, glm::vec3(0.0f, 0.0f, -galleryDepth / 2.0f - wall_frameDepth / 2.0f), glm::vec3(0.0f, 0.0f, 0.0f));
+
+    // Wall 2: along -X axis
+    addWallwall_frame(galleryDepth, wall_frameHeight, wall_frameTopWidth, wall_frameDepth, wall_frameColor, glm::vec3(-galleryWidth / 2.0f - wall_frameDepth / 2.0f, 0.0f, 0.0f), glm::vec3(0.0f, 90.0f, 0.0f));
+
+    // Wall 3: along +X axis
+    addWallwall_frame(galleryDepth, wall_frameHeight, wall_frameTopWidth, wall_frameDepth, wall_frameColor, glm::vec3(galleryWidth / 2.0f + wall_frameDepth / 2.0f, 0.0f, 0.0f), glm::vec3(0.0f, -90.0f, 0.0f));
+
+    // Wall 4: along +Z axis
+    addWallwall_frame(galleryWidth, wall_frameHeight, wall_frameTopWidth, wall_frameDepth, wall_frameColor, glm::vec3(0.0f, 0.0f, galleryDepth / 2.0f + wall_frameDepth / 2.0f), glm::vec3(0.0f, 180.0f, 0.0f));
+
+    // Floor
+    auto floor_obj = std::make_unique<Plane>(galleryWidth, galleryDepth, glm::vec3(1.0f), glm::vec2(5.0f, 6.0f)); // Renamed variable from 'floor' to 'floor_obj'
+    if (floorTexture.ID != 0) floor_obj->setTexture(&floorTexture);
+    floor_obj->isStatic = true;
+    addStatic(floor_obj.get());
+    otherObjects.push_back(std::move(floor_obj));
+
+    // Ceiling
+    auto ceiling = std::make_unique<Plane>(galleryWidth, galleryDepth, glm::vec3(1.0f), glm::vec2(1.0f, 1.0f));
+    ceiling->modelMatrix = glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, galleryHeight, 0.0f));
+    ceiling->modelMatrix = glm::rotate(ceiling->modelMatrix, glm::radians(180.0f), glm::vec3(1.0f, 0.0f, 0.0f));
+    if (wallTexture.ID != 0) ceiling->setTexture(&wallTexture);
+    ceiling->isStatic = true;
+    addStatic(ceiling.get());
+    otherObjects.push_back(std::move(ceiling));
+
+    // Walls (original lambda createWall and its calls)
+    auto createWall = [&](const glm::vec3& position, const glm::vec3& rotation, float width, float height, glm::vec2 texRepeat) {
+        auto wall = std::make_unique<Plane>(width, height, glm::vec3(0.8f), texRepeat);
+        if (wallTexture.ID != 0) wall->setTexture(&wallTexture);
+        wall->isStatic = true;
+        wall->modelMatrix = glm::translate(glm::mat4(1.0f), position);
+        wall->modelMatrix = glm::rotate(wall->modelMatrix, glm::radians(rotation.x), glm::vec3(1.0f, 0.0f, 0.0f));
+        wall->modelMatrix = glm::rotate(wall->modelMatrix, glm::radians(rotation.y), glm::vec3(0.0f, 1.0f, 0.0f));
+        wall->modelMatrix = glm::rotate(wall->modelMatrix, glm::radians(rotation.z), glm::vec3(0.0f, 0.0f, 1.0f));
+        addStatic(wall.get());
+        galleryWalls.push_back(std::move(wall));
+    };
+
+    createWall(glm::vec3(0.0f, galleryHeight / 2.0f, -galleryDepth / 2.0f), glm::vec3(90.0f, 0.0f, 0.0f), galleryWidth, galleryHeight, glm::vec2(1.0f, 1.0f));
+    createWall(glm::vec3(-galleryWidth / 2.0f, galleryHeight / 2.0f, 0.0f), glm::vec3(90.0f, 180.0f, 90.0f), galleryDepth, galleryHeight, glm::vec2(1.0f, 1.0f));
+    createWall(glm::vec3(galleryWidth / 2.0f, galleryHeight / 2.0f, 0.0f), glm::vec3(90.0f, 180.0f, -90.0f), galleryDepth, galleryHeight, glm::vec2(1.0f, 1.0f));
+    createWall(glm::vec3(0.0f, galleryHeight / 2.0f, galleryDepth / 2.0f), glm::vec3(90.0f, 180.0f, 180.0f), galleryWidth, galleryHeight, glm::vec2(1.0f, 1.0f));
+
+    // --- Artworks --- (original lambda addArt and its calls)
+    float artHeightDefault = 1.5f;
+    float artWidthDefault = 1.0f;
+    float artDepthOffset = 0.051f;
+
+    auto addArt = [&](float width, float height, Texture& texture, glm::vec3 translation, const std::vector<std::pair<float, glm::vec3>>& rotations) {
+        auto art = std::make_unique<Plane>(width, height, glm::vec3(1.0f), glm::vec2(1.0f));
+        if (texture.ID != 0) art->setTexture(&texture);
+        art->isStatic = true;
+        glm::mat4 model = glm::translate(glm::mat4(1.0f), translation);
+        for (size_t i = 0; i < rotations.size(); ++i)
+            model = glm::rotate(model, glm::radians(rotations[i].first), rotations[i].second);
+        art->modelMatrix = model;
+        addStatic(art.get());
+        artworks.push_back(std::move(art));
+    };
+
+    addArt(artWidthDefault, artHeightDefault, artTexture1,
+        { -2.0f, artDisplayHeight, -galleryDepth / 2.0f + artDepthOffset },
+        { {90.0f, {1.0f, 0.0f, 0.0f}} });
+
+    addArt(artHeightDefault * 6.5f, artWidthDefault * 3.0f, artTexture2,
+        { -galleryWidth / 2.0f + artDepthOffset, artDisplayHeight + 0.2f, 0.0f },
+        { {90.0f, {1.0f, 0.0f, 0.0f}}, {-90.0f, {0.0f, 0.0f, 1.0f}}, {180.0f, {0.0f, 1.0f, 0.0f}} });
+
+    addArt(artWidthDefault, artHeightDefault, artTexture3,
+        { 0.0f, artDisplayHeight, -galleryDepth / 2.0f + artDepthOffset },
+        { {90.0f, {1.0f, 0.0f, 0.0f}}, {180.0f, {0.0f, 1.0f, 0.0f}} });
+
+    addArt(artWidthDefault * 1.2f, artHeightDefault * 0.8f, artTexture4,
+        { 2.5f, artDisplayHeight, -galleryDepth / 2.0f + artDepthOffset },
+        { {90.0f, {1.0f, 0.0f, 0.0f}}, {180.0f, {0.0f, 1.0f, 0.0f}} });
+
+    addArt(artHeightDefault, artWidthDefault, artTexture5,
+        { galleryWidth / 2.0f - artDepthOffset, artDisplayHeight, 0.0f },
+        { {90.0f, {1.0f, 0.0f, 0.0f}}, {90.0f, {0.0f, 0.0f, 1.0f}}, {180.0f, {0.0f, 1.0f, 0.0f}} });
+
+    addArt(artHeightDefault * 1.2f, artWidthDefault * 1.2f, artTexture6,
+        { galleryWidth / 2.0f - artDepthOffset, artDisplayHeight, -3.0f },
+        { {90.0f, {1.0f, 0.0f, 0.0f}}, {90.0f, {0.0f, 0.0f, 1.0f}}, {180.0f, {0.0f, 1.0f, 0.0f}} });
+
+    addArt(artWidthDefault, artHeightDefault, artTexture7,
+        { -2.0f, artDisplayHeight, galleryDepth / 2.0f - artDepthOffset },
+        { {-90.0f, {1.0f, 0.0f, 0.0f}} });
+
+    addArt(artWidthDefault, artHeightDefault, artTexture8,
+        { 0.0f, artDisplayHeight, galleryDepth / 2.0f - artDepthOffset },
+        { {-90.0f, {1.0f, 0.0f, 0.0f}} });
+
+    addArt(artWidthDefault, artHeightDefault, artTexture9,
+        { 2.0f, artDisplayHeight, galleryDepth / 2.0f - artDepthOffset },
+        { {-90.0f, {1.0f, 0.0f, 0.0f}} });
+
+    addArt(artHeightDefault, artWidthDefault, artTexture11,
+        { galleryWidth / 2.0f - artDepthOffset, artDisplayHeight, 3.0f },
+        { {90.0f, {1.0f, 0.0f, 0.0f}}, {90.0f, {0.0f, 0.0f, 1.0f}}, {180.0f, {0.0f, 1.0f, 0.0f}} });
+
+    // --- 3D Frames for all artworks ---
+    float frameThickness = 0.05f; // Thickness of the frame bars
+    float frameDepth = 0.07f;     // How much the frame protrudes from the wall
+    glm::vec3 frameColor(0.2f, 0.12f, 0.05f); // Fallback color
+
+    // All bars are instances of one unit cube scaled to size (the cube's UVs and axis-aligned
+    // normals do not depend on its dimensions), one instanced draw per texture
+    auto verticalBars = std::make_unique<InstancedShape>(std::make_unique<Cube>(1.0f, 1.0f, 1.0f, frameColor));
+    auto horizontalBars = std::make_unique<InstancedShape>(std::make_unique<Cube>(1.0f, 1.0f, 1.0f, frameColor));
+    if (woodTextureV.ID != 0) verticalBars->setTexture(&woodTextureV);
+    if (woodTextureH.ID != 0) horizontalBars->setTexture(&woodTextureH);
+
+    // Helper: artwork parameters (width, height, translation, rotations, texture)
+    struct ArtFrameParams {
+        float width, height;
+        glm::vec3 translation;
+        std::vector<std::pair<float, glm::vec3>> rotations;
+    };
+    std::vector<ArtFrameParams> artParams = {
+        // artTexture1
+        {artWidthDefault, artHeightDefault, {-2.0f, artDisplayHeight, -galleryDepth / 2.0f + artDepthOffset}, { {90.0f, {1.0f, 0.0f, 0.0f}} }},
+        // artTexture2
+        {artHeightDefault * 6.5f, artWidthDefault * 3.0f, {-galleryWidth / 2.0f + artDepthOffset, artDisplayHeight + 0.2f, 0.0f}, { {90.0f, {1.0f, 0.0f, 0.0f}}, {-90.0f, {0.0f, 0.0f, 1.0f}}, {180.0f, {0.0f, 1.0f, 0.0f}} }},
+        // artTexture3
+        {artWidthDefault, artHeightDefault, {0.0f, artDisplayHeight, -galleryDepth / 2.0f + artDepthOffset}, { {90.0f, {1.0f, 0.0f, 0.0f}}, {180.0f, {0.0f, 1.0f, 0.0f}} }},
+        // artTexture4
+        {artWidthDefault * 1.2f, artHeightDefault * 0.8f, {2.5f, artDisplayHeight, -galleryDepth / 2.0f + artDepthOffset}, { {90.0f, {1.0f, 0.0f, 0.0f}}, {180.0f, {0.0f, 1.0f, 0.0f}} }},
+        // artTexture5
+        {artHeightDefault, artWidthDefault, {galleryWidth / 2.0f - artDepthOffset, artDisplayHeight, 0.0f}, { {90.0f, {1.0f, 0.0f, 0.0f}}, {90.0f, {0.0f, 0.0f, 1.0f}}, {180.0f, {0.0f, 1.0f, 0.0f}} }},
+        // artTexture6
+        {artHeightDefault * 1.2f, artWidthDefault * 1.2f, {galleryWidth / 2.0f - artDepthOffset, artDisplayHeight, -3.0f}, { {90.0f, {1.0f, 0.0f, 0.0f}}, {90.0f, {0.0f, 0.0f, 1.0f}}, {180.0f, {0.0f, 1.0f, 0.0f}} }},
+        // artTexture7
+        {artWidthDefault, artHeightDefault, {-2.0f, artDisplayHeight, galleryDepth / 2.0f - artDepthOffset}, { {-90.0f, {1.0f, 0.0f, 0.0f}} }},
+        // artTexture8
+        {artWidthDefault, artHeightDefault, {0.0f, artDisplayHeight, galleryDepth / 2.0f - artDepthOffset}, { {-90.0f, {1.0f, 0.0f, 0.0f}} }},
+        // artTexture9
+        {artWidthDefault, artHeightDefault, {2.0f, artDisplayHeight, galleryDepth / 2.0f - artDepthOffset}, { {-90.0f, {1.0f, 0.0f, 0.0f}} }},
+        // artTexture11
+        {artHeightDefault, artWidthDefault, {galleryWidth / 2.0f - artDepthOffset, artDisplayHeight, 3.0f}, { {90.0f, {1.0f, 0.0f, 0.0f}}, {90.0f, {0.0f, 0.0f, 1.0f}}, {180.0f, {0.0f, 1.0f, 0.0f}} }},
+    };
+
+    for (size_t idx = 0; idx < artParams.size(); ++idx)
+    {
+        // Skip frame for the largest artwork (index 1)
+        if (idx == 1) continue;
+        const auto& art = artParams[idx];
+        float frameWidth = art.width + 0.10f;
+        float frameHeight = art.height + 0.10f;
+        float halfW = frameWidth / 2.0f;
+        float halfH = frameHeight / 2.0f;
+
+        // Build the base transform: translation + rotations (artwork's local space)
+        glm::vec3 protrudeVec(0.0f);
+        float protrude = frameDepth / 2.0f;
+
+        // Determine protrude direction based on artwork position (wall)
+        if (art.translation.z < -galleryDepth / 4.0f) { protrudeVec = glm::vec3(0, 0, protrude); }
+        else if (art.translation.z > galleryDepth / 4.0f) { protrudeVec = glm::vec3(0, 0, -protrude); }
+        else if (art.translation.x < -galleryWidth / 4.0f) { protrudeVec = glm::vec3(protrude, 0, 0); }
+        else if (art.translation.x > galleryWidth / 4.0f) { protrudeVec = glm::vec3(-protrude, 0, 0); }
+        else { protrudeVec = glm::vec3(0, 0, protrude); }
+
+        glm::mat4 baseModel = glm::translate(glm::mat4(1.0f), art.translation + protrudeVec);
+        for (const auto& rot : art.rotations) baseModel = glm::rotate(baseModel, glm::radians(rot.first), rot.second);
+        baseModel = glm::rotate(baseModel, glm::radians(90.0f), glm::vec3(1.0f, 0.0f, 0.0f));
+
+        // Vertical bars (left and right)
+        for (int i = 0; i < 2; ++i) {
+            float xOffset = (halfW - frameThickness / 2.0f) * (i == 0 ? 1.0f : -1.0f);
+            glm::mat4 model = baseModel * glm::translate(glm::mat4(1.0f), glm::vec3(xOffset, 0.0f, 0.0f));
+            model = glm::scale(model, glm::vec3(frameThickness, frameHeight, frameDepth));
+            verticalBars->addInstance(model);
+        }
+
+        // Horizontal bars (top and bottom)
+        float horizontalBarLength = frameWidth - 2 * frameThickness;
+        for (int i = 0; i < 2; ++i) {
+            float yOffset = (halfH - frameThickness / 2.0f) * (i == 0 ? 1.0f : -1.0f);
+            glm::mat4 model = baseModel * glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, yOffset, 0.0f));
+            model = glm::scale(model, glm::vec3(horizontalBarLength, frameThickness, frameDepth));
+            horizontalBars->addInstance(model);
+        }
+    }
+    addStatic(verticalBars.get());
+    addStatic(horizontalBars.get());
+    instancedObjects.push_back(std::move(verticalBars));
+    instancedObjects.push_back(std::move(horizontalBars));
+
+    // --- Sculpture --- (original code)
+    auto pedestal = LodShape::createCylinder(0.3f, 0.3f, 1.0f, 24, 1, true, glm::vec3(0.4f));
+    if (metalTexture.ID != 0) pedestal->setTexture(&metalTexture);
+    pedestal->modelMatrix = glm::translate(glm::mat4(1.0f), glm::vec3(1.5f, 0.5f, -1.0f));
+    sceneBuilder.add(pedestal.get());
+    lodObjects.push_back(std::move(pedestal));
+
+    glm::vec3 sculptureBasePosition = glm::vec3(1.5f, 1.0f + 0.4f + 0.05f, -1.0f);
+    auto sculpture_temp = LodShape::createSphere(0.4f, 32, 16, glm::vec3(0.7f, 0.1f, 0.1f));
+    LodShape* sculpturePtr = sculpture_temp.get();
+    if (WorldTexture.ID != 0) sculpturePtr->setTexture(&WorldTexture);
+    sculpturePtr->modelMatrix = glm::translate(glm::mat4(1.0f), sculptureBasePosition);
+    sculpturePtr->modelMatrix = glm::rotate(glm::mat4(sculpturePtr->modelMatrix), glm::radians(-90.0f), glm::vec3(0.0, 0.0, 1.0));
+    sceneBuilder.add(sculpturePtr);
+    lodObjects.push_back(std::move(sculpture_temp));
+
+    glm::vec3 pedestal2Position = glm::vec3(-2.5f, 0.5f, -1.5f); // New position for the second pedestal
+    auto pedestal2 = LodShape::createCylinder(0.3f, 0.3f, 1.0f, 24, 1, true, glm::vec3(0.3f, 0.3f, 0.35f)); // Different pedestal color
+    if (metalTexture.ID != 0) pedestal2->setTexture(&metalTexture); // You can use the same or a different texture
+    pedestal2->modelMatrix = glm::translate(glm::mat4(1.0f), pedestal2Position);
+    sceneBuilder.add(pedestal2.get());
+    lodObjects.push_back(std::move(pedestal2));
+
+    glm::vec3 pyramidPosition = glm::vec3(pedestal2Position.x, pedestal2Position.y + 0.5f + 0.4f, pedestal2Position.z); // On the pedestal (pedestal height 1.0/2 + pyramid height 0.8/2)
+    auto pyramidSculpture = std::make_unique<Pyramid>(glm::vec3(0.7f, 0.2f, 0.2f), glm::vec3(0.9f, 0.5f, 0.5f)); // Pyramid colors
+
+    if (artTexture10.ID != 0) pyramidSculpture->setTexture(&artTexture10);
+    sceneBuilder.add(pyramidSculpture.get());
+    Pyramid* pyramidPtr = pyramidSculpture.get();
+    // Store a pointer to the pyramid
+    otherObjects.push_back(std::move(pyramidSculpture));
+
+    // --- Light Source (using PointLightData from light.h for a single light) ---
+    PointLightData mainLight( // Name changed from pointLight to mainLight for clarity
+        glm::vec3(0.0f, galleryHeight - 0.1f, 0.0f), // Initial position
+        glm::vec4(0.9f, 0.9f, 0.8f, 1.0f)           // Color
+    );
+    // mainLight.visualRepresentation is created in the PointLightData constructor
+
+    // --- Build all meshes: generation on the worker threads, uploads here ---
+    sceneBuilder.build();
+    std::cout << "Scene build: " << sceneBuilder.getShapeCount() << " shapes, " << sceneBuilder.getGeneratedCount()
+              << " meshes generated on " << threadPool.getThreadCount() + 1 << " threads in " << sceneBuilder.getGenerateMilliseconds()
+              << " ms, uploaded in " << sceneBuilder.getUploadMilliseconds() << " ms" << std::endl;
+    std::cout << "Mesh files: " << MeshFile::getLoadedCount() << " loaded, " << MeshFile::getWrittenCount() << " written" << std::endl;
+
+    // Identical props (frame bars, etc.) share one uploaded mesh
+    std::cout << "Mesh cache: " << MeshCache::instance().getLiveMeshCount() << " unique meshes, "
+              << MeshCache::instance().getHitCount() << " shapes reused an existing mesh" << std::endl;
+    // Vertex cache efficiency of the generated meshes (transformed vertices per triangle, lower is better)
+    std::cout << "Mesh optimizer: " << MeshOptimizer::getMeshCount() << " meshes, ACMR "
+              << MeshOptimizer::getTotalACMRBefore() << " -> " << MeshOptimizer::getTotalACMRAfter() << std::endl;
+
+    // --- Static batching: walls, floor, ceiling, baseboards, artworks and frames never move ---
+    StaticBatcher staticBatcher(&geometryArena, vertexFormat);
+    if (useStaticBatching) {
+        for (const auto& wall : galleryWalls) staticBatcher.add(wall.get());
+        for (const auto& art : artworks) staticBatcher.add(art.get());
+        for (const auto& obj : otherObjects) staticBatcher.add(obj.get()); // Only the ones marked isStatic
+        for (const auto& instanced : instancedObjects) staticBatcher.add(instanced.get());
+        staticBatcher.build();
+        std::cout << "Static batching: " << staticBatcher.getItemCount() << " pieces in "
+                  << staticBatcher.getBatches().size() << " batches" << std::endl;
+    }
+
+    // --- Scene BVH over the individually drawn objects: shapes first, then the LOD objects ---
+    // Built once; the animated sculpture and pyramid are refitted every frame.
+    std::vector<Shape*> sceneShapes;
+    if (!useStaticBatching) {
+        for (const auto& wall : galleryWalls) sceneShapes.push_back(wall.get());
+        for (const auto& art : artworks) sceneShapes.push_back(art.get());
+    }
+    for (const auto& obj : otherObjects) {
+        if (useStaticBatching && obj->isStatic) continue; // Part of a batch
+        sceneShapes.push_back(obj.get());
+    }
+    std::vector<LodShape*> sceneLods;
+    for (const auto& lod : lodObjects) sceneLods.push_back(lod.get());
+
+    auto sceneObjectBox = [&](uint32_t object) {
+        return object < sceneShapes.size() ? sceneShapes[object]->getWorldBounds().box
+                                           : sceneLods[object - sceneShapes.size()]->getWorldBounds().box;
+    };
+    std::vector<BoundingBox> sceneBoxes;
+    for (uint32_t object = 0; object < sceneShapes.size() + sceneLods.size(); ++object) sceneBoxes.push_back(sceneObjectBox(object));
+    Bvh sceneBvh;
+    sceneBvh.build(sceneBoxes);
+
+    std::vector<uint32_t> movingObjects; // Refitted every frame
+    for (uint32_t object = 0; object < sceneShapes.size(); ++object) {
+        if (sceneShapes[object] == pyramidPtr) movingObjects.push_back(object);
+    }
+    for (uint32_t i = 0; i < sceneLods.size(); ++i) {
+        if (sceneLods[i] == sculpturePtr) movingObjects.push_back((uint32_t)(sceneShapes.size() + i));
+    }
+    std::vector<uint32_t> visibleObjects;
+    OcclusionQueries occlusionQueries(sceneBvh.getObjectCount()); // Indexed like the BVH objects
+
+    // --- Frustum culling of the static batch pieces (never move: boxes added once) ---
+    FrustumCuller batchCuller;
+    std::vector<StaticBatchItem*> batchItems;
+    for (StaticBatch& batch : staticBatcher.getBatches()) {
+        for (StaticBatchItem& item : batch.items) {
+            batchItems.push_back(&item);
+            batchCuller.add(item.bounds);
+        }
+    }
+
+    // --- Occluders: the walls, floor and ceiling fill their (flat) boxes completely ---
+    OcclusionCuller occlusionCuller(256, 144, &threadPool);
+    for (const auto& wall : galleryWalls) occlusionCuller.addOccluder(*wall);
+    for (const auto& obj : otherObjects) {
+        if (dynamic_cast<Plane*>(obj.get())) occlusionCuller.addOccluder(*obj);
+    }
+
+    // --- Cells and portals: the gallery is a single room (more rooms: addCell() each, joined with addDoor()) ---
+    PortalSystem portalSystem;
+    BoundingBox galleryRoom;
+    galleryRoom.expand(glm::vec3(-galleryWidth / 2.0f - wall_frameDepth, 0.0f, -galleryDepth / 2.0f - wall_frameDepth));
+    galleryRoom.expand(glm::vec3(galleryWidth / 2.0f + wall_frameDepth, galleryHeight, galleryDepth / 2.0f + wall_frameDepth));
+    int galleryCell = portalSystem.addCell(galleryRoom);
+    for (const auto& wall : galleryWalls) portalSystem.addShape(galleryCell, wall.get());
+    for (const auto& art : artworks) portalSystem.addShape(galleryCell, art.get());
+    for (const auto& obj : otherObjects) portalSystem.addShape(galleryCell, obj.get());
+    for (const auto& lod : lodObjects) {
+        for (int level = 0; level < lod->getLevelCount(); ++level) portalSystem.addShape(galleryCell, lod->getLevel(level));
+    }
+
+    // --- Picking: the object at the screen centre is looked up on the actual triangles every frame ---
+    Scene pickScene;
+    for (const auto& wall : galleryWalls) pickScene.add(wall.get());
+    for (const auto& art : artworks) pickScene.add(art.get());
+    for (const auto& obj : otherObjects) pickScene.add(obj.get());
+    for (const auto& lod : lodObjects) pickScene.add(lod.get());
+    pickScene.build();
+
+    // --- Camera collision: the camera slides along static geometry instead of flying through it ---
+    // The animated pyramid (not isStatic) is left out; the sculpture only spins in place, so it stays in
+    CollisionWorld collisionWorld;
+    if (useCameraCollision) {
+        for (const auto& wall : galleryWalls) collisionWorld.add(wall.get());
+        for (const auto& art : artworks) collisionWorld.add(art.get());
+        for (const auto& obj : otherObjects) {
+            if (obj->isStatic) collisionWorld.add(obj.get());
+        }
+        for (const auto& lod : lodObjects) collisionWorld.add(lod.get());
+        collisionWorld.build();
+        camera.collision = &collisionWorld;
+    }
+
+    // Window title: visited cells and the object looked at, updated when one of them changes
+    size_t shownVisitedCells = 0;
+    const Shape* shownPick = nullptr;
+    auto updateWindowTitle = [&]() {
+        std::string title = "Art Gallery - Single Light (Multi-Light Shader)";
+        if (usePortalCulling) title += " - cells visited: " + std::to_string(shownVisitedCells);
+        if (shownPick) {
+            static const char* typeNames[] = { "cube", "sphere", "plane", "cylinder", "pyramid", "light", "object" };
+            std::string name = typeNames[shownPick->Type];
+            for (size_t i = 0; i < artworks.size(); ++i) {
+                if (artworks[i].get() == shownPick) name = "artwork " + std::to_string(i + 1);
+            }
+            for (const auto& wall : galleryWalls) {
+                if (wall.get() == shownPick) name = "wall";
+            }
+            title += " - looking at: " + name;
+        }
+        glfwSetWindowTitle(window, title.c_str());
+    };
+
+    // Visible objects are drawn through a queue sorted by shader, face culling, texture and VAO, front to back
+    RenderQueue renderQueue;
+    const float farPlane = 100.0f;
+    // Camera and lights for all shaders, uploaded once per frame into a ring of uniform buffer regions
+    FrameUniforms frameUniforms;
+    FrameDataBlock frameData;
+    LightDataBlock lightData;
+
+    // --- Render Loop ---
+    while (!glfwWindowShouldClose(window)) {
+        float currentFrame = static_cast<float>(glfwGetTime());
+
+        camera.Inputs(window);
+        camera.updateMatrix(45.0f, 0.1f, farPlane);
+
+        // Animate light
+        mainLight.position.x = sin(currentFrame * 0.3f) * 3.0f;
+        mainLight.position.z = cos(currentFrame * 0.3f) * 3.0f;
+        // Update model matrix for light visualization
+
+
+        // Animate sculpture
+        if (sculpturePtr) {
+            glm::mat4 initialTranslation = glm::translate(glm::mat4(1.0f), sculptureBasePosition);
+            float rotationSpeed = 1.5f;
+            glm::mat4 rotationMatrix = glm::rotate(glm::mat4(1.0f), rotationSpeed * currentFrame, glm::vec3(0.0f, 1.0f, 0.0f));
+            sculpturePtr->modelMatrix = initialTranslation * rotationMatrix;
+        }
+        if (mainLight.visualRepresentation) {
+            mainLight.visualRepresentation->modelMatrix = glm::translate(glm::mat4(1.0f), mainLight.position);
+        }
+
+        if (pyramidPtr) {
+            glm::mat4 scaleMat = glm::scale(glm::mat4(1.0f), glm::vec3(globalScale));
+            glm::mat4 initialOrientationMat = glm::rotate(glm::mat4(1.0f), glm::radians(12.0f), glm::vec3(1.0f, 1.0f, 1.0f)); // Static initial orientation
+
+            // Pyramid's own rotation (around its local Y axis, after initialOrientationMat)
+            float spinSpeed = 2.5f;
+            glm::mat4 spinRotation = glm::rotate(glm::mat4(1.0f), spinSpeed * currentFrame, glm::vec3(0.0f, 1.0f, 0.0f));
+
+            // Precession rotation - the entire system (already rotating pyramid) rotates around the global Y axis
+            float precessionSpeed = 0.5f;
+            glm::mat4 precessionRotation = glm::rotate(glm::mat4(1.0f), precessionSpeed * currentFrame, glm::vec3(0.0f, 1.0f, 0.0f));
+
+            glm::mat4 translationMat = glm::translate(glm::mat4(1.0f), pyramidPosition);
+
+            // Order: T * R_precession * R_own_rotation * R_initial_orientation * S
+            pyramidPtr->modelMatrix = translationMat * precessionRotation * spinRotation * initialOrientationMat * scaleMat;
+        }
+
+        glClearColor(0.05f, 0.86f, 0.86f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+        // --- Per-frame uniform blocks, read by every shader ---
+        frameData.camMatrix = camera.cameraMatrix;
+        frameData.camPos = camera.Position;
+        // Send the data of ONE light as the first in the shader's array
+        lightData.numActiveLights = 1; // Only one active light
+        lightData.pointLights[0].position = mainLight.position;
+        lightData.pointLights[0].color = mainLight.color;
+        frameUniforms.update(frameData, lightData);
+
+        // --- Frustum culling: visible scene objects from the BVH, visible batch pieces from the SoA culler ---
+        for (uint32_t object : movingObjects) sceneBvh.update(object, sceneObjectBox(object));
+        visibleObjects.clear();
+        if (useFrustumCulling) {
+            Frustum frustum = Frustum::fromMatrix(camera.cameraMatrix);
+            sceneBvh.queryFrustum(frustum, visibleObjects);
+            for (StaticBatchItem* item : batchItems) item->visible = false;
+            for (uint32_t index : batchCuller.cull(frustum)) batchItems[index]->visible = true;
+        } else {
+            for (uint32_t object = 0; object < sceneBvh.getObjectCount(); ++object) visibleObjects.push_back(object);
+        }
+
+        // --- Portal culling: objects in rooms not reachable through the doors seen from the camera's room ---
+        if (usePortalCulling) {
+            portalSystem.update(camera.Position, camera.cameraMatrix);
+            size_t kept = 0;
+            for (uint32_t object : visibleObjects) {
+                const Shape* shape = object < sceneShapes.size() ? sceneShapes[object] : sceneLods[object - sceneShapes.size()]->getLevel(0);
+                if (portalSystem.isVisible(shape, sceneBvh.getObjectBox(object))) visibleObjects[kept++] = object;
+            }
+            visibleObjects.resize(kept);
+            for (StaticBatchItem* item : batchItems) {
+                if (item->visible && !item->instanced) item->visible = portalSystem.isVisible(item->shape, item->bounds);
+            }
+            if (portalSystem.getVisitedCellCount() != shownVisitedCells) {
+                shownVisitedCells = portalSystem.getVisitedCellCount();
+                updateWindowTitle();
+            }
+        }
+
+        // --- Picking along the view direction (the sculpture and pyramid move, so refit first) ---
+        pickScene.update();
+        RayHit gaze = pickScene.raycast(camera.Position, camera.Orientation);
+        if (gaze.shape != shownPick) {
+            shownPick = gaze.shape;
+            updateWindowTitle();
+        }
+
+        // --- Occlusion culling: drop what is completely behind the occluders in the low-resolution depth buffer ---
+        if (useOcclusionCulling) {
+            occlusionCuller.render(camera.cameraMatrix);
+            size_t kept = 0;
+            for (uint32_t object : visibleObjects) {
+                if (occlusionCuller.isVisible(sceneBvh.getObjectBox(object))) visibleObjects[kept++] = object;
+            }
+            visibleObjects.resize(kept);
+            for (StaticBatchItem* item : batchItems) {
+                if (item->visible) item->visible = occlusionCuller.isVisible(item->bounds);
+            }
+        }
+
+        // --- Draw Gallery Objects ---
+        if (useStaticBatching) {
+            staticBatcher.draw(objectShader); // One draw call per texture, split around culled pieces
+        }
+        // --- GPU occlusion queries: boxes of the objects tested against the depth of the batches drawn so far ---
+        if (useOcclusionQueries) {
+            occlusionQueries.beginFrame(camera.Position);
+            lightSourceShader.Activate(); // Position-only
+            occlusionQueries.beginQueries(lightSourceShader);
+            for (uint32_t object : visibleObjects) occlusionQueries.query(object, sceneBvh.getObjectBox(object));
+            occlusionQueries.endQueries();
+            objectShader.Activate();
+        }
+        // --- Visible objects and the light visual, sorted to skip redundant state changes ---
+        renderQueue.begin(camera.Position, camera.Orientation, farPlane);
+        for (uint32_t object : visibleObjects) {
+            // LOD objects: coarser levels further away, nullptr when too small to see
+            Shape* shape = object < sceneShapes.size() ? sceneShapes[object] : sceneLods[object - sceneShapes.size()]->select(camera);
+            if (shape) renderQueue.submit(*shape, objectShader, RenderPass::Opaque, object);
+        }
+        if (mainLight.visualRepresentation) renderQueue.submit(*mainLight.visualRepresentation, lightSourceShader);
+        // The queue only sets "model": the light shader's colour goes in first
+        lightSourceShader.Activate();
+        lightSourceShader.set(Uniforms::lightColor, mainLight.color);
+        renderQueue.sort();
+        if (useOcclusionQueries) {
+            // Skipped by the GPU if the object's box was hidden
+            renderQueue.execute([&](uint32_t object) { if (object != RenderQueue::noTag) occlusionQueries.beginConditionalRender(object); },
+                                [&](uint32_t object) { if (object != RenderQueue::noTag) occlusionQueries.endConditionalRender(object); });
+        } else {
+            renderQueue.execute();
+        }
+
+        // --- Draw Instanced Objects (art frames, batched together with the static geometry if enabled) ---
+        if (!useStaticBatching) {
+            for (const auto& instanced : instancedObjects) instanced->draw(instancedShader);
+        }
+        // The frame's draws are issued: its uniform region may be reused once the GPU is past this point
+        frameUniforms.endFrame();
+
+        camera.printData();
+
+        glfwSwapBuffers(window);
+        glfwPollEvents();
+    }
+
+    size_t stateCalls = GLStateCache::getIssuedCount() + GLStateCache::getFilteredCount();
+    std::cout << "GL state cache: " << GLStateCache::getFilteredCount() << " of " << stateCalls
+              << " bind/state calls filtered as redundant" << std::endl;
+    std::cout << "Frame uniforms: waited for the GPU " << frameUniforms.getWaitCount() << " times" << std::endl;
+
+    // --- Cleanup ---
+    galleryWalls.clear();
+    artworks.clear();
+    otherObjects.clear();
+    instancedObjects.clear();
+    lodObjects.clear();
+    // mainLight.visualRepresentation will be automatically released by unique_ptr
+
+    floorTexture.Delete();
+    wallTexture.Delete();
+    metalTexture.Delete();
+    WorldTexture.Delete();
+
+    artTexture1.Delete(); artTexture2.Delete(); artTexture3.Delete();
+    artTexture4.Delete(); artTexture5.Delete(); artTexture6.Delete();
+    artTexture7.Delete(); artTexture8.Delete(); artTexture9.Delete();
+
+    objectShader.Delete();
+    lightSourceShader.Delete();
+    instancedShader.Delete();
+    occlusionQueries.Delete();
+    frameUniforms.Delete();
+
+    // Remaining meshes (light visualization) only release their range, which needs no GL context
+    geometryArena.Delete();
+
+    glfwDestroyWindow(window);
+    glfwTerminate();
+
+    return 0;
+}
@@ -0,0 +1,255 @@
+#include "mesh.h"
+#include <cstddef> // For offsetof
+#include <algorithm>
+#include <iostream>
+#include <glm/gtc/type_ptr.hpp>
+
+Mesh::Mesh(std::vector<GLfloat>& vertices, std::vector<GLuint>& indices, VertexFormat format, GeometryArena* arena)
+    : arena(arena) {
+    MeshData data;
+    std::vector<PackedVertex> packed;
+    std::vector<GLushort> shortIndices;
+    encode(vertices, indices, arena ? arena->getFormat() : format, data, packed, shortIndices);
+    data.bounds = Bounds::fromVertices(vertices);
+    upload(data);
+}
+
+Mesh::Mesh(const MeshData& data, GeometryArena* arena)
+    : arena(arena) {
+    if (arena && arena->getFormat() != data.format) {
+        std::cerr << "Error: Mesh data does not match the GeometryArena's vertex format, using separate buffers." << std::endl;
+        this->arena = nullptr;
+    }
+    upload(data);
+}
+
+void Mesh::encode(const std::vector<GLfloat>& vertices, const std::vector<GLuint>& indices, VertexFormat format,
+                  MeshData& data, std::vector<PackedVertex>& packedStorage, std::vector<GLushort>& shortIndexStorage) {
+    data.format = format;
+    data.vertexCount = vertices.size() / 11;
+    data.indexCount = static_cast<GLsizei>(indices.size());
+
+    // Quantize to the packed layout (the float layout is uploaded as is)
+    data.dequant = MeshDequant();
+    data.vertexData = vertices.data();
+    if (format == VertexFormat::Packed) {
+        packVertices(vertices, packedStorage, data.dequant);
+        data.vertexData = packedStorage.data();
+    }
+
+    // 16-bit indices, unless a triangle spans more than 65536 vertices
+    if (buildShortIndices(indices, shortIndexStorage, data.chunks)) {
+        data.indexType = GL_UNSIGNED_SHORT;
+        data.indexData = shortIndexStorage.data();
+        data.indexBytes = shortIndexStorage.size() * sizeof(GLushort);
+    } else {
+        data.indexType = GL_UNSIGNED_INT;
+        data.indexData = indices.data();
+        data.indexBytes = indices.size() * sizeof(GLuint);
+        data.chunks.assign(1, IndexChunk{ 0, 0, data.indexCount });
+    }
+}
+
+void Mesh::upload(const MeshData& data) {
+    format = data.format;
+    bounds = data.bounds;
+    dequant = data.dequant;
+    indexCount = data.indexCount;
+    indexType = data.indexType;
+    chunks = data.chunks;
+
+    if (arena) {
+        // Sub-allocate in the shared buffers, no new GL objects
+        arenaRange = arena->allocate(data.vertexData, data.vertexCount, data.indexData, data.indexBytes);
+        return;
+    }
+
+    vao_ptr = std::make_unique<VAO>();
+    vao_ptr->Bind();
+    vbo_ptr = std::make_unique<VBO>(data.vertexData, data.vertexCount * getVertexStride(format));
+    ebo_ptr = std::make_unique<EBO>(data.indexData, data.indexBytes);
+    linkLayout(*vao_ptr, *vbo_ptr, *ebo_ptr, format);
+}
+
+Mesh::Mesh(size_t vertexCount, size_t indexCount, const std::function<void(GeometryWriter&)>& write, GeometryArena* arena)
+    : arena(arena) {
+    if (arena && arena->getFormat() != VertexFormat::Float) {
+        // Vertices have to be packed first: generate into CPU-side arrays and upload those
+        std::vector<GLfloat> vertices(vertexCount * 11);
+        std::vector<GLuint> indices(indexCount);
+        GeometryWriter writer(vertices.data(), vertexCount, indices.data(), indexCount);
+        write(writer);
+        if (!writer.isComplete() || writer.hasOverflowed()) std::cerr << "Error: Generated geometry does not match the reported counts." << std::endl;
+        MeshData data;
+        std::vector<PackedVertex> packed;
+        std::vector<GLushort> shortIndices;
+        encode(vertices, indices, arena->getFormat(), data, packed, shortIndices);
+        data.bounds = writer.getBounds();
+        upload(data);
+        return;
+    }
+    this->indexCount = static_cast<GLsizei>(indexCount);
+    // Counts are known up front, so the index size can be chosen before writing (no chunking needed)
+    bool shortIndices = vertexCount <= 65536;
+    indexType = shortIndices ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+    size_t indexBytes = indexCount * (shortIndices ? sizeof(GLushort) : sizeof(GLuint));
+    size_t vertexBytes = vertexCount * getVertexStride(format);
+    chunks.assign(1, IndexChunk{ 0, 0, this->indexCount });
+
+    void* vertexDst = nullptr;
+    void* indexDst = nullptr;
+    if (arena) {
+        arenaRange = arena->reserve(vertexCount, indexBytes);
+        arena->mapRange(arenaRange, vertexDst, indexDst);
+    } else {
+        vao_ptr = std::make_unique<VAO>();
+        vao_ptr->Bind();
+        vbo_ptr = std::make_unique<VBO>(nullptr, vertexBytes);
+        ebo_ptr = std::make_unique<EBO>(nullptr, indexBytes); // Stays bound to the VAO
+        vertexDst = glMapBufferRange(GL_ARRAY_BUFFER, 0, vertexBytes, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+        indexDst = glMapBufferRange(GL_ELEMENT_ARRAY_BUFFER, 0, indexBytes, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+    }
+
+    if (vertexDst && indexDst) {
+        if (shortIndices) {
+            GeometryWriter writer((GLfloat*)vertexDst, vertexCount, (GLushort*)indexDst, indexCount);
+            write(writer);
+            bounds = writer.getBounds();
+            if (!writer.isComplete() || writer.hasOverflowed()) std::cerr << "Error: Generated geometry does not match the reported counts." << std::endl;
+        } else {
+            GeometryWriter writer((GLfloat*)vertexDst, vertexCount, (GLuint*)indexDst, indexCount);
+            write(writer);
+            bounds = writer.getBounds();
+            if (!writer.isComplete() || writer.hasOverflowed()) std::cerr << "Error: Generated geometry does not match the reported counts." << std::endl;
+        }
+    } else {
+        std::cerr << "Error: Could not map buffers for direct mesh generation." << std::endl;
+    }
+
+    if (arena) {
+        arena->unmapRange();
+        return;
+    }
+    // Unmapping can fail if the buffer memory was lost meanwhile (contents undefined)
+    bool vertexUnmapped = vertexDst && glUnmapBuffer(GL_ARRAY_BUFFER) == GL_TRUE;
+    bool indexUnmapped = indexDst && glUnmapBuffer(GL_ELEMENT_ARRAY_BUFFER) == GL_TRUE;
+    if (!vertexUnmapped || !indexUnmapped) {
+        std::cerr << "Error: Buffer contents lost while generating a mesh." << std::endl;
+    }
+    linkLayout(*vao_ptr, *vbo_ptr, *ebo_ptr, format);
+}
+
+void Mesh::linkLayout(VAO& vao, VBO& vbo, EBO& ebo, VertexFormat format) {
+    GLsizei stride = getVertexStride(format);
+    vao.Bind();
+    // The element buffer binding is part of the VAO state
+    ebo.Bind();
+
+    // Layouts 0-3: position, color, texture coordinates, normal (see getVertexAttributes)
+    for (const VertexAttribute& attribute : getVertexAttributes(format)) {
+        vao.LinkAttrib(vbo, attribute.location, attribute.components, attribute.type, stride,
+            (void*)(size_t)attribute.offset, (GLboolean)attribute.normalized);
+    }
+
+    vao.Unbind();
+}
+
+void Mesh::linkAttributes(VAO& target) {
+    if (arena) {
+        arena->linkAttributes(target);
+        return;
+    }
+    linkLayout(target, *vbo_ptr, *ebo_ptr, format);
+}
+
+bool Mesh::buildShortIndices(const std::vector<GLuint>& indices, std::vector<GLushort>& shortIndices, std::vector<IndexChunk>& chunks) {
+    const GLuint windowSize = 65536;
+    shortIndices.resize(indices.size());
+    chunks.clear();
+
+    // Triangles are kept whole and in order. A new chunk starts when a triangle does not fit
+    // into the current window [baseVertex, baseVertex + 65535]. Meshes reordered by
+    // MeshOptimizer reference vertices roughly in order, so the windows slide along.
+    GLuint base = 0;
+    bool first = true;
+    for (size_t t = 0; t + 2 < indices.size(); t += 3) {
+        GLuint low = std::min(indices[t], std::min(indices[t + 1], indices[t + 2]));
+        GLuint high = std::max(indices[t], std::max(indices[t + 1], indices[t + 2]));
+        if (high - low >= windowSize) return false;
+
+        if (first || low < base || high - base >= windowSize) {
+            base = low;
+            chunks.push_back(IndexChunk{ (GLint)base, t * sizeof(GLushort), 0 });
+            first = false;
+        }
+        for (int k = 0; k < 3; ++k) shortIndices[t + k] = (GLushort)(indices[t + k] - base);
+        chunks.back().indexCount += 3;
+    }
+    return true;
+}
+
+void Mesh::applyDequant(Shader& shader) const {
+    if (format != VertexFormat::Packed) return;
+    const DrawUniforms& uniforms = shader.getDrawUniforms();
+    shader.set(uniforms.meshPosOffset, dequant.posOffset);
+    shader.set(uniforms.meshPosScale, dequant.posScale);
+    shader.set(uniforms.meshUvTransform, dequant.uvTransform);
+}
+
+unsigned int Mesh::getBufferVersion() const {
+    return arena ? arena->getBufferVersion() : 0;
+}
+
+Mesh::~Mesh() {
+    // Called when the last Shape using this mesh releases it
+    if (arena) {
+        arena->release(arenaRange);
+        return;
+    }
+    if (vbo_ptr) vbo_ptr->Delete();
+    if (ebo_ptr) ebo_ptr->Delete();
+    if (vao_ptr) vao_ptr->Delete();
+}
+
+void Mesh::draw() {
+    bindVertexArray();
+    drawBound();
+}
+
+void Mesh::bindVertexArray() {
+    if (arena) arena->Bind();
+    else vao_ptr->Bind();
+}
+
+void Mesh::drawBound() {
+    for (const IndexChunk& chunk : chunks) {
+        glDrawElementsBaseVertex(GL_TRIANGLES, chunk.indexCount, indexType,
+            (void*)(getIndexOffset() + chunk.byteOffset), getBaseVertex() + chunk.baseVertex);
+    }
+}
+
+size_t Mesh::drawRange(size_t firstIndex, GLsizei count) {
+    bindVertexArray();
+
+    size_t indexSize = indexType == GL_UNSIGNED_SHORT ? sizeof(GLushort) : sizeof(GLuint);
+    size_t end = firstIndex + count;
+    size_t drawCalls = 0;
+    for (const IndexChunk& chunk : chunks) {
+        // Overlap of the requested range with this chunk
+        size_t chunkFirst = chunk.byteOffset / indexSize;
+        size_t first = std::max(firstIndex, chunkFirst);
+        size_t last = std::min(end, chunkFirst + chunk.indexCount);
+        if (first >= last) continue;
+        glDrawElementsBaseVertex(GL_TRIANGLES, (GLsizei)(last - first), indexType,
+            (void*)(getIndexOffset() + first * indexSize), getBaseVertex() + chunk.baseVertex);
+        drawCalls++;
+    }
+    return drawCalls;
+}
+
+void Mesh::drawInstanced(GLsizei instanceCount) {
+    for (const IndexChunk& chunk : chunks) {
+        glDrawElementsInstancedBaseVertex(GL_TRIANGLES, chunk.indexCount, indexType,
+            (void*)(getIndexOffset() + chunk.byteOffset), instanceCount, getBaseVertex() + chunk.baseVertex);
+    }
+}
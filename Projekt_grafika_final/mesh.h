@@ -0,0 +1,135 @@
+#ifndef MESH_H
+#define MESH_H
+
+#include <vector>
+#include <memory> // For std::unique_ptr
+#include <functional>
+#include <glad/glad.h>
+#include "VAO.h"
+#include "VBO.h"
+#include "EBO.h"
+#include "geometryArena.h"
+#include "vertexFormat.h"
+#include "shaderClass.h"
+#include "geometryWriter.h"
+#include "bounds.h"
+
+// Part of a mesh's index buffer drawn with its own base vertex.
+// 16-bit meshes with more than 65536 vertices are split into chunks whose indices
+// each fit into a 65536-vertex window; 32-bit meshes always have a single chunk.
+struct IndexChunk {
+    GLint baseVertex = 0;  // Added to every index of the chunk (relative to the mesh's first vertex)
+    size_t byteOffset = 0; // Offset of the chunk's first index (relative to the mesh's index data)
+    GLsizei indexCount = 0;
+};
+
+// GPU-ready geometry: vertices already in their GPU format, indices in their final type, and the chunk table.
+// Filled by Mesh::encode() (pointing into caller-owned storage) or by MeshFile (pointing into a file mapping),
+// and uploaded as is by Mesh(const MeshData&).
+struct MeshData {
+    VertexFormat format = VertexFormat::Float;
+    MeshDequant dequant;
+    Bounds bounds; // Object-space box and sphere (set by the caller of encode(), e.g. from GeometryWriter::getBounds())
+
+    const void* vertexData = nullptr;
+    size_t vertexCount = 0;
+
+    GLenum indexType = GL_UNSIGNED_INT;
+    const void* indexData = nullptr;
+    size_t indexBytes = 0;
+    GLsizei indexCount = 0;
+    std::vector<IndexChunk> chunks;
+};
+
+// GPU-side copy of a shape's geometry.
+// Either owns its own VAO + VBO + EBO, or lives as a sub-allocation inside a GeometryArena.
+// A Mesh is shared between all Shape instances with identical geometry
+// through std::shared_ptr, so the GL objects are released together with the last user.
+class Mesh {
+public:
+    // Own buffers (only used when no arena is given)
+    std::unique_ptr<VAO> vao_ptr;
+    std::unique_ptr<VBO> vbo_ptr;
+    std::unique_ptr<EBO> ebo_ptr;
+    GLsizei indexCount = 0;
+    // GL_UNSIGNED_SHORT whenever possible (half the index memory and fetch bandwidth), otherwise GL_UNSIGNED_INT
+    GLenum indexType = GL_UNSIGNED_INT;
+    std::vector<IndexChunk> chunks;
+
+    // Object-space bounds of the vertices
+    Bounds bounds;
+
+    // GPU vertex layout and the values the shader needs to decode it
+    VertexFormat format = VertexFormat::Float;
+    MeshDequant dequant;
+
+    // Arena sub-allocation (only used when an arena is given)
+    GeometryArena* arena = nullptr;
+    ArenaRange* arenaRange = nullptr;
+
+    // Uploads the interleaved 11-float vertex data and the indices, into the arena if one is given
+    // (in the arena's vertex format), otherwise into new buffers of its own in the given format
+    Mesh(std::vector<GLfloat>& vertices, std::vector<GLuint>& indices, VertexFormat format = VertexFormat::Float, GeometryArena* arena = nullptr);
+    // Uploads already encoded data (see encode()), into the arena if one is given and its format matches
+    Mesh(const MeshData& data, GeometryArena* arena = nullptr);
+    // Generates the geometry directly into GPU memory: maps the new buffers (or the arena slice)
+    // and lets 'write' fill exactly vertexCount vertices and indexCount indices. No CPU-side copy;
+    // float vertex format only, 16-bit indices when vertexCount allows. With an arena in another format
+    // the geometry is generated into temporary arrays and encoded instead.
+    Mesh(size_t vertexCount, size_t indexCount, const std::function<void(GeometryWriter&)>& write, GeometryArena* arena = nullptr);
+    ~Mesh();
+
+    // GL objects must not be duplicated
+    Mesh(const Mesh&) = delete;
+    Mesh& operator=(const Mesh&) = delete;
+
+    // Binds the VAO and issues the indexed draw calls (one per index chunk).
+    // The VAO stays bound (see GLStateCache), so the next draw from the same one skips the bind.
+    void draw();
+    // draw() in parts, for callers drawing many meshes in a row (RenderQueue): bindVertexArray() binds
+    // the VAO (the arena's shared one for arena meshes), drawBound() issues the draw calls
+    GLuint getVertexArrayID() const { return arena ? arena->getVertexArrayID() : vao_ptr->ID; }
+    void bindVertexArray();
+    void drawBound();
+
+    // Draws only the indices [firstIndex, firstIndex + count) (e.g. one piece of a StaticBatcher batch),
+    // split at chunk boundaries. Returns the number of draw calls issued.
+    size_t drawRange(size_t firstIndex, GLsizei count);
+
+    // Sets the decode uniforms of the packed format (meshPosOffset, meshPosScale, meshUvTransform).
+    // Must be called on the active shader before drawing a packed mesh, does nothing for the float format.
+    void applyDequant(Shader& shader) const;
+
+    // Links this mesh's vertex and index buffers into another VAO (layouts 0-3),
+    // used by InstancedShape which adds its per-instance attributes on top
+    void linkAttributes(VAO& target);
+    // Issues the instanced draw calls (one per chunk). A VAO set up with linkAttributes() must be bound.
+    void drawInstanced(GLsizei instanceCount);
+    // Changes whenever the underlying GL buffers are replaced (arena growth / defragment),
+    // VAOs set up with linkAttributes() must then be linked again
+    unsigned int getBufferVersion() const;
+
+    // Standard vertex layout: position, color, texture coordinates, normal (+ element buffer)
+    // in either the float or the packed format
+    static void linkLayout(VAO& vao, VBO& vbo, EBO& ebo, VertexFormat format);
+
+    // Converts 11-float vertices and 32-bit indices to the GPU representation: packs the vertices if
+    // format is Packed and shortens the indices to 16 bit when possible. data.bounds is left to the caller.
+    // data points into vertices / indices or into the two storage vectors, which must outlive it.
+    static void encode(const std::vector<GLfloat>& vertices, const std::vector<GLuint>& indices, VertexFormat format,
+                       MeshData& data, std::vector<PackedVertex>& packedStorage, std::vector<GLushort>& shortIndexStorage);
+
+    // Converts indices to 16 bit, split into chunks of at most 65536 vertices each.
+    // Returns false if a single triangle spans more than that (the mesh then stays 32-bit).
+    static bool buildShortIndices(const std::vector<GLuint>& indices, std::vector<GLushort>& shortIndices, std::vector<IndexChunk>& chunks);
+
+private:
+    // Creates the buffers (or the arena range) from encoded data
+    void upload(const MeshData& data);
+
+    // Draw parameters of the mesh as a whole (non-zero for arena meshes)
+    GLint getBaseVertex() const { return arena ? arenaRange->baseVertex : 0; }
+    size_t getIndexOffset() const { return arena ? (size_t)arenaRange->indexOffset : 0; }
+};
+
+#endif // MESH_H
@@ -0,0 +1,47 @@
+#include "meshCache.h"
+
+MeshCache& MeshCache::instance() {
+    static MeshCache cache;
+    return cache;
+}
+
+std::shared_ptr<Mesh> MeshCache::find(const std::string& key) {
+    auto it = meshes.find(key);
+    if (it == meshes.end()) {
+        misses++;
+        return nullptr;
+    }
+
+    std::shared_ptr<Mesh> mesh = it->second.lock();
+    if (!mesh) {
+        // Every shape using this mesh was cleaned up, drop the stale entry
+        meshes.erase(it);
+        misses++;
+        return nullptr;
+    }
+
+    hits++;
+    return mesh;
+}
+
+bool MeshCache::contains(const std::string& key) const {
+    auto it = meshes.find(key);
+    return it != meshes.end() && !it->second.expired();
+}
+
+void MeshCache::insert(const std::string& key, const std::shared_ptr<Mesh>& mesh) {
+    meshes[key] = mesh;
+}
+
+size_t MeshCache::getLiveMeshCount() {
+    size_t count = 0;
+    for (auto it = meshes.begin(); it != meshes.end();) {
+        if (it->second.expired()) {
+            it = meshes.erase(it);
+        } else {
+            count++;
+            ++it;
+        }
+    }
+    return count;
+}
@@ -0,0 +1,39 @@
+#ifndef MESH_CACHE_H
+#define MESH_CACHE_H
+
+#include <string>
+#include <memory>
+#include <unordered_map>
+#include "mesh.h"
+
+// Registry of uploaded meshes keyed by shape type + generation parameters.
+// Entries are weak references: the cache never keeps a mesh alive on its own,
+// a mesh is deleted as soon as the last Shape using it calls cleanup().
+class MeshCache {
+public:
+    // Single cache shared by the whole application
+    static MeshCache& instance();
+
+    // Returns the mesh registered under key, or nullptr if there is none (or it was already released)
+    std::shared_ptr<Mesh> find(const std::string& key);
+
+    // True if a live mesh is registered under key (does not count as a hit)
+    bool contains(const std::string& key) const;
+
+    // Registers a freshly uploaded mesh so other shapes with the same key can reuse it
+    void insert(const std::string& key, const std::shared_ptr<Mesh>& mesh);
+
+    // Statistics (useful for checking how many uploads were saved)
+    size_t getHitCount() const { return hits; }
+    size_t getMissCount() const { return misses; }
+    size_t getLiveMeshCount();
+
+private:
+    MeshCache() = default;
+
+    std::unordered_map<std::string, std::weak_ptr<Mesh>> meshes;
+    size_t hits = 0;
+    size_t misses = 0;
+};
+
+#endif // MESH_CACHE_H
@@ -0,0 +1,308 @@
+#include "meshFile.h"
+#include <cerrno>   // For errno
+#include <cstdio>   // For std::snprintf, std::rename, std::remove
+#include <cstring>  // For std::memcmp, std::memcpy
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <direct.h> // For _mkdir
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+const uint32_t MeshFile::version = 3;
+size_t MeshFile::loadedCount = 0;
+size_t MeshFile::writtenCount = 0;
+
+namespace {
+    const char fileMagic[4] = { 'G', 'M', 'S', 'H' };
+    const uint32_t flagOptimized = 1u << 0;
+    const uint64_t blobAlignment = 64;
+
+    // Fixed-size fields only, written and read as raw bytes (the files are not meant to move between platforms)
+    struct FileHeader {
+        char magic[4];
+        uint32_t version;
+        uint32_t flags;
+        uint32_t vertexFormat;
+        uint32_t stride;
+        uint32_t attributeCount;
+        uint32_t indexType;
+        uint32_t chunkCount;
+        uint32_t keyLength;
+        uint32_t indexCount;
+        uint32_t geometryRevision;
+        uint32_t reserved;
+        uint64_t vertexCount;
+        float boundsMin[3];
+        float boundsMax[3];
+        float sphereCenter[3];
+        float sphereRadius;
+        float posOffset[3];
+        float posScale[3];
+        float uvTransform[4];
+        uint64_t attributeOffset;
+        uint64_t chunkOffset;
+        uint64_t keyOffset;
+        uint64_t vertexOffset;
+        uint64_t vertexBytes;
+        uint64_t indexOffset;
+        uint64_t indexBytes;
+    };
+    static_assert(sizeof(FileHeader) == 192, "MeshFile header layout changed, bump MeshFile::version");
+
+    struct FileChunk {
+        int32_t baseVertex;
+        uint32_t indexCount;
+        uint64_t byteOffset;
+    };
+
+    uint64_t alignUp(uint64_t value) {
+        return (value + blobAlignment - 1) / blobAlignment * blobAlignment;
+    }
+
+    // True if [offset, offset + size) lies inside a file of fileSize bytes
+    bool inFile(uint64_t offset, uint64_t size, size_t fileSize) {
+        return offset <= fileSize && size <= fileSize - offset;
+    }
+
+    size_t getIndexSize(uint32_t indexType) {
+        if (indexType == GL_UNSIGNED_SHORT) return sizeof(GLushort);
+        if (indexType == GL_UNSIGNED_INT) return sizeof(GLuint);
+        return 0;
+    }
+
+    // FNV-1a, 64 bit
+    uint64_t hashKey(const std::string& key) {
+        uint64_t hash = 14695981039346656037ull;
+        for (unsigned char c : key) {
+            hash ^= c;
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+}
+
+MeshFile::~MeshFile() {
+    close();
+}
+
+std::string MeshFile::getCachePath(const std::string& directory, const std::string& key) {
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.mesh", (unsigned long long)hashKey(key));
+    if (directory.empty()) return name;
+    char last = directory.back();
+    return (last == '/' || last == '\\') ? directory + name : directory + "/" + name;
+}
+
+bool MeshFile::createDirectory(const std::string& directory) {
+#ifdef _WIN32
+    return _mkdir(directory.c_str()) == 0 || errno == EEXIST;
+#else
+    return mkdir(directory.c_str(), 0755) == 0 || errno == EEXIST;
+#endif
+}
+
+bool MeshFile::write(const std::string& path, const std::string& key, const MeshData& data, bool optimized, uint32_t geometryRevision) {
+    std::vector<VertexAttribute> attributes = getVertexAttributes(data.format);
+    GLsizei stride = getVertexStride(data.format);
+
+    FileHeader header = {};
+    std::memcpy(header.magic, fileMagic, sizeof(fileMagic));
+    header.version = version;
+    header.flags = optimized ? flagOptimized : 0;
+    header.vertexFormat = (uint32_t)data.format;
+    header.stride = (uint32_t)stride;
+    header.attributeCount = (uint32_t)attributes.size();
+    header.indexType = (uint32_t)data.indexType;
+    header.chunkCount = (uint32_t)data.chunks.size();
+    header.keyLength = (uint32_t)key.size();
+    header.indexCount = (uint32_t)data.indexCount;
+    header.geometryRevision = geometryRevision;
+    header.vertexCount = data.vertexCount;
+    for (int i = 0; i < 3; ++i) {
+        header.boundsMin[i] = data.bounds.box.min[i];
+        header.boundsMax[i] = data.bounds.box.max[i];
+        header.sphereCenter[i] = data.bounds.sphere.center[i];
+        header.posOffset[i] = data.dequant.posOffset[i];
+        header.posScale[i] = data.dequant.posScale[i];
+    }
+    header.sphereRadius = data.bounds.sphere.radius;
+    for (int i = 0; i < 4; ++i) header.uvTransform[i] = data.dequant.uvTransform[i];
+
+    std::vector<FileChunk> chunks;
+    for (const IndexChunk& chunk : data.chunks) {
+        chunks.push_back(FileChunk{ chunk.baseVertex, (uint32_t)chunk.indexCount, (uint64_t)chunk.byteOffset });
+    }
+
+    // Descriptor tables right after the header, the blobs on 64-byte boundaries after them
+    header.attributeOffset = sizeof(FileHeader);
+    header.chunkOffset = header.attributeOffset + attributes.size() * sizeof(VertexAttribute);
+    header.keyOffset = header.chunkOffset + chunks.size() * sizeof(FileChunk);
+    header.vertexOffset = alignUp(header.keyOffset + key.size());
+    header.vertexBytes = (uint64_t)data.vertexCount * stride;
+    header.indexOffset = alignUp(header.vertexOffset + header.vertexBytes);
+    header.indexBytes = data.indexBytes;
+
+    std::string tempPath = path + ".tmp";
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            std::cerr << "Error: Could not create mesh file " << tempPath << std::endl;
+            return false;
+        }
+        const char padding[blobAlignment] = {};
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(attributes.data()), attributes.size() * sizeof(VertexAttribute));
+        out.write(reinterpret_cast<const char*>(chunks.data()), chunks.size() * sizeof(FileChunk));
+        out.write(key.data(), key.size());
+        out.write(padding, header.vertexOffset - (header.keyOffset + key.size()));
+        out.write(static_cast<const char*>(data.vertexData), header.vertexBytes);
+        out.write(padding, header.indexOffset - (header.vertexOffset + header.vertexBytes));
+        out.write(static_cast<const char*>(data.indexData), header.indexBytes);
+        if (!out) {
+            std::cerr << "Error: Could not write mesh file " << tempPath << std::endl;
+            out.close();
+            std::remove(tempPath.c_str());
+            return false;
+        }
+    }
+
+#ifdef _WIN32
+    std::remove(path.c_str()); // rename() does not replace existing files on Windows
+#endif
+    if (std::rename(tempPath.c_str(), path.c_str()) != 0) {
+        std::remove(tempPath.c_str());
+        return false;
+    }
+    ++writtenCount;
+    return true;
+}
+
+bool MeshFile::open(const std::string& path, const std::string& key, VertexFormat format, bool optimized, uint32_t geometryRevision) {
+    close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart < (LONGLONG)sizeof(FileHeader)) {
+        CloseHandle(file);
+        return false;
+    }
+    HANDLE view = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!view) {
+        CloseHandle(file);
+        return false;
+    }
+    void* address = MapViewOfFile(view, FILE_MAP_READ, 0, 0, 0);
+    if (!address) {
+        CloseHandle(view);
+        CloseHandle(file);
+        return false;
+    }
+    fileHandle = file;
+    mappingHandle = view;
+    mapping = static_cast<const unsigned char*>(address);
+    mappingSize = (size_t)size.QuadPart;
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < (off_t)sizeof(FileHeader)) {
+        ::close(fd);
+        return false;
+    }
+    void* address = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); // The mapping stays valid without the descriptor
+    if (address == MAP_FAILED) return false;
+    mapping = static_cast<const unsigned char*>(address);
+    mappingSize = (size_t)info.st_size;
+#endif
+
+    // Validate everything before handing out pointers: a stale or foreign file is just a miss
+    FileHeader header;
+    std::memcpy(&header, mapping, sizeof(header));
+    std::vector<VertexAttribute> attributes = getVertexAttributes(format);
+    size_t indexSize = getIndexSize(header.indexType);
+    bool valid = std::memcmp(header.magic, fileMagic, sizeof(fileMagic)) == 0
+        && header.version == version
+        && header.geometryRevision == geometryRevision
+        && header.flags == (optimized ? flagOptimized : 0u)
+        && header.vertexFormat == (uint32_t)format
+        && header.stride == (uint32_t)getVertexStride(format)
+        && header.attributeCount == attributes.size()
+        && indexSize != 0
+        && header.keyLength == key.size()
+        && inFile(header.attributeOffset, (uint64_t)header.attributeCount * sizeof(VertexAttribute), mappingSize)
+        && inFile(header.chunkOffset, (uint64_t)header.chunkCount * sizeof(FileChunk), mappingSize)
+        && inFile(header.keyOffset, header.keyLength, mappingSize)
+        && inFile(header.vertexOffset, header.vertexBytes, mappingSize)
+        && inFile(header.indexOffset, header.indexBytes, mappingSize)
+        && header.vertexBytes == header.vertexCount * header.stride
+        && header.indexBytes == (uint64_t)header.indexCount * indexSize
+        && header.vertexCount > 0 && header.indexCount > 0 && header.chunkCount > 0;
+    // Same layout as this build would link (catches attribute changes without a version bump)
+    valid = valid && std::memcmp(mapping + header.attributeOffset, attributes.data(), attributes.size() * sizeof(VertexAttribute)) == 0;
+    // Different keys can share a hash: the full key is stored to tell them apart
+    valid = valid && std::memcmp(mapping + header.keyOffset, key.data(), key.size()) == 0;
+
+    std::vector<IndexChunk> chunks;
+    for (uint32_t i = 0; valid && i < header.chunkCount; ++i) {
+        FileChunk chunk;
+        std::memcpy(&chunk, mapping + header.chunkOffset + i * sizeof(FileChunk), sizeof(chunk));
+        valid = inFile(chunk.byteOffset, (uint64_t)chunk.indexCount * indexSize, (size_t)header.indexBytes);
+        chunks.push_back(IndexChunk{ chunk.baseVertex, (size_t)chunk.byteOffset, (GLsizei)chunk.indexCount });
+    }
+
+    if (!valid) {
+        close();
+        return false;
+    }
+
+    data.format = format;
+    for (int i = 0; i < 3; ++i) {
+        data.bounds.box.min[i] = header.boundsMin[i];
+        data.bounds.box.max[i] = header.boundsMax[i];
+        data.bounds.sphere.center[i] = header.sphereCenter[i];
+        data.dequant.posOffset[i] = header.posOffset[i];
+        data.dequant.posScale[i] = header.posScale[i];
+    }
+    data.bounds.sphere.radius = header.sphereRadius;
+    for (int i = 0; i < 4; ++i) data.dequant.uvTransform[i] = header.uvTransform[i];
+    data.vertexData = mapping + header.vertexOffset;
+    data.vertexCount = (size_t)header.vertexCount;
+    data.indexType = (GLenum)header.indexType;
+    data.indexData = mapping + header.indexOffset;
+    data.indexBytes = (size_t)header.indexBytes;
+    data.indexCount = (GLsizei)header.indexCount;
+    data.chunks = chunks;
+
+    ++loadedCount;
+    return true;
+}
+
+void MeshFile::close() {
+    if (mapping) {
+#ifdef _WIN32
+        UnmapViewOfFile(mapping);
+        CloseHandle(static_cast<HANDLE>(mappingHandle));
+        CloseHandle(static_cast<HANDLE>(fileHandle));
+        mappingHandle = nullptr;
+        fileHandle = nullptr;
+#else
+        munmap(const_cast<unsigned char*>(mapping), mappingSize);
+#endif
+    }
+    mapping = nullptr;
+    mappingSize = 0;
+    data = MeshData();
+}
@@ -0,0 +1,59 @@
+#ifndef MESH_FILE_H
+#define MESH_FILE_H
+
+#include <string>
+#include <cstdint>
+#include "mesh.h"
+
+// Binary on-disk copy of an encoded mesh (MeshData), so later runs skip generation, optimization and encoding.
+// Layout: header (including the bounds), vertex attribute descriptor, index chunk table, mesh key, then the vertex and index blobs,
+// each starting on a 64-byte boundary. A loaded file is memory-mapped and its blobs are passed to
+// glBufferData straight from the mapping, without reading them into a CPU-side copy first.
+// Files are only accepted if version, geometry revision, vertex layout, optimization flag and key all match,
+// anything else counts as a miss and is regenerated (and overwritten).
+class MeshFile {
+public:
+    // Bumped whenever the header or the encoding of the blobs changes
+    static const uint32_t version;
+
+    MeshFile() = default;
+    ~MeshFile();
+
+    // A mapping must not be unmapped twice
+    MeshFile(const MeshFile&) = delete;
+    MeshFile& operator=(const MeshFile&) = delete;
+
+    // Writes data under path (through a temporary file, so a crash never leaves a half-written file behind)
+    // geometryRevision identifies the code that produced the geometry (see Shape::geometryRevision): keys only
+    // cover the generation parameters, so a file written by older generator code must not match.
+    static bool write(const std::string& path, const std::string& key, const MeshData& data, bool optimized, uint32_t geometryRevision);
+
+    // Maps the file and validates it. On success getData() points into the mapping until close().
+    bool open(const std::string& path, const std::string& key, VertexFormat format, bool optimized, uint32_t geometryRevision);
+    void close();
+    bool isOpen() const { return mapping != nullptr; }
+    const MeshData& getData() const { return data; }
+
+    // <directory>/<16 hex digits of the key hash>.mesh
+    static std::string getCachePath(const std::string& directory, const std::string& key);
+    // Creates the directory if it does not exist yet (one level)
+    static bool createDirectory(const std::string& directory);
+
+    // Statistics
+    static size_t getLoadedCount() { return loadedCount; }
+    static size_t getWrittenCount() { return writtenCount; }
+
+private:
+    const unsigned char* mapping = nullptr;
+    size_t mappingSize = 0;
+#ifdef _WIN32
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+#endif
+    MeshData data;
+
+    static size_t loadedCount;
+    static size_t writtenCount;
+};
+
+#endif // MESH_FILE_H
@@ -0,0 +1,284 @@
+#include "meshOptimizer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <glm/glm.hpp>
+
+std::atomic<size_t> MeshOptimizer::meshCount(0);
+std::atomic<size_t> MeshOptimizer::triangleCount(0);
+std::atomic<size_t> MeshOptimizer::missesBefore(0);
+std::atomic<size_t> MeshOptimizer::missesAfter(0);
+
+static const size_t vertexFloats = 11; // Layout of GeometryWriter::addVertex
+
+void MeshOptimizer::optimize(std::vector<GLfloat>& vertices, std::vector<GLuint>& indices) {
+    size_t vertexCount = vertices.size() / vertexFloats;
+    if (indices.size() < 3 || vertexCount == 0) return;
+
+    size_t before = countCacheMisses(indices, vertexCount, fifoCacheSize);
+
+    optimizeVertexCache(indices, vertexCount);
+    optimizeOverdraw(indices, vertices);
+    optimizeVertexFetch(vertices, indices);
+
+    meshCount++;
+    triangleCount += indices.size() / 3;
+    missesBefore += before;
+    missesAfter += countCacheMisses(indices, vertices.size() / vertexFloats, fifoCacheSize);
+}
+
+// --- ACMR ---
+
+size_t MeshOptimizer::countCacheMisses(const std::vector<GLuint>& indices, size_t vertexCount, size_t cacheSize) {
+    // FIFO cache: a vertex stays cached until cacheSize newer vertices were transformed.
+    // cachedAt[v] is the value of 'misses' at the time v entered the cache.
+    std::vector<size_t> cachedAt(vertexCount, 0);
+    std::vector<bool> everCached(vertexCount, false);
+    size_t misses = 0;
+    for (GLuint index : indices) {
+        if (!everCached[index] || misses - cachedAt[index] >= cacheSize) {
+            cachedAt[index] = misses;
+            everCached[index] = true;
+            misses++;
+        }
+    }
+    return misses;
+}
+
+float MeshOptimizer::computeACMR(const std::vector<GLuint>& indices, size_t vertexCount, size_t cacheSize) {
+    if (indices.size() < 3) return 0.0f;
+    return (float)countCacheMisses(indices, vertexCount, cacheSize) / (indices.size() / 3);
+}
+
+// --- Vertex cache (Forsyth) ---
+
+// Tuning values from Tom Forsyth's "Linear-Speed Vertex Cache Optimisation"
+static const int lruCacheSize = 32;
+static const float cacheDecayPower = 1.5f;
+static const float lastTriangleScore = 0.75f;
+static const float valenceBoostScale = 2.0f;
+static const float valenceBoostPower = 0.5f;
+
+static float vertexScore(int cachePosition, unsigned int remainingTriangles) {
+    if (remainingTriangles == 0) return -1.0f; // No triangle needs this vertex anymore
+
+    float score = 0.0f;
+    if (cachePosition >= 0) {
+        if (cachePosition < 3) {
+            // Used by the last triangle: fixed score, so the next triangle is not biased towards one of its edges
+            score = lastTriangleScore;
+        } else {
+            float scaler = 1.0f - (float)(cachePosition - 3) / (lruCacheSize - 3);
+            score = std::pow(scaler, cacheDecayPower);
+        }
+    }
+    // Prefer vertices with few triangles left, so they are finished and leave the cache
+    score += valenceBoostScale * std::pow((float)remainingTriangles, -valenceBoostPower);
+    return score;
+}
+
+void MeshOptimizer::optimizeVertexCache(std::vector<GLuint>& indices, size_t vertexCount) {
+    size_t triangleTotal = indices.size() / 3;
+    if (triangleTotal == 0) return;
+
+    // Vertex -> triangles adjacency. The active triangles of v are
+    // adjacency[adjacencyOffset[v] .. adjacencyOffset[v] + remaining[v]).
+    std::vector<unsigned int> remaining(vertexCount, 0);
+    for (GLuint index : indices) remaining[index]++;
+    std::vector<size_t> adjacencyOffset(vertexCount + 1, 0);
+    for (size_t v = 0; v < vertexCount; ++v) adjacencyOffset[v + 1] = adjacencyOffset[v] + remaining[v];
+    std::vector<size_t> adjacency(indices.size());
+    std::vector<size_t> fill(adjacencyOffset.begin(), adjacencyOffset.end() - 1);
+    for (size_t i = 0; i < indices.size(); ++i) adjacency[fill[indices[i]]++] = i / 3;
+
+    std::vector<int> cachePosition(vertexCount, -1);
+    std::vector<float> scoreOfVertex(vertexCount);
+    for (size_t v = 0; v < vertexCount; ++v) scoreOfVertex[v] = vertexScore(-1, remaining[v]);
+
+    std::vector<float> scoreOfTriangle(triangleTotal);
+    std::vector<bool> emitted(triangleTotal, false);
+    for (size_t t = 0; t < triangleTotal; ++t) {
+        scoreOfTriangle[t] = scoreOfVertex[indices[t * 3]] + scoreOfVertex[indices[t * 3 + 1]] + scoreOfVertex[indices[t * 3 + 2]];
+    }
+
+    std::vector<GLuint> result;
+    result.reserve(indices.size());
+    std::vector<GLuint> cache, newCache;
+    cache.reserve(lruCacheSize + 3);
+    newCache.reserve(lruCacheSize + 3);
+
+    size_t bestTriangle = std::max_element(scoreOfTriangle.begin(), scoreOfTriangle.end()) - scoreOfTriangle.begin();
+    size_t scanCursor = 0; // For restarts when no cached vertex has triangles left
+
+    for (size_t emittedCount = 0; emittedCount < triangleTotal; ++emittedCount) {
+        if (bestTriangle == SIZE_MAX) {
+            // Disconnected part: continue with the next triangle in the original order
+            while (emitted[scanCursor]) scanCursor++;
+            bestTriangle = scanCursor;
+        }
+
+        const GLuint* tri = &indices[bestTriangle * 3];
+        result.insert(result.end(), tri, tri + 3);
+        emitted[bestTriangle] = true;
+
+        // Remove the triangle from the adjacency of its vertices
+        for (int k = 0; k < 3; ++k) {
+            GLuint v = tri[k];
+            size_t begin = adjacencyOffset[v];
+            size_t end = begin + remaining[v];
+            for (size_t i = begin; i < end; ++i) {
+                if (adjacency[i] == bestTriangle) {
+                    std::swap(adjacency[i], adjacency[end - 1]);
+                    break;
+                }
+            }
+            remaining[v]--;
+        }
+
+        // LRU update: the triangle's vertices move to the front
+        newCache.assign(tri, tri + 3);
+        for (GLuint v : cache) {
+            if (v != tri[0] && v != tri[1] && v != tri[2]) newCache.push_back(v);
+        }
+
+        // Rescore every vertex whose cache position changed (including the ones falling out)
+        for (size_t i = 0; i < newCache.size(); ++i) {
+            GLuint v = newCache[i];
+            cachePosition[v] = i < (size_t)lruCacheSize ? (int)i : -1;
+            scoreOfVertex[v] = vertexScore(cachePosition[v], remaining[v]);
+        }
+
+        // Rescore their triangles and pick the next one among them
+        bestTriangle = SIZE_MAX;
+        float bestScore = -1.0f;
+        for (GLuint v : newCache) {
+            size_t begin = adjacencyOffset[v];
+            for (size_t i = begin; i < begin + remaining[v]; ++i) {
+                size_t t = adjacency[i];
+                float score = scoreOfVertex[indices[t * 3]] + scoreOfVertex[indices[t * 3 + 1]] + scoreOfVertex[indices[t * 3 + 2]];
+                scoreOfTriangle[t] = score;
+                if (score > bestScore) {
+                    bestScore = score;
+                    bestTriangle = t;
+                }
+            }
+        }
+
+        if (newCache.size() > (size_t)lruCacheSize) newCache.resize(lruCacheSize);
+        cache.swap(newCache);
+    }
+
+    indices.swap(result);
+}
+
+// --- Overdraw ---
+
+void MeshOptimizer::optimizeOverdraw(std::vector<GLuint>& indices, const std::vector<GLfloat>& vertices, float threshold) {
+    size_t vertexCount = vertices.size() / vertexFloats;
+    size_t triangleTotal = indices.size() / 3;
+    if (triangleTotal < 2) return;
+
+    auto position = [&vertices](GLuint v) {
+        const GLfloat* p = &vertices[v * vertexFloats];
+        return glm::vec3(p[0], p[1], p[2]);
+    };
+
+    // Cluster boundaries: a new cluster starts wherever the (cold-started) cluster alone
+    // already reaches the target ACMR, so every cluster can be drawn in any order
+    // without making the whole mesh worse than threshold * current ACMR.
+    float targetACMR = computeACMR(indices, vertexCount) * threshold;
+    std::vector<size_t> clusterStart;
+    std::vector<size_t> cachedAt(vertexCount, 0);
+    std::vector<size_t> clusterId(vertexCount, SIZE_MAX); // Cluster in which cachedAt[v] was set
+    size_t clusterMisses = 0;
+    size_t clusterTriangles = 0;
+
+    for (size_t t = 0; t < triangleTotal; ++t) {
+        if (clusterTriangles == 0) clusterStart.push_back(t);
+        size_t cluster = clusterStart.size() - 1;
+        for (int k = 0; k < 3; ++k) {
+            GLuint v = indices[t * 3 + k];
+            if (clusterId[v] != cluster || clusterMisses - cachedAt[v] >= fifoCacheSize) {
+                cachedAt[v] = clusterMisses;
+                clusterId[v] = cluster;
+                clusterMisses++;
+            }
+        }
+        clusterTriangles++;
+
+        if ((float)clusterMisses / clusterTriangles <= targetACMR) {
+            clusterMisses = 0;
+            clusterTriangles = 0;
+        }
+    }
+    if (clusterStart.size() < 2) return;
+
+    // Mesh centroid (area-weighted)
+    glm::vec3 meshCentroid(0.0f);
+    float meshArea = 0.0f;
+    for (size_t t = 0; t < triangleTotal; ++t) {
+        glm::vec3 a = position(indices[t * 3]), b = position(indices[t * 3 + 1]), c = position(indices[t * 3 + 2]);
+        float area = glm::length(glm::cross(b - a, c - a));
+        meshCentroid += (a + b + c) * (area / 3.0f);
+        meshArea += area;
+    }
+    if (meshArea <= 0.0f) return;
+    meshCentroid /= meshArea;
+
+    // Sort key per cluster: how much it faces away from the center. Outer clusters
+    // drawn first occlude the inner/back ones, which then fail the depth test.
+    struct Cluster {
+        size_t begin, end; // Triangle range
+        float sortKey;
+    };
+    std::vector<Cluster> clusters(clusterStart.size());
+    for (size_t i = 0; i < clusterStart.size(); ++i) {
+        Cluster& cluster = clusters[i];
+        cluster.begin = clusterStart[i];
+        cluster.end = i + 1 < clusterStart.size() ? clusterStart[i + 1] : triangleTotal;
+
+        glm::vec3 centroid(0.0f), normal(0.0f);
+        float area = 0.0f;
+        for (size_t t = cluster.begin; t < cluster.end; ++t) {
+            glm::vec3 a = position(indices[t * 3]), b = position(indices[t * 3 + 1]), c = position(indices[t * 3 + 2]);
+            glm::vec3 n = glm::cross(b - a, c - a); // Length = 2 * area
+            float triangleArea = glm::length(n);
+            centroid += (a + b + c) * (triangleArea / 3.0f);
+            normal += n;
+            area += triangleArea;
+        }
+        float normalLength = glm::length(normal);
+        cluster.sortKey = (area > 0.0f && normalLength > 0.0f)
+            ? glm::dot(centroid / area - meshCentroid, normal / normalLength)
+            : 0.0f;
+    }
+
+    std::stable_sort(clusters.begin(), clusters.end(),
+        [](const Cluster& a, const Cluster& b) { return a.sortKey > b.sortKey; });
+
+    std::vector<GLuint> result;
+    result.reserve(indices.size());
+    for (const Cluster& cluster : clusters) {
+        result.insert(result.end(), indices.begin() + cluster.begin * 3, indices.begin() + cluster.end * 3);
+    }
+    indices.swap(result);
+}
+
+// --- Vertex fetch ---
+
+void MeshOptimizer::optimizeVertexFetch(std::vector<GLfloat>& vertices, std::vector<GLuint>& indices) {
+    size_t vertexCount = vertices.size() / vertexFloats;
+    std::vector<GLuint> remap(vertexCount, UINT32_MAX);
+    std::vector<GLfloat> result;
+    result.reserve(vertices.size());
+
+    GLuint next = 0;
+    for (GLuint& index : indices) {
+        if (remap[index] == UINT32_MAX) {
+            remap[index] = next++;
+            result.insert(result.end(), vertices.begin() + index * vertexFloats, vertices.begin() + (index + 1) * vertexFloats);
+        }
+        index = remap[index];
+    }
+    vertices.swap(result);
+}
@@ -0,0 +1,48 @@
+#ifndef MESH_OPTIMIZER_H
+#define MESH_OPTIMIZER_H
+
+#include <vector>
+#include <cstddef>
+#include <atomic>
+#include <glad/glad.h>
+
+// Reorders generated geometry for the GPU:
+//   1. triangles for the post-transform vertex cache (Forsyth's linear-speed algorithm),
+//   2. clusters of triangles for less overdraw (outward-facing clusters first, Tipsify-style),
+//   3. vertices in first-use order for vertex fetch locality.
+// Works on the 11-float vertex layout of GeometryWriter::addVertex and does not change the rendered result.
+class MeshOptimizer {
+public:
+    // Runs all three passes in place and adds the ACMR before/after to the totals
+    static void optimize(std::vector<GLfloat>& vertices, std::vector<GLuint>& indices);
+
+    // Individual passes
+    static void optimizeVertexCache(std::vector<GLuint>& indices, size_t vertexCount);
+    // Reorders the clusters of an already cache-optimized index list. The ACMR may grow at most by 'threshold'.
+    static void optimizeOverdraw(std::vector<GLuint>& indices, const std::vector<GLfloat>& vertices, float threshold = 1.05f);
+    // Renumbers vertices in the order they are first referenced (unreferenced vertices are dropped)
+    static void optimizeVertexFetch(std::vector<GLfloat>& vertices, std::vector<GLuint>& indices);
+
+    // Average cache miss ratio: transformed vertices per triangle with a FIFO cache of the given size
+    // (0.5 is the optimum for large regular meshes, 3.0 means no reuse at all)
+    static float computeACMR(const std::vector<GLuint>& indices, size_t vertexCount, size_t cacheSize = fifoCacheSize);
+
+    // Totals over all meshes optimized so far
+    static size_t getMeshCount() { return meshCount; }
+    static float getTotalACMRBefore() { return triangleCount ? (float)missesBefore / triangleCount : 0.0f; }
+    static float getTotalACMRAfter() { return triangleCount ? (float)missesAfter / triangleCount : 0.0f; }
+
+    // Vertex cache size assumed by computeACMR() (typical for current GPUs)
+    static const size_t fifoCacheSize = 16;
+
+private:
+    static size_t countCacheMisses(const std::vector<GLuint>& indices, size_t vertexCount, size_t cacheSize);
+
+    // Atomic: SceneBuilder optimizes meshes on several threads at once
+    static std::atomic<size_t> meshCount;
+    static std::atomic<size_t> triangleCount;
+    static std::atomic<size_t> missesBefore;
+    static std::atomic<size_t> missesAfter;
+};
+
+#endif // MESH_OPTIMIZER_H
@@ -0,0 +1,260 @@
+#include "occlusionCuller.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define OCCLUSION_CULLER_SSE2
+#include <emmintrin.h>
+#endif
+
+// Tolerance of the depth comparison (interpolated occluder depth vs. exact box corners),
+// so an occluder tested as an occludee is never hidden behind itself
+static const float depthEpsilon = 1e-5f;
+// Smallest clip-space w treated as in front of the camera
+static const float minimumW = 1e-5f;
+
+// Corners of a box face (corner i: bit 0 = max x, bit 1 = max y, bit 2 = max z)
+static const int boxFaces[6][4] = {
+    { 0, 2, 6, 4 }, { 1, 5, 7, 3 }, // -x, +x
+    { 0, 4, 5, 1 }, { 2, 3, 7, 6 }, // -y, +y
+    { 0, 1, 3, 2 }, { 4, 6, 7, 5 }, // -z, +z
+};
+
+OcclusionCuller::OcclusionCuller(int width, int height, ThreadPool* pool) : pool(pool) {
+    tilesX = std::max(1, (width + tileWidth - 1) / tileWidth);
+    tilesY = std::max(1, (height + tileHeight - 1) / tileHeight);
+    this->width = tilesX * tileWidth;
+    this->height = tilesY * tileHeight;
+    blocksX = this->width / blockSize;
+    blocksY = this->height / blockSize;
+    depth.assign((size_t)this->width * this->height, 1.0f);
+    blockMaxDepth.assign((size_t)blocksX * blocksY, 1.0f);
+    tileBins.resize((size_t)tilesX * tilesY);
+}
+
+void OcclusionCuller::addOccluder(const glm::mat4& model, const BoundingBox& localBox) {
+    if (localBox.isEmpty()) return;
+    for (int corner = 0; corner < 8; ++corner) {
+        glm::vec3 local((corner & 1) ? localBox.max.x : localBox.min.x,
+                        (corner & 2) ? localBox.max.y : localBox.min.y,
+                        (corner & 4) ? localBox.max.z : localBox.min.z);
+        occluderCorners.push_back(glm::vec3(model * glm::vec4(local, 1.0f)));
+    }
+}
+
+void OcclusionCuller::addOccluder(const Shape& shape) {
+    addOccluder(shape.modelMatrix, shape.getLocalBounds().box);
+}
+
+void OcclusionCuller::clearOccluders() {
+    occluderCorners.clear();
+}
+
+void OcclusionCuller::render(const glm::mat4& matrix) {
+    viewProjection = matrix;
+    std::fill(depth.begin(), depth.end(), 1.0f);
+    triangles.clear();
+    for (std::vector<uint32_t>& bin : tileBins) bin.clear();
+
+    // Transform, clip and set up every box face (both triangles of all 6 faces: flat boxes such as
+    // walls have two coinciding faces, closed boxes keep their back faces, which the depth test hides)
+    for (size_t first = 0; first + 8 <= occluderCorners.size(); first += 8) {
+        glm::vec4 clip[8];
+        for (int corner = 0; corner < 8; ++corner) clip[corner] = matrix * glm::vec4(occluderCorners[first + corner], 1.0f);
+        for (const int* face : boxFaces) {
+            addClipTriangle(clip[face[0]], clip[face[1]], clip[face[2]]);
+            addClipTriangle(clip[face[0]], clip[face[2]], clip[face[3]]);
+        }
+    }
+    triangleCount = triangles.size();
+
+    // Bin by the tiles each triangle's pixel rectangle overlaps
+    for (uint32_t t = 0; t < triangles.size(); ++t) {
+        const Triangle& triangle = triangles[t];
+        for (int ty = triangle.minY / tileHeight; ty <= triangle.maxY / tileHeight; ++ty) {
+            for (int tx = triangle.minX / tileWidth; tx <= triangle.maxX / tileWidth; ++tx) {
+                tileBins[(size_t)ty * tilesX + tx].push_back(t);
+            }
+        }
+    }
+
+    // Tiles share no pixels and no blocks, so they are rasterized independently
+    size_t tileCount = tileBins.size();
+    if (pool) {
+        pool->parallelFor(tileCount, [this](size_t tile) { rasterizeTile((int)tile); });
+    } else {
+        for (size_t tile = 0; tile < tileCount; ++tile) rasterizeTile((int)tile);
+    }
+
+    testedCount = 0;
+    occludedCount = 0;
+}
+
+void OcclusionCuller::addClipTriangle(const glm::vec4& a, const glm::vec4& b, const glm::vec4& c) {
+    // Sutherland-Hodgman against the near plane z >= -w (a triangle becomes at most a quad)
+    const glm::vec4 input[3] = { a, b, c };
+    glm::vec4 output[4];
+    int outputCount = 0;
+    for (int i = 0; i < 3; ++i) {
+        const glm::vec4& current = input[i];
+        const glm::vec4& next = input[(i + 1) % 3];
+        float currentDistance = current.z + current.w;
+        float nextDistance = next.z + next.w;
+        if (currentDistance >= 0.0f) output[outputCount++] = current;
+        if ((currentDistance >= 0.0f) != (nextDistance >= 0.0f)) {
+            float t = currentDistance / (currentDistance - nextDistance);
+            output[outputCount++] = current + (next - current) * t;
+        }
+    }
+    if (outputCount < 3) return;
+
+    // Clip space -> pixels (x, y) and window depth (z)
+    glm::vec3 screen[4];
+    for (int i = 0; i < outputCount; ++i) {
+        float w = std::max(output[i].w, minimumW);
+        screen[i] = glm::vec3((output[i].x / w * 0.5f + 0.5f) * width,
+                              (output[i].y / w * 0.5f + 0.5f) * height,
+                              output[i].z / w * 0.5f + 0.5f);
+    }
+    setupTriangle(screen[0], screen[1], screen[2]);
+    if (outputCount == 4) setupTriangle(screen[0], screen[2], screen[3]);
+}
+
+void OcclusionCuller::setupTriangle(const glm::vec3& a, const glm::vec3& inB, const glm::vec3& inC) {
+    glm::vec3 b = inB, c = inC;
+    float area = (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+    if (std::fabs(area) < 1e-6f) return; // Edge-on or degenerate
+    if (area < 0.0f) {
+        std::swap(b, c); // Counter-clockwise, so inside is where all edge functions are >= 0
+        area = -area;
+    }
+
+    Triangle triangle;
+    // Pixels whose centers lie within the triangle's bounding rectangle
+    triangle.minX = std::max(0, (int)std::ceil(std::min(a.x, std::min(b.x, c.x)) - 0.5f));
+    triangle.minY = std::max(0, (int)std::ceil(std::min(a.y, std::min(b.y, c.y)) - 0.5f));
+    triangle.maxX = std::min(width - 1, (int)std::floor(std::max(a.x, std::max(b.x, c.x)) - 0.5f));
+    triangle.maxY = std::min(height - 1, (int)std::floor(std::max(a.y, std::max(b.y, c.y)) - 0.5f));
+    if (triangle.minX > triangle.maxX || triangle.minY > triangle.maxY) return;
+
+    const glm::vec3* vertices[3] = { &a, &b, &c };
+    for (int e = 0; e < 3; ++e) {
+        const glm::vec3& from = *vertices[e];
+        const glm::vec3& to = *vertices[(e + 1) % 3];
+        triangle.edgeA[e] = from.y - to.y;
+        triangle.edgeB[e] = to.x - from.x;
+        triangle.edgeC[e] = from.x * to.y - from.y * to.x;
+    }
+    triangle.zA = ((b.z - a.z) * (c.y - a.y) - (c.z - a.z) * (b.y - a.y)) / area;
+    triangle.zB = ((c.z - a.z) * (b.x - a.x) - (b.z - a.z) * (c.x - a.x)) / area;
+    triangle.zC = a.z - triangle.zA * a.x - triangle.zB * a.y;
+    triangles.push_back(triangle);
+}
+
+void OcclusionCuller::rasterizeTile(int tile) {
+    int tileX = (tile % tilesX) * tileWidth;
+    int tileY = (tile / tilesX) * tileHeight;
+
+    for (uint32_t index : tileBins[tile]) {
+        const Triangle& t = triangles[index];
+        int minX = std::max(t.minX, tileX) & ~3; // Whole 4-pixel groups (tiles are multiples of 4 wide)
+        int maxX = std::min(t.maxX, tileX + tileWidth - 1);
+        int minY = std::max(t.minY, tileY);
+        int maxY = std::min(t.maxY, tileY + tileHeight - 1);
+
+        for (int y = minY; y <= maxY; ++y) {
+            float py = y + 0.5f;
+            float* row = &depth[(size_t)y * width];
+#if defined(OCCLUSION_CULLER_SSE2)
+            __m128 rowE0 = _mm_set1_ps(t.edgeB[0] * py + t.edgeC[0]);
+            __m128 rowE1 = _mm_set1_ps(t.edgeB[1] * py + t.edgeC[1]);
+            __m128 rowE2 = _mm_set1_ps(t.edgeB[2] * py + t.edgeC[2]);
+            __m128 rowZ = _mm_set1_ps(t.zB * py + t.zC);
+            __m128 a0 = _mm_set1_ps(t.edgeA[0]), a1 = _mm_set1_ps(t.edgeA[1]), a2 = _mm_set1_ps(t.edgeA[2]);
+            __m128 zA = _mm_set1_ps(t.zA);
+            __m128 zero = _mm_setzero_ps();
+            for (int x = minX; x <= maxX; x += 4) {
+                __m128 px = _mm_add_ps(_mm_set1_ps((float)x), _mm_set_ps(3.5f, 2.5f, 1.5f, 0.5f));
+                __m128 inside = _mm_and_ps(_mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(a0, px), rowE0), zero),
+                                _mm_and_ps(_mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(a1, px), rowE1), zero),
+                                           _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(a2, px), rowE2), zero)));
+                if (_mm_movemask_ps(inside) == 0) continue;
+                __m128 z = _mm_add_ps(_mm_mul_ps(zA, px), rowZ);
+                __m128 old = _mm_loadu_ps(row + x);
+                __m128 nearer = _mm_min_ps(old, z);
+                _mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, nearer), _mm_andnot_ps(inside, old)));
+            }
+#else
+            for (int x = minX; x <= maxX; ++x) {
+                float px = x + 0.5f;
+                if (t.edgeA[0] * px + t.edgeB[0] * py + t.edgeC[0] < 0.0f) continue;
+                if (t.edgeA[1] * px + t.edgeB[1] * py + t.edgeC[1] < 0.0f) continue;
+                if (t.edgeA[2] * px + t.edgeB[2] * py + t.edgeC[2] < 0.0f) continue;
+                row[x] = std::min(row[x], t.zA * px + t.zB * py + t.zC);
+            }
+#endif
+        }
+    }
+
+    // Farthest depth of every block in the tile
+    for (int by = tileY / blockSize; by < (tileY + tileHeight) / blockSize; ++by) {
+        for (int bx = tileX / blockSize; bx < (tileX + tileWidth) / blockSize; ++bx) {
+            float farthest = 0.0f;
+            for (int y = by * blockSize; y < (by + 1) * blockSize; ++y) {
+                const float* row = &depth[(size_t)y * width + bx * blockSize];
+                for (int x = 0; x < blockSize; ++x) farthest = std::max(farthest, row[x]);
+            }
+            blockMaxDepth[(size_t)by * blocksX + bx] = farthest;
+        }
+    }
+}
+
+bool OcclusionCuller::isVisible(const BoundingBox& worldBox) const {
+    if (worldBox.isEmpty()) return true;
+    testedCount++;
+
+    // Screen rectangle and nearest depth of the projected corners
+    glm::vec2 screenMin(std::numeric_limits<float>::max()), screenMax(-std::numeric_limits<float>::max());
+    float nearest = std::numeric_limits<float>::max();
+    for (int corner = 0; corner < 8; ++corner) {
+        glm::vec3 world((corner & 1) ? worldBox.max.x : worldBox.min.x,
+                        (corner & 2) ? worldBox.max.y : worldBox.min.y,
+                        (corner & 4) ? worldBox.max.z : worldBox.min.z);
+        glm::vec4 clip = viewProjection * glm::vec4(world, 1.0f);
+        if (clip.w < minimumW || clip.z < -clip.w) return true; // Reaches behind the near plane
+        glm::vec2 screen((clip.x / clip.w * 0.5f + 0.5f) * width, (clip.y / clip.w * 0.5f + 0.5f) * height);
+        screenMin = glm::min(screenMin, screen);
+        screenMax = glm::max(screenMax, screen);
+        nearest = std::min(nearest, clip.z / clip.w * 0.5f + 0.5f);
+    }
+
+    // Every pixel the rectangle touches
+    int minX = std::max(0, (int)std::floor(screenMin.x));
+    int minY = std::max(0, (int)std::floor(screenMin.y));
+    int maxX = std::min(width - 1, (int)std::floor(screenMax.x));
+    int maxY = std::min(height - 1, (int)std::floor(screenMax.y));
+    if (minX > maxX || minY > maxY) {
+        occludedCount++; // Off screen
+        return false;
+    }
+
+    nearest -= depthEpsilon;
+    for (int by = minY / blockSize; by <= maxY / blockSize; ++by) {
+        for (int bx = minX / blockSize; bx <= maxX / blockSize; ++bx) {
+            // Block decides: everything in it is nearer than the box
+            if (nearest > blockMaxDepth[(size_t)by * blocksX + bx]) continue;
+            // Otherwise look at the pixels of the block inside the rectangle
+            int x0 = std::max(minX, bx * blockSize), x1 = std::min(maxX, bx * blockSize + blockSize - 1);
+            int y0 = std::max(minY, by * blockSize), y1 = std::min(maxY, by * blockSize + blockSize - 1);
+            for (int y = y0; y <= y1; ++y) {
+                const float* row = &depth[(size_t)y * width];
+                for (int x = x0; x <= x1; ++x) {
+                    if (nearest <= row[x]) return true;
+                }
+            }
+        }
+    }
+    occludedCount++;
+    return false;
+}
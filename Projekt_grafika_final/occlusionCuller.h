@@ -0,0 +1,90 @@
+#ifndef OCCLUSION_CULLER_H
+#define OCCLUSION_CULLER_H
+
+#include <vector>
+#include <cstddef>
+#include <glm/glm.hpp>
+#include "bounds.h"
+#include "shape.h"
+#include "threadPool.h"
+
+// CPU occlusion culling: large occluders (walls, floors, big cubes) are rasterized into a small
+// depth buffer, and occludee boxes are tested against it before their draw calls are issued.
+// No GPU round trip, so the result is available in the same frame, and it runs headless.
+//
+// render() transforms and clips the occluder triangles once, bins them into screen tiles and
+// rasterizes the tiles in parallel on a ThreadPool (tiles never share pixels), 4 pixels per SSE2
+// step. Every tile also stores the farthest depth of each 8x8 block; isVisible() compares the
+// box's nearest depth against these blocks first and only looks at single pixels where a block
+// cannot decide.
+//
+// Depth is the window-space depth of the projection (0 = near, 1 = far). Coverage is sampled at
+// pixel centers, so an occludee seen only through a sub-pixel gap may be reported hidden.
+class OcclusionCuller {
+public:
+    // Screen tiles rasterized as one job, and the blocks of the hierarchical max-depth
+    static const int tileWidth = 32;
+    static const int tileHeight = 16;
+    static const int blockSize = 8;
+
+    // width and height are rounded up to whole tiles. Without a pool everything runs on the calling thread.
+    OcclusionCuller(int width = 256, int height = 144, ThreadPool* pool = nullptr);
+
+    // Occluders are given as the box they completely fill (in local space) and their model matrix:
+    // exact for Plane and Cube, which is what they are meant for. Never add shapes that do not fill
+    // their box (spheres, pyramids, frames), or objects behind them would be culled wrongly.
+    void addOccluder(const glm::mat4& model, const BoundingBox& localBox);
+    // Same with the shape's modelMatrix and local bounds (must be set up, see Shape::getLocalBounds())
+    void addOccluder(const Shape& shape);
+    void clearOccluders();
+    size_t getOccluderCount() const { return occluderCorners.size() / 8; }
+
+    // Clears the depth buffer and rasterizes every occluder as seen through viewProjection
+    void render(const glm::mat4& viewProjection);
+
+    // False if the world-space box is completely behind the occluders (or off screen).
+    // Boxes reaching behind the near plane are always visible.
+    bool isVisible(const BoundingBox& worldBox) const;
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    // Row-major, bottom row first (like glReadPixels)
+    const std::vector<float>& getDepthBuffer() const { return depth; }
+
+    // Statistics of the last render() and the isVisible() calls since
+    size_t getTriangleCount() const { return triangleCount; }
+    size_t getTestedCount() const { return testedCount; }
+    size_t getOccludedCount() const { return occludedCount; }
+
+private:
+    // Screen-space triangle ready for rasterization: edge functions A*x + B*y + C >= 0 inside,
+    // depth plane z = zA*x + zB*y + zC, and the pixel bounding rectangle
+    struct Triangle {
+        float edgeA[3], edgeB[3], edgeC[3];
+        float zA, zB, zC;
+        int minX, minY, maxX, maxY;
+    };
+
+    int width, height;
+    int tilesX, tilesY;
+    int blocksX, blocksY;
+    ThreadPool* pool;
+
+    std::vector<glm::vec3> occluderCorners;        // 8 world-space corners per occluder
+    std::vector<float> depth;                      // width * height
+    std::vector<float> blockMaxDepth;              // blocksX * blocksY
+    std::vector<Triangle> triangles;
+    std::vector<std::vector<uint32_t>> tileBins;   // Triangle indices per tile
+    glm::mat4 viewProjection = glm::mat4(1.0f);
+
+    size_t triangleCount = 0;
+    mutable size_t testedCount = 0;
+    mutable size_t occludedCount = 0;
+
+    // Clips one triangle against the near plane and adds the resulting 0-2 screen triangles
+    void addClipTriangle(const glm::vec4& a, const glm::vec4& b, const glm::vec4& c);
+    void setupTriangle(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c);
+    void rasterizeTile(int tile);
+};
+
+#endif // OCCLUSION_CULLER_H
@@ -0,0 +1,129 @@
+#include "occlusionQueries.h"
+#include <glm/gtc/matrix_transform.hpp>
+
+const float OcclusionQueries::nearMargin = 0.5f;
+
+// Unit cube [-1, 1]^3, placed over a box by the model matrix
+static const GLfloat boxVertices[] = {
+    -1.0f, -1.0f, -1.0f,   1.0f, -1.0f, -1.0f,   -1.0f, 1.0f, -1.0f,   1.0f, 1.0f, -1.0f,
+    -1.0f, -1.0f,  1.0f,   1.0f, -1.0f,  1.0f,   -1.0f, 1.0f,  1.0f,   1.0f, 1.0f,  1.0f,
+};
+static const GLushort boxIndices[] = {
+    0, 2, 3, 0, 3, 1, // -z
+    4, 5, 7, 4, 7, 6, // +z
+    0, 4, 6, 0, 6, 2, // -x
+    1, 3, 7, 1, 7, 5, // +x
+    0, 1, 5, 0, 5, 4, // -y
+    2, 6, 7, 2, 7, 3, // +y
+};
+
+OcclusionQueries::OcclusionQueries(size_t objectCount) {
+    vao_ptr = std::make_unique<VAO>();
+    // Bound first: creating the EBO binds it to whatever vertex array is bound (draws leave theirs bound)
+    vao_ptr->Bind();
+    vbo_ptr = std::make_unique<VBO>(boxVertices, sizeof(boxVertices));
+    ebo_ptr = std::make_unique<EBO>(boxIndices, sizeof(boxIndices));
+    vao_ptr->LinkVBO(*vbo_ptr, 0);
+    vao_ptr->Unbind();
+    resize(objectCount);
+}
+
+void OcclusionQueries::Delete() {
+    resize(0);
+    if (vao_ptr) vao_ptr->Delete();
+    if (vbo_ptr) vbo_ptr->Delete();
+    if (ebo_ptr) ebo_ptr->Delete();
+    vao_ptr.reset();
+    vbo_ptr.reset();
+    ebo_ptr.reset();
+}
+
+void OcclusionQueries::resize(size_t objectCount) {
+    for (size_t i = objectCount; i < objects.size(); ++i) {
+        if (objects[i].id) glDeleteQueries(1, &objects[i].id);
+    }
+    objects.resize(objectCount);
+}
+
+void OcclusionQueries::beginFrame(const glm::vec3& camera) {
+    cameraPosition = camera;
+    frame++;
+    issuedCount = 0;
+    for (ObjectQuery& object : objects) {
+        if (!object.pending) continue;
+        GLuint available = 0;
+        glGetQueryObjectuiv(object.id, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) continue; // Still in flight, the last result stays in use
+        GLuint anySamplesPassed = 0;
+        glGetQueryObjectuiv(object.id, GL_QUERY_RESULT, &anySamplesPassed);
+        object.visible = anySamplesPassed != 0;
+        object.pending = false;
+    }
+}
+
+void OcclusionQueries::beginQueries(Shader& shader) {
+    queryShader = &shader;
+    const DrawUniforms& uniforms = shader.getDrawUniforms();
+    modelUniform = uniforms.model;
+    // Positions are plain floats (the packed-vertex variant of the shader dequantizes with identity)
+    shader.set(uniforms.meshPosOffset, glm::vec3(0.0f));
+    shader.set(uniforms.meshPosScale, glm::vec3(1.0f));
+
+    GLStateCache::setColorMask(false);
+    GLStateCache::setDepthMask(false);
+    // Both sides count: a box face turned away may still be the only part in front of the occluders
+    cullFaceWasEnabled = GLStateCache::isEnabled(GL_CULL_FACE);
+    GLStateCache::setEnabled(GL_CULL_FACE, false);
+    vao_ptr->Bind();
+}
+
+void OcclusionQueries::query(size_t object, const BoundingBox& worldBox) {
+    ObjectQuery& state = objects[object];
+    glm::vec3 center = worldBox.getCenter();
+    glm::vec3 extent = worldBox.getExtent();
+    glm::vec3 distance = glm::abs(cameraPosition - center) - extent;
+    state.bypass = worldBox.isEmpty() ||
+                   (distance.x < nearMargin && distance.y < nearMargin && distance.z < nearMargin);
+    if (state.bypass || state.pending) return;
+
+    // Hidden objects every frame, visible ones every visibleInterval frames (staggered)
+    bool due = !state.issued || !state.visible || (frame + object) % visibleInterval == 0;
+    if (!due) return;
+
+    if (!state.id) glGenQueries(1, &state.id);
+    glm::mat4 model = glm::scale(glm::translate(glm::mat4(1.0f), center), extent);
+    queryShader->set(modelUniform, model);
+    glBeginQuery(GL_ANY_SAMPLES_PASSED, state.id);
+    glDrawElements(GL_TRIANGLES, sizeof(boxIndices) / sizeof(boxIndices[0]), GL_UNSIGNED_SHORT, 0);
+    glEndQuery(GL_ANY_SAMPLES_PASSED);
+    state.issued = true;
+    state.pending = true;
+    issuedCount++;
+}
+
+void OcclusionQueries::endQueries() {
+    GLStateCache::setColorMask(true);
+    GLStateCache::setDepthMask(true);
+    GLStateCache::setEnabled(GL_CULL_FACE, cullFaceWasEnabled);
+}
+
+void OcclusionQueries::beginConditionalRender(size_t object) {
+    ObjectQuery& state = objects[object];
+    state.conditional = state.issued && !state.bypass;
+    // NO_WAIT: a result still in flight draws the object instead of stalling
+    if (state.conditional) glBeginConditionalRender(state.id, GL_QUERY_NO_WAIT);
+}
+
+void OcclusionQueries::endConditionalRender(size_t object) {
+    ObjectQuery& state = objects[object];
+    if (state.conditional) glEndConditionalRender();
+    state.conditional = false;
+}
+
+size_t OcclusionQueries::getHiddenCount() const {
+    size_t hidden = 0;
+    for (const ObjectQuery& object : objects) {
+        if (!object.visible) hidden++;
+    }
+    return hidden;
+}
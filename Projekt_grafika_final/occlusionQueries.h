@@ -0,0 +1,89 @@
+#ifndef OCCLUSION_QUERIES_H
+#define OCCLUSION_QUERIES_H
+
+#include <vector>
+#include <memory>
+#include <cstddef>
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include "bounds.h"
+#include "shaderClass.h"
+#include "VAO.h"
+#include "VBO.h"
+#include "EBO.h"
+
+// GPU occlusion culling with hardware queries (core since GL 3.3: GL_ANY_SAMPLES_PASSED, conditional rendering).
+// After the big occluders are drawn, query() draws an object's world bounding box with colour and depth
+// writes off inside a query. The object's real draw is wrapped in beginConditionalRender() /
+// endConditionalRender(), so the GPU drops it when no sample of the box passed the depth test, without
+// the CPU waiting for the answer.
+//
+// Results are never waited for: an object gets a new query only once the previous result is available,
+// and the conditional render keeps using the last finished one. Objects found visible are queried again
+// every visibleInterval frames, staggered by object index so they do not all come due in the same frame.
+// Hidden objects are queried every frame, so they reappear without delay.
+class OcclusionQueries {
+public:
+    static const unsigned int visibleInterval = 4;
+    // A camera closer than this to an object's box (inside it, or the box crossing the near plane)
+    // always draws the object: the box faces could be clipped away and report it hidden
+    static const float nearMargin;
+
+    // Creates the box mesh (needs the OpenGL context)
+    explicit OcclusionQueries(size_t objectCount = 0);
+    OcclusionQueries(const OcclusionQueries&) = delete;
+    OcclusionQueries& operator=(const OcclusionQueries&) = delete;
+
+    // Objects are identified by index, like in the scene Bvh
+    void resize(size_t objectCount);
+    size_t size() const { return objects.size(); }
+    // Deletes the query objects and the box mesh (call while the context still exists)
+    void Delete();
+
+    // Starts a frame: collects the results that have become available (never waits)
+    void beginFrame(const glm::vec3& cameraPosition);
+
+    // Query pass: turns colour and depth writes and face culling off and binds the box mesh.
+    // 'shader' is a position-only shader with "model" and "camMatrix" (light.vert), activated by the caller
+    // with camMatrix set. Call after the occluders are drawn and before the objects.
+    void beginQueries(Shader& shader);
+    // Draws the object's box inside its query if one is due this frame
+    void query(size_t object, const BoundingBox& worldBox);
+    // Restores the state changed by beginQueries()
+    void endQueries();
+
+    // Brackets the object's real draw calls. No-ops while the object has no result or the camera is at its box.
+    void beginConditionalRender(size_t object);
+    void endConditionalRender(size_t object);
+
+    // Last known result (true until the first one arrives)
+    bool isVisible(size_t object) const { return objects[object].visible; }
+
+    // Queries issued in this frame, and objects whose last result was hidden
+    size_t getIssuedCount() const { return issuedCount; }
+    size_t getHiddenCount() const;
+
+private:
+    struct ObjectQuery {
+        GLuint id = 0;
+        bool issued = false;  // A query has been issued at least once (the id can be used for conditional render)
+        bool pending = false; // Result not yet collected
+        bool visible = true;
+        bool bypass = false;  // Camera at the box this frame: draw unconditionally
+        bool conditional = false;
+    };
+
+    std::vector<ObjectQuery> objects;
+    std::unique_ptr<VAO> vao_ptr;
+    std::unique_ptr<VBO> vbo_ptr;
+    std::unique_ptr<EBO> ebo_ptr;
+    Shader* queryShader = nullptr; // Set by beginQueries()
+    UniformHandle modelUniform;
+    bool cullFaceWasEnabled = false;
+
+    glm::vec3 cameraPosition = glm::vec3(0.0f);
+    unsigned int frame = 0;
+    size_t issuedCount = 0;
+};
+
+#endif // OCCLUSION_QUERIES_H
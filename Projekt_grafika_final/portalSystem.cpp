@@ -0,0 +1,224 @@
+#include "portalSystem.h"
+#include <algorithm>
+#include <cmath>
+
+int PortalSystem::addCell(const BoundingBox& bounds) {
+    Cell cell;
+    cell.bounds = bounds;
+    cells.push_back(cell);
+    cellVisible.push_back(1);
+    cellRects.push_back(ScreenRect());
+    visitedCells.push_back(static_cast<int>(cells.size()) - 1); // Visible until the first update()
+    return static_cast<int>(cells.size()) - 1;
+}
+
+int PortalSystem::addPortal(int cellA, int cellB, const std::vector<glm::vec3>& corners) {
+    Portal portal;
+    portal.cells[0] = cellA;
+    portal.cells[1] = cellB;
+    portal.corners = corners;
+    portal.normal = glm::normalize(glm::cross(corners[1] - corners[0], corners[2] - corners[0]));
+    portals.push_back(portal);
+    int index = static_cast<int>(portals.size()) - 1;
+    cells[cellA].portals.push_back(index);
+    cells[cellB].portals.push_back(index);
+    return index;
+}
+
+int PortalSystem::addDoor(int cellA, int cellB, const glm::vec3& bottomCenter, const glm::vec3& normal, float width, float height) {
+    glm::vec3 up(0.0f, 1.0f, 0.0f);
+    glm::vec3 side = glm::normalize(glm::cross(up, normal)) * (width / 2.0f);
+    glm::vec3 top = up * height;
+    return addPortal(cellA, cellB, { bottomCenter - side, bottomCenter + side, bottomCenter + side + top, bottomCenter - side + top });
+}
+
+void PortalSystem::addShape(int cell, const Shape* shape) {
+    shapeCells[shape] = cell;
+}
+
+int PortalSystem::addShape(const Shape* shape) {
+    int cell = findCell(shape->getWorldBounds().box.getCenter());
+    if (cell >= 0) addShape(cell, shape);
+    return cell;
+}
+
+void PortalSystem::removeShape(const Shape* shape) {
+    shapeCells.erase(shape);
+}
+
+void PortalSystem::clear() {
+    cells.clear();
+    portals.clear();
+    shapeCells.clear();
+    cellVisible.clear();
+    cellRects.clear();
+    visitedCells.clear();
+    cameraCell = -1;
+}
+
+int PortalSystem::getCell(const Shape* shape) const {
+    auto it = shapeCells.find(shape);
+    return it != shapeCells.end() ? it->second : -1;
+}
+
+bool PortalSystem::contains(int cell, const glm::vec3& position) const {
+    const BoundingBox& box = cells[cell].bounds;
+    return position.x >= box.min.x && position.y >= box.min.y && position.z >= box.min.z &&
+           position.x <= box.max.x && position.y <= box.max.y && position.z <= box.max.z;
+}
+
+int PortalSystem::findCell(const glm::vec3& position) const {
+    for (size_t i = 0; i < cells.size(); ++i) {
+        if (contains(static_cast<int>(i), position)) return static_cast<int>(i);
+    }
+    return -1;
+}
+
+void PortalSystem::update(const glm::vec3& position, const glm::mat4& matrix) {
+    viewProjection = matrix;
+    cameraPosition = position;
+    // The near plane z = -w in world space is (row 2 + row 3) of the matrix; the camera lies behind it
+    glm::vec4 nearPlane(matrix[0][2] + matrix[0][3], matrix[1][2] + matrix[1][3], matrix[2][2] + matrix[2][3], matrix[3][2] + matrix[3][3]);
+    nearDistance = std::max(-(glm::dot(glm::vec3(nearPlane), position) + nearPlane.w) / glm::length(glm::vec3(nearPlane)), 0.0f);
+    testedPortalCount = 0;
+    for (int cell : visitedCells) {
+        cellVisible[cell] = 0;
+        cellRects[cell] = ScreenRect();
+    }
+    visitedCells.clear();
+    ScreenRect fullScreen;
+    fullScreen.min = glm::vec2(-1.0f);
+    fullScreen.max = glm::vec2(1.0f);
+
+    // The camera rarely leaves its room, and then only through a door: no search over every cell
+    int previousCell = cameraCell;
+    cameraCell = -1;
+    if (previousCell >= 0 && previousCell < static_cast<int>(cells.size())) {
+        if (contains(previousCell, cameraPosition)) {
+            cameraCell = previousCell;
+        } else {
+            for (int portalIndex : cells[previousCell].portals) {
+                const Portal& portal = portals[portalIndex];
+                int next = portal.cells[0] == previousCell ? portal.cells[1] : portal.cells[0];
+                if (contains(next, cameraPosition)) {
+                    cameraCell = next;
+                    break;
+                }
+            }
+        }
+    }
+    if (cameraCell < 0) cameraCell = findCell(cameraPosition);
+    if (cameraCell < 0) {
+        // Outside the building (or in a gap between cells): no portal information, draw everything
+        for (size_t cell = 0; cell < cells.size(); ++cell) {
+            cellVisible[cell] = 1;
+            cellRects[cell] = fullScreen;
+            visitedCells.push_back(static_cast<int>(cell));
+        }
+        return;
+    }
+    visit(cameraCell, fullScreen, -1, 0);
+}
+
+void PortalSystem::visit(int cell, const ScreenRect& rect, int fromPortal, int depth) {
+    if (!cellVisible[cell]) {
+        cellVisible[cell] = 1;
+        visitedCells.push_back(cell);
+    }
+    ScreenRect& cellRect = cellRects[cell];
+    cellRect.min = glm::min(cellRect.min, rect.min);
+    cellRect.max = glm::max(cellRect.max, rect.max);
+    if (depth >= maxPortalDepth) return;
+
+    for (int portalIndex : cells[cell].portals) {
+        if (portalIndex == fromPortal) continue; // Never straight back through the door we came in
+        const Portal& portal = portals[portalIndex];
+        testedPortalCount++;
+
+        // What can be seen through this door: its projection, cut down to what is seen of this cell.
+        // A camera walking through the door sees the next room through all of this cell's rectangle.
+        ScreenRect through = rect;
+        if (!isCameraInPortal(portal)) {
+            through = projectPolygon(portal.corners);
+            through.min = glm::max(through.min, rect.min);
+            through.max = glm::min(through.max, rect.max);
+            if (through.isEmpty()) continue;
+        }
+
+        // Skip rooms already seen through at least this much (also ends cycles of rooms)
+        int next = portal.cells[0] == cell ? portal.cells[1] : portal.cells[0];
+        const ScreenRect& nextRect = cellRects[next];
+        if (cellVisible[next] && nextRect.min.x <= through.min.x && nextRect.min.y <= through.min.y &&
+            nextRect.max.x >= through.max.x && nextRect.max.y >= through.max.y) {
+            continue;
+        }
+        visit(next, through, portalIndex, depth + 1);
+    }
+}
+
+PortalSystem::ScreenRect PortalSystem::projectPolygon(const std::vector<glm::vec3>& corners) const {
+    // Sutherland-Hodgman against the near plane z >= -w
+    std::vector<glm::vec4> clip;
+    clip.reserve(corners.size());
+    for (const glm::vec3& corner : corners) clip.push_back(viewProjection * glm::vec4(corner, 1.0f));
+
+    ScreenRect rect;
+    rect.min = glm::vec2(1.0f);
+    rect.max = glm::vec2(-1.0f);
+    bool any = false;
+    auto addPoint = [&](const glm::vec4& point) {
+        glm::vec2 ndc = glm::vec2(point.x, point.y) / std::max(point.w, 1e-6f);
+        rect.min = any ? glm::min(rect.min, ndc) : ndc;
+        rect.max = any ? glm::max(rect.max, ndc) : ndc;
+        any = true;
+    };
+    for (size_t i = 0; i < clip.size(); ++i) {
+        const glm::vec4& current = clip[i];
+        const glm::vec4& next = clip[(i + 1) % clip.size()];
+        float currentDistance = current.z + current.w;
+        float nextDistance = next.z + next.w;
+        if (currentDistance >= 0.0f) addPoint(current);
+        if ((currentDistance >= 0.0f) != (nextDistance >= 0.0f)) {
+            addPoint(current + (next - current) * (currentDistance / (currentDistance - nextDistance)));
+        }
+    }
+    if (!any) return ScreenRect();
+    rect.min = glm::max(rect.min, glm::vec2(-1.0f));
+    rect.max = glm::min(rect.max, glm::vec2(1.0f));
+    return rect;
+}
+
+bool PortalSystem::isCameraInPortal(const Portal& portal) const {
+    const std::vector<glm::vec3>& corners = portal.corners;
+    if (std::abs(glm::dot(cameraPosition - corners[0], portal.normal)) > nearDistance) return false;
+    // Inside every edge of the convex polygon, with the near distance as a margin
+    for (size_t i = 0; i < corners.size(); ++i) {
+        glm::vec3 edge = corners[(i + 1) % corners.size()] - corners[i];
+        float side = glm::dot(glm::cross(edge, cameraPosition - corners[i]), portal.normal);
+        if (side < -nearDistance * glm::length(edge)) return false;
+    }
+    return true;
+}
+
+bool PortalSystem::isVisible(const Shape* shape, const BoundingBox& worldBox) const {
+    auto it = shapeCells.find(shape);
+    if (it == shapeCells.end()) return true;
+    int cell = it->second;
+    if (!cellVisible[cell]) return false;
+    if (cell == cameraCell || cameraCell < 0 || worldBox.isEmpty()) return true;
+
+    // Only rooms seen through doors are narrowed: is the box inside the rectangle they were seen through?
+    glm::vec2 boxMin(1e30f), boxMax(-1e30f);
+    for (int corner = 0; corner < 8; ++corner) {
+        glm::vec3 world((corner & 1) ? worldBox.max.x : worldBox.min.x,
+                        (corner & 2) ? worldBox.max.y : worldBox.min.y,
+                        (corner & 4) ? worldBox.max.z : worldBox.min.z);
+        glm::vec4 clip = viewProjection * glm::vec4(world, 1.0f);
+        if (clip.z < -clip.w) return true; // Reaches behind the near plane
+        glm::vec2 ndc = glm::vec2(clip.x, clip.y) / clip.w;
+        boxMin = glm::min(boxMin, ndc);
+        boxMax = glm::max(boxMax, ndc);
+    }
+    const ScreenRect& rect = cellRects[cell];
+    return boxMin.x <= rect.max.x && boxMax.x >= rect.min.x && boxMin.y <= rect.max.y && boxMax.y >= rect.min.y;
+}
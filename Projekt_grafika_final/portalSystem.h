@@ -0,0 +1,104 @@
+#ifndef PORTAL_SYSTEM_H
+#define PORTAL_SYSTEM_H
+
+#include <vector>
+#include <unordered_map>
+#include <cstddef>
+#include <glm/glm.hpp>
+#include "bounds.h"
+#include "shape.h"
+
+// Cell and portal visibility for buildings made of rooms: every room is a cell (an axis-aligned box),
+// doorways are portals (convex polygons) connecting two cells. update() starts in the camera's cell
+// with the whole screen and walks through the portals, narrowing the visible screen rectangle to each
+// portal's projection on the way. Cells no portal chain reaches are not drawn at all, so the cost
+// depends on the rooms seen through the doors, not on how many rooms the building has.
+//
+// Shapes are assigned to cells explicitly; shapes without a cell (lights, things moving between rooms)
+// are always visible. The rectangles are conservative: a shape may pass although a wall hides it.
+class PortalSystem {
+public:
+    // Deepest chain of portals followed from the camera's cell (protects against cycles of rooms)
+    static const int maxPortalDepth = 32;
+
+    // Room volume in world space, returns the cell index
+    int addCell(const BoundingBox& bounds);
+    // Opening between two cells, as the corners of a convex polygon in order (a door: 4 corners).
+    // Portals are passable in both directions.
+    int addPortal(int cellA, int cellB, const std::vector<glm::vec3>& corners);
+    // Door-shaped portal: the rectangle of the given width and height standing on 'bottomCenter',
+    // perpendicular to 'normal' (horizontal)
+    int addDoor(int cellA, int cellB, const glm::vec3& bottomCenter, const glm::vec3& normal, float width, float height);
+
+    // Assigns a shape to a cell (a shape belongs to one cell, assigning it again moves it)
+    void addShape(int cell, const Shape* shape);
+    // Assigns a shape to the cell containing the center of its world bounds, returns the cell or -1 (not assigned)
+    int addShape(const Shape* shape);
+    void removeShape(const Shape* shape);
+    void clear();
+
+    // First cell whose box contains the point, or -1
+    int findCell(const glm::vec3& position) const;
+
+    // Finds the cells visible from the camera (call once per frame, after Camera::updateMatrix).
+    // The camera is looked for in last frame's cell and its neighbours first. A camera outside every cell sees everything.
+    void update(const glm::vec3& cameraPosition, const glm::mat4& viewProjection);
+
+    bool isCellVisible(int cell) const { return cellVisible[cell] != 0; }
+    // False if the shape's cell was not reached, or its world box lies outside the portal rectangles
+    // through which the cell is seen. Shapes without a cell are always visible.
+    bool isVisible(const Shape* shape, const BoundingBox& worldBox) const;
+    bool isVisible(const Shape* shape) const { return isVisible(shape, shape->getWorldBounds().box); }
+
+    size_t getCellCount() const { return cells.size(); }
+    size_t getPortalCount() const { return portals.size(); }
+    int getCell(const Shape* shape) const;
+    int getCameraCell() const { return cameraCell; }
+
+    // Debug counters of the last update(): cells reached, and portals whose projection was tested
+    size_t getVisitedCellCount() const { return visitedCells.size(); }
+    size_t getTestedPortalCount() const { return testedPortalCount; }
+
+private:
+    // Screen-space rectangle in normalized device coordinates
+    struct ScreenRect {
+        glm::vec2 min = glm::vec2(1.0f);
+        glm::vec2 max = glm::vec2(-1.0f);
+        bool isEmpty() const { return min.x >= max.x || min.y >= max.y; }
+    };
+
+    struct Cell {
+        BoundingBox bounds;
+        std::vector<int> portals;
+    };
+
+    struct Portal {
+        int cells[2];
+        std::vector<glm::vec3> corners;
+        glm::vec3 normal; // Of the polygon's plane (unit length, from the first three corners)
+    };
+
+    std::vector<Cell> cells;
+    std::vector<Portal> portals;
+    std::unordered_map<const Shape*, int> shapeCells;
+
+    // Per-frame state
+    glm::mat4 viewProjection = glm::mat4(1.0f);
+    glm::vec3 cameraPosition = glm::vec3(0.0f);
+    float nearDistance = 0.0f; // From the camera to the near plane
+    std::vector<char> cellVisible;
+    std::vector<ScreenRect> cellRects; // Union of the rectangles each cell was reached through
+    std::vector<int> visitedCells;     // Cells marked visible (only these are reset by the next update())
+    int cameraCell = -1;
+    size_t testedPortalCount = 0;
+
+    bool contains(int cell, const glm::vec3& position) const;
+    void visit(int cell, const ScreenRect& rect, int fromPortal, int depth);
+    // Screen rectangle of a convex polygon clipped to the near plane (empty if completely behind it)
+    ScreenRect projectPolygon(const std::vector<glm::vec3>& corners) const;
+    // True if the camera is closer to the portal than the near plane and in front of its opening: the near
+    // plane then cuts the portal, and its projection says nothing about what is seen through it
+    bool isCameraInPortal(const Portal& portal) const;
+};
+
+#endif // PORTAL_SYSTEM_H
@@ -0,0 +1,125 @@
+#include "renderQueue.h"
+#include <algorithm>
+
+void RenderQueue::begin(const glm::vec3& eyePosition, const glm::vec3& viewDirection, float maxDistance) {
+    items.clear();
+    eye = eyePosition;
+    forward = glm::normalize(viewDirection);
+    farDistance = maxDistance;
+}
+
+void RenderQueue::submit(Shape& shape, Shader& shader, RenderPass pass, uint32_t tag) {
+    if (!shape.meshInitialized) return;
+    const BoundingSphere& sphere = shape.getWorldBounds().sphere;
+    float depth = sphere.isEmpty() ? 0.0f : (glm::dot(sphere.center - eye, forward) - sphere.radius) / farDistance;
+    GLuint texture = shape.shapeTexture ? shape.shapeTexture->ID : 0;
+
+    RenderItem item;
+    item.key = makeKey(pass, shader.ID, !shape.doubleSided, texture, shape.mesh->getVertexArrayID(), depth);
+    item.shape = &shape;
+    item.shader = &shader;
+    item.tag = tag;
+    items.push_back(item);
+}
+
+uint64_t RenderQueue::makeKey(RenderPass pass, GLuint shader, bool cullFaces, GLuint texture, GLuint vertexArray, float depth) {
+    uint64_t quantizedDepth = static_cast<uint64_t>(std::min(std::max(depth, 0.0f), 1.0f) * 4294967295.0);
+    uint64_t state = (static_cast<uint64_t>(shader & ((1u << shaderBits) - 1)) << (1 + textureBits + vertexArrayBits)) |
+                     (static_cast<uint64_t>(cullFaces ? 0 : 1) << (textureBits + vertexArrayBits)) |
+                     (static_cast<uint64_t>(texture & ((1u << textureBits) - 1)) << vertexArrayBits) |
+                     static_cast<uint64_t>(vertexArray & ((1u << vertexArrayBits) - 1));
+    uint64_t passBits = static_cast<uint64_t>(pass) << 62;
+    if (pass == RenderPass::Transparent) {
+        return passBits | ((0xFFFFFFFFull - quantizedDepth) << 30) | state;
+    }
+    return passBits | (state << depthBits) | quantizedDepth;
+}
+
+void RenderQueue::sort() {
+    size_t count = items.size();
+    if (count < 2) return;
+    if (count < radixThreshold) {
+        std::stable_sort(items.begin(), items.end(), [](const RenderItem& a, const RenderItem& b) { return a.key < b.key; });
+        return;
+    }
+
+    // Keys and item indices are sorted (16 bytes each), the items are moved once at the end.
+    // All eight byte histograms come from one pass; bytes every key has in common get no pass.
+    sortEntries.resize(count);
+    sortScratch.resize(count);
+    size_t histograms[8][256] = {};
+    for (size_t i = 0; i < count; ++i) {
+        uint64_t key = items[i].key;
+        sortEntries[i].key = key;
+        sortEntries[i].index = static_cast<uint32_t>(i);
+        for (int byte = 0; byte < 8; ++byte) histograms[byte][(key >> (byte * 8)) & 0xFF]++;
+    }
+    for (int byte = 0; byte < 8; ++byte) {
+        size_t* offsets = histograms[byte];
+        if (offsets[(sortEntries[0].key >> (byte * 8)) & 0xFF] == count) continue; // Same byte in every key
+        size_t sum = 0;
+        for (int digit = 0; digit < 256; ++digit) {
+            size_t digitCount = offsets[digit];
+            offsets[digit] = sum;
+            sum += digitCount;
+        }
+        for (const SortEntry& entry : sortEntries) sortScratch[offsets[(entry.key >> (byte * 8)) & 0xFF]++] = entry;
+        sortEntries.swap(sortScratch);
+    }
+
+    sortBuffer.resize(count);
+    for (size_t i = 0; i < count; ++i) sortBuffer[i] = items[sortEntries[i].index];
+    items.swap(sortBuffer);
+}
+
+void RenderQueue::execute(const std::function<void(uint32_t)>& beforeDraw, const std::function<void(uint32_t)>& afterDraw) {
+    stateChanges = 0;
+    bool cullWasEnabled = GLStateCache::isEnabled(GL_CULL_FACE);
+    bool cullEnabled = cullWasEnabled;
+    Shader* currentShader = nullptr;
+    UniformHandle modelUniform;
+    const Mesh* currentMesh = nullptr; // Decode uniforms set on the current shader
+    Texture* currentTexture = nullptr;
+    bool textureSet = false;
+    Mesh* lastMesh = nullptr;
+
+    for (const RenderItem& item : items) {
+        Shape& shape = *item.shape;
+        Mesh* mesh = shape.mesh.get();
+        if (item.shader != currentShader) {
+            item.shader->Activate();
+            modelUniform = item.shader->getDrawUniforms().model;
+            currentShader = item.shader;
+            currentMesh = nullptr; // Uniforms belong to the program
+            stateChanges++;
+        }
+        bool cull = !shape.doubleSided;
+        if (cull != cullEnabled) {
+            GLStateCache::setEnabled(GL_CULL_FACE, cull);
+            cullEnabled = cull;
+            stateChanges++;
+        }
+        if (!textureSet || shape.shapeTexture != currentTexture) {
+            GLStateCache::bindTexture(GL_TEXTURE0, GL_TEXTURE_2D, shape.shapeTexture ? shape.shapeTexture->ID : 0);
+            currentTexture = shape.shapeTexture;
+            textureSet = true;
+            stateChanges++;
+        }
+        if (!lastMesh || mesh->getVertexArrayID() != lastMesh->getVertexArrayID()) {
+            mesh->bindVertexArray();
+            stateChanges++;
+        }
+        lastMesh = mesh;
+        if (mesh != currentMesh) {
+            mesh->applyDequant(*item.shader);
+            currentMesh = mesh;
+        }
+        item.shader->set(modelUniform, shape.modelMatrix);
+
+        if (beforeDraw) beforeDraw(item.tag);
+        mesh->drawBound();
+        if (afterDraw) afterDraw(item.tag);
+    }
+
+    GLStateCache::setEnabled(GL_CULL_FACE, cullWasEnabled);
+}
@@ -0,0 +1,83 @@
+#ifndef RENDER_QUEUE_H
+#define RENDER_QUEUE_H
+
+#include <vector>
+#include <functional>
+#include <cstddef>
+#include <cstdint>
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include "shape.h"
+#include "shaderClass.h"
+
+enum class RenderPass {
+    Opaque,     // Front to back, grouped by state
+    Transparent // Back to front (blending needs the order), state only breaks ties
+};
+
+// One draw: the shape with its shader, and the key it is sorted by
+struct RenderItem {
+    uint64_t key = 0;
+    Shape* shape = nullptr;
+    Shader* shader = nullptr;
+    uint32_t tag = ~0u; // Caller's object index (RenderQueue::noTag if none), handed to the draw callbacks
+};
+
+// Collects the visible shapes of a frame and draws them sorted by a 64-bit key, skipping the GL state
+// that does not change from one draw to the next. Key layout, most significant bits first:
+//
+//   Opaque:       pass(2) | shader(6) | cull(1) | texture(12) | VAO(11) | depth(32)
+//   Transparent:  pass(2) | inverted depth(32) | shader(6) | cull(1) | texture(12) | VAO(11)
+//
+// Opaque draws are grouped by shader, then face culling, texture and vertex array (shapes sharing a
+// Mesh or the GeometryArena share one), and drawn front to back inside each group, so early depth
+// testing rejects what later draws hide. The state fields are the GL names masked to their width:
+// two names landing on the same value only group less well, the state itself is always compared.
+// Keys are sorted with an 8-bit LSD radix sort that skips the bytes every key has in common
+// (std::stable_sort for short queues).
+class RenderQueue {
+public:
+    static const uint32_t shaderBits = 6, textureBits = 12, vertexArrayBits = 11, depthBits = 32;
+    static const uint32_t noTag = ~0u;
+
+    // Starts a frame: empties the queue and sets what depth is measured from.
+    // Depth is the distance along 'forward' to the nearest point of a shape's bounding sphere, over farDistance.
+    void begin(const glm::vec3& eyePosition, const glm::vec3& viewDirection, float maxDistance);
+    // Queues a shape whose mesh is uploaded (shapes without one are skipped). Face culling is off for doubleSided shapes.
+    void submit(Shape& shape, Shader& shader, RenderPass pass = RenderPass::Opaque, uint32_t tag = noTag);
+    // Queues an item with a key made by the caller
+    void submit(const RenderItem& item) { items.push_back(item); }
+
+    // Sorts the queued items by key (stable)
+    void sort();
+    // Draws the items in queue order. The shaders' per-frame uniforms (camera, lights) must be set.
+    // beforeDraw / afterDraw bracket every draw call with the item's tag (e.g. conditional rendering).
+    // Leaves the last texture and vertex array bound (like Mesh::draw()) and face culling as it was.
+    void execute(const std::function<void(uint32_t)>& beforeDraw = nullptr,
+                 const std::function<void(uint32_t)>& afterDraw = nullptr);
+
+    static uint64_t makeKey(RenderPass pass, GLuint shader, bool cullFaces, GLuint texture, GLuint vertexArray, float depth);
+
+    const std::vector<RenderItem>& getItems() const { return items; }
+    size_t size() const { return items.size(); }
+    // Shader, face culling, texture and vertex array changes made by the last execute() (before GLStateCache filtering)
+    size_t getStateChangeCount() const { return stateChanges; }
+
+private:
+    struct SortEntry {
+        uint64_t key;
+        uint32_t index;
+    };
+    // Below this many items a comparison sort is faster than the radix passes
+    static const size_t radixThreshold = 1024;
+
+    std::vector<RenderItem> items;
+    std::vector<RenderItem> sortBuffer;
+    std::vector<SortEntry> sortEntries, sortScratch;
+    glm::vec3 eye = glm::vec3(0.0f);
+    glm::vec3 forward = glm::vec3(0.0f, 0.0f, -1.0f);
+    float farDistance = 100.0f;
+    size_t stateChanges = 0;
+};
+
+#endif // RENDER_QUEUE_H
@@ -0,0 +1,266 @@
+#include "scene.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SCENE_SSE2
+#include <emmintrin.h>
+#endif
+
+// Rays (almost) parallel to a triangle's plane miss it
+static const float parallelEpsilon = 1e-12f;
+
+void Scene::add(const Shape* shape) {
+    Object object;
+    object.shape = shape;
+    objects.push_back(object);
+}
+
+void Scene::add(const LodShape* shape) {
+    Object object;
+    object.shape = shape->getLevel(0);
+    object.lod = shape;
+    objects.push_back(object);
+}
+
+void Scene::clear() {
+    objects.clear();
+    meshes.clear();
+    objectTree.build(std::vector<BoundingBox>());
+}
+
+const glm::mat4& Scene::getMatrix(const Object& object) const {
+    return object.lod ? object.lod->modelMatrix : object.shape->modelMatrix;
+}
+
+BoundingBox Scene::getWorldBox(const Object& object) const {
+    return object.mesh->bounds.transformed(object.matrix);
+}
+
+void Scene::build() {
+    meshes.clear();
+    std::vector<BoundingBox> boxes;
+    boxes.reserve(objects.size());
+    for (size_t i = 0; i < objects.size(); ++i) {
+        Object& object = objects[i];
+        // Shapes without a mesh key never share geometry
+        std::string key = object.shape->getMeshKey();
+        if (key.empty()) key = "#" + std::to_string(i);
+        auto it = meshes.find(key);
+        if (it == meshes.end()) it = meshes.emplace(key, buildMesh(*object.shape)).first;
+        object.mesh = it->second;
+        object.matrix = getMatrix(object);
+        object.inverseMatrix = glm::inverse(object.matrix);
+        boxes.push_back(getWorldBox(object));
+    }
+    objectTree.build(boxes);
+}
+
+void Scene::update() {
+    for (size_t i = 0; i < objects.size(); ++i) {
+        Object& object = objects[i];
+        const glm::mat4& matrix = getMatrix(object);
+        if (matrix == object.matrix) continue;
+        object.matrix = matrix;
+        object.inverseMatrix = glm::inverse(matrix);
+        objectTree.update(static_cast<uint32_t>(i), getWorldBox(object));
+    }
+}
+
+size_t Scene::getTriangleCount() const {
+    size_t count = 0;
+    for (const auto& entry : meshes) count += entry.second->corners.size();
+    return count;
+}
+
+std::shared_ptr<Scene::MeshTriangles> Scene::buildMesh(const Shape& shape) {
+    std::vector<GLfloat> vertices;
+    std::vector<GLuint> indices;
+    shape.getGeometry(vertices, indices);
+
+    auto mesh = std::make_shared<MeshTriangles>();
+    size_t triangleCount = indices.size() / 3;
+    mesh->corners.reserve(triangleCount);
+    mesh->edges1.reserve(triangleCount);
+    mesh->edges2.reserve(triangleCount);
+    mesh->uvs.reserve(triangleCount * 3);
+    std::vector<BoundingBox> boxes(triangleCount);
+    for (size_t t = 0; t < triangleCount; ++t) {
+        glm::vec3 positions[3];
+        for (int corner = 0; corner < 3; ++corner) {
+            const GLfloat* v = &vertices[indices[t * 3 + corner] * 11];
+            positions[corner] = glm::vec3(v[0], v[1], v[2]);
+            mesh->uvs.push_back(glm::vec2(v[6], v[7]));
+            boxes[t].expand(positions[corner]);
+        }
+        mesh->corners.push_back(positions[0]);
+        mesh->edges1.push_back(positions[1] - positions[0]);
+        mesh->edges2.push_back(positions[2] - positions[0]);
+    }
+    mesh->bvh.build(boxes);
+    mesh->bounds = mesh->bvh.getBounds();
+    return mesh;
+}
+
+#if defined(SCENE_SSE2)
+
+bool Scene::intersectTriangles(const MeshTriangles& mesh, const uint32_t* triangles, uint32_t count,
+                               const glm::vec3& origin, const glm::vec3& direction,
+                               float& closest, uint32_t& hitTriangle, glm::vec2& barycentric) {
+    const __m128 ox = _mm_set1_ps(origin.x), oy = _mm_set1_ps(origin.y), oz = _mm_set1_ps(origin.z);
+    const __m128 dx = _mm_set1_ps(direction.x), dy = _mm_set1_ps(direction.y), dz = _mm_set1_ps(direction.z);
+    const __m128 zero = _mm_setzero_ps(), one = _mm_set1_ps(1.0f);
+    const __m128 epsilon = _mm_set1_ps(parallelEpsilon);
+    const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+    bool hit = false;
+
+    for (uint32_t first = 0; first < count; first += 4) {
+        // Gather 4 triangles into SoA registers (a partial group repeats its last triangle)
+        uint32_t lanes[4];
+        float cx[4], cy[4], cz[4], e1x[4], e1y[4], e1z[4], e2x[4], e2y[4], e2z[4];
+        for (uint32_t lane = 0; lane < 4; ++lane) {
+            lanes[lane] = triangles[std::min(first + lane, count - 1)];
+            const glm::vec3& c = mesh.corners[lanes[lane]];
+            const glm::vec3& a = mesh.edges1[lanes[lane]];
+            const glm::vec3& b = mesh.edges2[lanes[lane]];
+            cx[lane] = c.x; cy[lane] = c.y; cz[lane] = c.z;
+            e1x[lane] = a.x; e1y[lane] = a.y; e1z[lane] = a.z;
+            e2x[lane] = b.x; e2y[lane] = b.y; e2z[lane] = b.z;
+        }
+        __m128 edge1x = _mm_loadu_ps(e1x), edge1y = _mm_loadu_ps(e1y), edge1z = _mm_loadu_ps(e1z);
+        __m128 edge2x = _mm_loadu_ps(e2x), edge2y = _mm_loadu_ps(e2y), edge2z = _mm_loadu_ps(e2z);
+
+        // p = d x e2, det = e1 . p
+        __m128 px = _mm_sub_ps(_mm_mul_ps(dy, edge2z), _mm_mul_ps(dz, edge2y));
+        __m128 py = _mm_sub_ps(_mm_mul_ps(dz, edge2x), _mm_mul_ps(dx, edge2z));
+        __m128 pz = _mm_sub_ps(_mm_mul_ps(dx, edge2y), _mm_mul_ps(dy, edge2x));
+        __m128 det = _mm_add_ps(_mm_add_ps(_mm_mul_ps(edge1x, px), _mm_mul_ps(edge1y, py)), _mm_mul_ps(edge1z, pz));
+        __m128 inverseDet = _mm_div_ps(one, det);
+
+        // s = o - corner, u = (s . p) / det
+        __m128 sx = _mm_sub_ps(ox, _mm_loadu_ps(cx)), sy = _mm_sub_ps(oy, _mm_loadu_ps(cy)), sz = _mm_sub_ps(oz, _mm_loadu_ps(cz));
+        __m128 u = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(sx, px), _mm_mul_ps(sy, py)), _mm_mul_ps(sz, pz)), inverseDet);
+
+        // q = s x e1, v = (d . q) / det, t = (e2 . q) / det
+        __m128 qx = _mm_sub_ps(_mm_mul_ps(sy, edge1z), _mm_mul_ps(sz, edge1y));
+        __m128 qy = _mm_sub_ps(_mm_mul_ps(sz, edge1x), _mm_mul_ps(sx, edge1z));
+        __m128 qz = _mm_sub_ps(_mm_mul_ps(sx, edge1y), _mm_mul_ps(sy, edge1x));
+        __m128 v = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, qx), _mm_mul_ps(dy, qy)), _mm_mul_ps(dz, qz)), inverseDet);
+        __m128 t = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(edge2x, qx), _mm_mul_ps(edge2y, qy)), _mm_mul_ps(edge2z, qz)), inverseDet);
+
+        __m128 valid = _mm_cmpgt_ps(_mm_and_ps(det, absMask), epsilon);
+        valid = _mm_and_ps(valid, _mm_and_ps(_mm_cmpge_ps(u, zero), _mm_cmpge_ps(v, zero)));
+        valid = _mm_and_ps(valid, _mm_cmple_ps(_mm_add_ps(u, v), one));
+        valid = _mm_and_ps(valid, _mm_and_ps(_mm_cmpge_ps(t, zero), _mm_cmplt_ps(t, _mm_set1_ps(closest))));
+        int mask = _mm_movemask_ps(valid);
+        if (!mask) continue;
+
+        float ts[4], us[4], vs[4];
+        _mm_storeu_ps(ts, t);
+        _mm_storeu_ps(us, u);
+        _mm_storeu_ps(vs, v);
+        for (int lane = 0; lane < 4; ++lane) {
+            if ((mask & (1 << lane)) && ts[lane] < closest) {
+                closest = ts[lane];
+                hitTriangle = lanes[lane];
+                barycentric = glm::vec2(us[lane], vs[lane]);
+                hit = true;
+            }
+        }
+    }
+    return hit;
+}
+
+const char* Scene::getSimdPath() { return "SSE2"; }
+
+#else
+
+bool Scene::intersectTriangles(const MeshTriangles& mesh, const uint32_t* triangles, uint32_t count,
+                               const glm::vec3& origin, const glm::vec3& direction,
+                               float& closest, uint32_t& hitTriangle, glm::vec2& barycentric) {
+    bool hit = false;
+    for (uint32_t i = 0; i < count; ++i) {
+        uint32_t triangle = triangles[i];
+        const glm::vec3& edge1 = mesh.edges1[triangle];
+        const glm::vec3& edge2 = mesh.edges2[triangle];
+        glm::vec3 p = glm::cross(direction, edge2);
+        float det = glm::dot(edge1, p);
+        if (std::fabs(det) <= parallelEpsilon) continue;
+        float inverseDet = 1.0f / det;
+        glm::vec3 s = origin - mesh.corners[triangle];
+        float u = glm::dot(s, p) * inverseDet;
+        if (u < 0.0f || u > 1.0f) continue;
+        glm::vec3 q = glm::cross(s, edge1);
+        float v = glm::dot(direction, q) * inverseDet;
+        if (v < 0.0f || u + v > 1.0f) continue;
+        float t = glm::dot(edge2, q) * inverseDet;
+        if (t < 0.0f || t >= closest) continue;
+        closest = t;
+        hitTriangle = triangle;
+        barycentric = glm::vec2(u, v);
+        hit = true;
+    }
+    return hit;
+}
+
+const char* Scene::getSimdPath() { return "scalar"; }
+
+#endif
+
+RayHit Scene::raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance) const {
+    // Everything the traversal callbacks need behind one pointer, so std::function stores the lambdas
+    // without allocating (thousands of rays per frame)
+    struct Context {
+        const Scene* scene;
+        glm::vec3 origin, direction;
+        // Object being tested and its ray in local space
+        const MeshTriangles* mesh = nullptr;
+        glm::vec3 localOrigin, localDirection;
+        uint32_t triangle = 0;
+        glm::vec2 barycentric;
+        // Nearest hit so far
+        uint32_t hitObject = 0, hitTriangle = 0;
+        glm::vec2 hitBarycentric;
+        bool hit = false;
+    } context;
+    context.scene = this;
+    context.origin = origin;
+    context.direction = direction;
+    Context* c = &context;
+
+    std::function<float(const uint32_t*, uint32_t, float)> testTriangles = [c](const uint32_t* triangles, uint32_t count, float closest) {
+        intersectTriangles(*c->mesh, triangles, count, c->localOrigin, c->localDirection, closest, c->triangle, c->barycentric);
+        return closest;
+    };
+    std::function<float(const uint32_t*, uint32_t, float)> testObjects = [c, &testTriangles](const uint32_t* list, uint32_t count, float closest) {
+        for (uint32_t i = 0; i < count; ++i) {
+            const Object& object = c->scene->objects[list[i]];
+            // The local ray keeps the parameterization of the world ray, so distances compare directly
+            c->mesh = object.mesh.get();
+            c->localOrigin = glm::vec3(object.inverseMatrix * glm::vec4(c->origin, 1.0f));
+            c->localDirection = glm::vec3(object.inverseMatrix * glm::vec4(c->direction, 0.0f));
+            float distance = object.mesh->bvh.queryRayClosest(c->localOrigin, c->localDirection, closest, testTriangles);
+            if (distance < closest) {
+                closest = distance;
+                c->hitObject = list[i];
+                c->hitTriangle = c->triangle;
+                c->hitBarycentric = c->barycentric;
+                c->hit = true;
+            }
+        }
+        return closest;
+    };
+    float distance = objectTree.queryRayClosest(origin, direction, maxDistance, testObjects);
+
+    RayHit hit;
+    if (!context.hit) return hit;
+    const Object& object = objects[context.hitObject];
+    const glm::vec2* uvs = &object.mesh->uvs[context.hitTriangle * 3];
+    float u = context.hitBarycentric.x, v = context.hitBarycentric.y;
+    hit.shape = object.shape;
+    hit.triangle = context.hitTriangle;
+    hit.distance = distance;
+    hit.point = origin + direction * distance;
+    hit.uv = uvs[0] * (1.0f - u - v) + uvs[1] * u + uvs[2] * v;
+    return hit;
+}
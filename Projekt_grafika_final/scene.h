@@ -0,0 +1,89 @@
+#ifndef SCENE_H
+#define SCENE_H
+
+#include <vector>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <cstdint>
+#include <cfloat>
+#include <glm/glm.hpp>
+#include "shape.h"
+#include "lodShape.h"
+#include "bvh.h"
+
+// Nearest intersection found by Scene::raycast()
+struct RayHit {
+    const Shape* shape = nullptr; // nullptr: nothing hit
+    uint32_t triangle = 0;        // Triangle index in the shape's geometry (Shape::getGeometry() order)
+    float distance = FLT_MAX;     // Ray parameter of the hit (world units for a normalized direction)
+    glm::vec3 point = glm::vec3(0.0f); // World space
+    glm::vec2 uv = glm::vec2(0.0f);    // Interpolated texture coordinates
+
+    bool hasHit() const { return shape != nullptr; }
+};
+
+// Picking against the actual triangles of the scene: which object is under the cursor, at the screen
+// centre, or along any other ray. Two levels of Bvh: one over the objects' world boxes, and one over
+// the triangles of every mesh in local space, shared by shapes with the same mesh key (one per unique
+// mesh, like the MeshCache). Rays are transformed into each object's local space, so moving objects
+// only refit the object tree (update()). Triangles are tested 4 at a time with an SSE2 Moller-Trumbore
+// kernel (scalar fallback), both sides count.
+//
+// Geometry comes from Shape::getGeometry(), so shapes whose GPU mesh was cached, generated in place or
+// merged into a static batch can be picked as well. Needs no OpenGL context.
+class Scene {
+public:
+    // Shapes to pick from (modelMatrix is read by build() and update()). A LodShape is picked with its finest level.
+    void add(const Shape* shape);
+    void add(const LodShape* shape);
+    void clear();
+
+    // Generates the triangle BVHs (once per unique mesh) and builds the object tree
+    void build();
+    // Refits the objects whose modelMatrix changed since the last build()/update()
+    void update();
+
+    // Nearest hit along origin + t * direction (0 <= t <= maxDistance); hit.shape is nullptr if there is none.
+    // Thread-safe between update() calls, so large batches of rays can be split over threads.
+    RayHit raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance = FLT_MAX) const;
+
+    size_t getObjectCount() const { return objects.size(); }
+    // Unique meshes and their total triangle count
+    size_t getMeshCount() const { return meshes.size(); }
+    size_t getTriangleCount() const;
+
+    // "SSE2" or "scalar"
+    static const char* getSimdPath();
+
+private:
+    // Triangles of one mesh in local space, as Moller-Trumbore wants them (corner + two edges)
+    struct MeshTriangles {
+        std::vector<glm::vec3> corners, edges1, edges2;
+        std::vector<glm::vec2> uvs; // 3 per triangle
+        Bvh bvh;
+        BoundingBox bounds;
+    };
+
+    struct Object {
+        const Shape* shape = nullptr;     // Reported in hits (the finest level of a LodShape)
+        const LodShape* lod = nullptr;    // modelMatrix source for LOD objects
+        std::shared_ptr<MeshTriangles> mesh;
+        glm::mat4 matrix = glm::mat4(1.0f);
+        glm::mat4 inverseMatrix = glm::mat4(1.0f);
+    };
+
+    std::vector<Object> objects;
+    std::unordered_map<std::string, std::shared_ptr<MeshTriangles>> meshes; // By mesh key (unnamed meshes get a unique key)
+    Bvh objectTree;
+
+    const glm::mat4& getMatrix(const Object& object) const;
+    BoundingBox getWorldBox(const Object& object) const;
+    static std::shared_ptr<MeshTriangles> buildMesh(const Shape& shape);
+    // Nearest hit among some triangles of a mesh closer than 'closest'; updates closest, triangle and barycentrics
+    static bool intersectTriangles(const MeshTriangles& mesh, const uint32_t* triangles, uint32_t count,
+                                   const glm::vec3& origin, const glm::vec3& direction,
+                                   float& closest, uint32_t& hitTriangle, glm::vec2& barycentric);
+};
+
+#endif // SCENE_H
@@ -0,0 +1,68 @@
+#include "sceneBuilder.h"
+#include <chrono>
+#include <string>
+#include <unordered_set>
+#include "meshCache.h"
+
+void SceneBuilder::add(Shape* shape) {
+    if (shape) shapes.push_back(shape);
+}
+
+void SceneBuilder::add(InstancedShape* shape) {
+    if (shape) instancedShapes.push_back(shape);
+}
+
+void SceneBuilder::add(LodShape* shape) {
+    if (!shape) return;
+    for (int i = 0; i < shape->getLevelCount(); ++i) add(shape->getLevel(i));
+}
+
+void SceneBuilder::addGeometryOnly(Shape* shape) {
+    if (shape) geometryOnlyShapes.push_back(shape);
+}
+
+void SceneBuilder::addGeometryOnly(InstancedShape* shape) {
+    if (shape && shape->getPrototype()) geometryOnlyShapes.push_back(shape->getPrototype());
+}
+
+void SceneBuilder::build() {
+    auto start = std::chrono::high_resolution_clock::now();
+
+    // Pick the shapes that actually need geometry: one per mesh key, none for keys already uploaded
+    // or stored in a valid MeshFile (mapped now, uploaded from the mapping in phase 2)
+    std::vector<Shape*> jobs;
+    std::unordered_set<std::string> queuedKeys;
+    auto queue = [&](Shape* shape) {
+        std::string key = shape->getMeshKey();
+        if (!key.empty()) {
+            if (MeshCache::instance().contains(key) || !queuedKeys.insert(key).second) return;
+            if (shape->openMeshFile()) return;
+        }
+        jobs.push_back(shape);
+    };
+    for (Shape* shape : shapes) queue(shape);
+    for (InstancedShape* instanced : instancedShapes) queue(instanced->getPrototype());
+    // Every one needs its own arrays (no mesh to share); a prototype queued twice is generated once
+    std::unordered_set<Shape*> geometryOnly;
+    for (Shape* shape : geometryOnlyShapes) {
+        if (geometryOnly.insert(shape).second) jobs.push_back(shape);
+    }
+
+    // Phase 1: CPU generation on all cores
+    pool.parallelFor(jobs.size(), [&](size_t i) { jobs[i]->prepareGeometry(); });
+    auto generated = std::chrono::high_resolution_clock::now();
+
+    // Phase 2: uploads on this (GL) thread, in the order the shapes were added
+    for (Shape* shape : shapes) shape->setupMesh();
+    for (InstancedShape* instanced : instancedShapes) instanced->setupMesh();
+    auto uploaded = std::chrono::high_resolution_clock::now();
+
+    lastShapeCount = shapes.size() + instancedShapes.size() + geometryOnly.size();
+    lastGeneratedCount = jobs.size();
+    generateMs = std::chrono::duration<double, std::milli>(generated - start).count();
+    uploadMs = std::chrono::duration<double, std::milli>(uploaded - generated).count();
+
+    shapes.clear();
+    instancedShapes.clear();
+    geometryOnlyShapes.clear();
+}
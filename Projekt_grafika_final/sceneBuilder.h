@@ -0,0 +1,51 @@
+#ifndef SCENE_BUILDER_H
+#define SCENE_BUILDER_H
+
+#include <vector>
+#include <cstddef>
+#include "shape.h"
+#include "instancedShape.h"
+#include "lodShape.h"
+#include "threadPool.h"
+
+// Builds the meshes of many shapes in two phases instead of calling setupMesh() one by one:
+//   1. prepareGeometry() (generation + MeshOptimizer, pure CPU) for all shapes in parallel on the pool,
+//   2. setupMesh() (upload) for all shapes in the order they were added, on the thread owning the GL context.
+// Shapes sharing a mesh key are generated only once; the others reuse the uploaded mesh in phase 2.
+// Shapes with a valid MeshFile (see Shape::setMeshCacheDirectory) are not generated at all.
+// Shapes queued with addGeometryOnly() only go through phase 1: they keep their CPU-side arrays and get no
+// mesh, for consumers that merge the geometry themselves (StaticBatcher).
+class SceneBuilder {
+public:
+    explicit SceneBuilder(ThreadPool& pool) : pool(pool) {}
+
+    // Queues a shape; its mesh is created by build(). The shape must stay alive until then.
+    void add(Shape* shape);
+    void add(InstancedShape* shape);
+    void add(LodShape* shape); // All levels
+    // Queues a shape (or an InstancedShape's prototype) for generation only, see above
+    void addGeometryOnly(Shape* shape);
+    void addGeometryOnly(InstancedShape* shape);
+
+    // Runs both phases and clears the queue. Must be called on the GL context thread.
+    void build();
+
+    // Statistics of the last build()
+    size_t getShapeCount() const { return lastShapeCount; }
+    size_t getGeneratedCount() const { return lastGeneratedCount; }
+    double getGenerateMilliseconds() const { return generateMs; }
+    double getUploadMilliseconds() const { return uploadMs; }
+
+private:
+    ThreadPool& pool;
+    std::vector<Shape*> shapes;
+    std::vector<InstancedShape*> instancedShapes;
+    std::vector<Shape*> geometryOnlyShapes;
+
+    size_t lastShapeCount = 0;
+    size_t lastGeneratedCount = 0;
+    double generateMs = 0.0;
+    double uploadMs = 0.0;
+};
+
+#endif // SCENE_BUILDER_H
@@ -1,69 +1,238 @@
-#include "shaderClass.h"
-
-// Reads a text file and returns its contents as a string
-std::string get_file_contents(const char* filename)
-{
-	std::ifstream in(filename, std::ios::binary);
-	if (in)
-	{
-		std::string contents;
-		in.seekg(0, std::ios::end);
-		contents.resize(in.tellg());
-		in.seekg(0, std::ios::beg);
-		in.read(&contents[0], contents.size());
-		in.close();
-		return(contents);
-	}
-	throw(errno);
-}
-
-// Shader constructor
-Shader::Shader(const char* vertexFile, const char* fragmentFile)
-{
-	// Read vertex and fragment shader files
-	std::string vertexCode = get_file_contents(vertexFile);
-	std::string fragmentCode = get_file_contents(fragmentFile);
-	//std::cout << "\n" << R"(Vertex code loaded:)" << vertexCode << "\n" << R"(fragment code loaded:)" << "\n" << fragmentCode << "\n";
-	const char* vertexSource = vertexCode.c_str();
-	const char* fragmentSource = fragmentCode.c_str();
-
-	// Create vertex shader object
-	GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
-	// Attach vertex shader source code
-	glShaderSource(vertexShader, 1, &vertexSource, NULL);
-	// Compile the vertex shader
-	glCompileShader(vertexShader);
-
-	// Create fragment shader object
-	GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-	// Attach fragment shader source code
-	glShaderSource(fragmentShader, 1, &fragmentSource, NULL);
-	// Compile the fragment shader
-	glCompileShader(fragmentShader);
-
-	// Create shader program
-	ID = glCreateProgram();
-	// Attach vertex shader
-	glAttachShader(ID, vertexShader);
-	// Attach fragment shader
-	glAttachShader(ID, fragmentShader);
-	// Link the shader program
-	glLinkProgram(ID);
-
-	// Delete the vertex and fragment shaders as they're linked into the program now and no longer necessary
-	glDeleteShader(vertexShader);
-	glDeleteShader(fragmentShader);
-
-}
-
-// Activates the Shader Program
-void Shader::Activate()
-{
-	glUseProgram(ID);
-}
-
-// Deletes the Shader Program
-void Shader::Delete()
-{
-	glDeleteProgram(ID);
-}
\ No newline at end of file
+#include "shaderClass.h"
+#include "frameUniforms.h"
+#include <algorithm>
+#include <cstring>
+#include <glm/gtc/type_ptr.hpp>
+
+// Reads a text file and returns its contents as a string
+std::string get_file_contents(const char* filename)
+{
+	std::ifstream in(filename, std::ios::binary);
+	if (in)
+	{
+		std::string contents;
+		in.seekg(0, std::ios::end);
+		contents.resize(in.tellg());
+		in.seekg(0, std::ios::beg);
+		in.read(&contents[0], contents.size());
+		in.close();
+		return(contents);
+	}
+	throw(errno);
+}
+
+// Inserts preprocessor defines right after the #version directive (which has to stay first)
+static void insert_defines(std::string& code, const char* defines)
+{
+	if (!defines || !*defines) return;
+	size_t versionPos = code.find("#version");
+	size_t lineEnd = versionPos == std::string::npos ? std::string::npos : code.find('\n', versionPos);
+	if (lineEnd == std::string::npos)
+	{
+		std::cerr << "Error: Shader has no #version line, defines not inserted." << std::endl;
+		return;
+	}
+	code.insert(lineEnd + 1, defines);
+}
+
+// Shader constructor
+Shader::Shader(const char* vertexFile, const char* fragmentFile, const char* defines)
+{
+	// Read vertex and fragment shader files
+	std::string vertexCode = get_file_contents(vertexFile);
+	std::string fragmentCode = get_file_contents(fragmentFile);
+	insert_defines(vertexCode, defines);
+	insert_defines(fragmentCode, defines);
+	//std::cout << "\n" << R"(Vertex code loaded:)" << vertexCode << "\n" << R"(fragment code loaded:)" << "\n" << fragmentCode << "\n";
+	const char* vertexSource = vertexCode.c_str();
+	const char* fragmentSource = fragmentCode.c_str();
+
+	// Create vertex shader object
+	GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
+	// Attach vertex shader source code
+	glShaderSource(vertexShader, 1, &vertexSource, NULL);
+	// Compile the vertex shader
+	glCompileShader(vertexShader);
+
+	// Create fragment shader object
+	GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
+	// Attach fragment shader source code
+	glShaderSource(fragmentShader, 1, &fragmentSource, NULL);
+	// Compile the fragment shader
+	glCompileShader(fragmentShader);
+
+	// Create shader program
+	ID = glCreateProgram();
+	// Attach vertex shader
+	glAttachShader(ID, vertexShader);
+	// Attach fragment shader
+	glAttachShader(ID, fragmentShader);
+	// Link the shader program
+	glLinkProgram(ID);
+
+	// Delete the vertex and fragment shaders as they're linked into the program now and no longer necessary
+	glDeleteShader(vertexShader);
+	glDeleteShader(fragmentShader);
+
+	// Reflect the active uniforms so per-frame code never looks them up by string
+	reflectUniforms();
+	drawUniforms.model = find(Uniforms::model);
+	drawUniforms.meshPosOffset = find(Uniforms::meshPosOffset);
+	drawUniforms.meshPosScale = find(Uniforms::meshPosScale);
+	drawUniforms.meshUvTransform = find(Uniforms::meshUvTransform);
+	// Attach the shared uniform blocks to their fixed binding points
+	bindUniformBlocks();
+}
+
+// Binds every active uniform block to the binding point FrameUniforms fills it from
+void Shader::bindUniformBlocks()
+{
+	GLint count = 0, maxLength = 0;
+	glGetProgramiv(ID, GL_ACTIVE_UNIFORM_BLOCKS, &count);
+	glGetProgramiv(ID, GL_ACTIVE_UNIFORM_BLOCK_MAX_NAME_LENGTH, &maxLength);
+	std::vector<char> nameBuffer(std::max(maxLength, 1));
+
+	for (GLint i = 0; i < count; ++i)
+	{
+		GLuint blockIndex = static_cast<GLuint>(i);
+		glGetActiveUniformBlockName(ID, blockIndex, static_cast<GLsizei>(nameBuffer.size()), nullptr, nameBuffer.data());
+		GLint dataSize = 0;
+		glGetActiveUniformBlockiv(ID, blockIndex, GL_UNIFORM_BLOCK_DATA_SIZE, &dataSize);
+
+		GLuint binding = 0;
+		GLsizeiptr size = 0;
+		if (!FrameUniforms::getBlockLayout(nameBuffer.data(), binding, size))
+		{
+			std::cerr << "Error: Uniform block \"" << nameBuffer.data() << "\" has no binding point." << std::endl;
+			continue;
+		}
+		// The bound range has the size of the C++ struct, the shader must not read past it
+		if (dataSize > size)
+		{
+			std::cerr << "Error: Uniform block \"" << nameBuffer.data() << "\" is " << dataSize
+			          << " bytes, its std140 struct only " << size << "." << std::endl;
+		}
+		glUniformBlockBinding(ID, blockIndex, binding);
+	}
+}
+
+// Builds the uniform table: one slot per active uniform location, and the names to find them by sorted by hash
+void Shader::reflectUniforms()
+{
+	uniforms.clear();
+	names.clear();
+	GLint count = 0, maxLength = 0;
+	glGetProgramiv(ID, GL_ACTIVE_UNIFORMS, &count);
+	glGetProgramiv(ID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+	std::vector<char> nameBuffer(std::max(maxLength, 1));
+
+	for (GLint i = 0; i < count; ++i)
+	{
+		GLsizei length = 0;
+		GLint size = 0;
+		GLenum type = 0;
+		glGetActiveUniform(ID, static_cast<GLuint>(i), static_cast<GLsizei>(nameBuffer.size()), &length, &size, &type, nameBuffer.data());
+		std::string name(nameBuffer.data(), length);
+
+		// Arrays of plain types are reported once as "name[0]": add every element, and "name" for the first
+		bool isArray = name.size() > 3 && name.compare(name.size() - 3, 3, "[0]") == 0;
+		std::string baseName = isArray ? name.substr(0, name.size() - 3) : name;
+		for (GLint element = 0; element < std::max(size, 1); ++element)
+		{
+			std::string elementName = isArray ? baseName + "[" + std::to_string(element) + "]" : name;
+			GLint location = glGetUniformLocation(ID, elementName.c_str());
+			if (location < 0) continue; // Uniform block members have no location
+
+			UniformSlot slot;
+			slot.location = location;
+			slot.type = type;
+			uniforms.push_back(slot);
+			int slotIndex = static_cast<int>(uniforms.size()) - 1;
+			names.push_back({ hashUniformName(elementName.c_str()), elementName, slotIndex });
+			if (isArray && element == 0) names.push_back({ hashUniformName(baseName.c_str()), baseName, slotIndex });
+		}
+	}
+
+	std::sort(names.begin(), names.end(), [](const UniformEntry& a, const UniformEntry& b) { return a.hash < b.hash; });
+	for (size_t i = 1; i < names.size(); ++i)
+	{
+		if (names[i].hash == names[i - 1].hash)
+		{
+			std::cerr << "Error: Uniforms \"" << names[i - 1].name << "\" and \"" << names[i].name
+			          << "\" have the same name hash, rename one of them." << std::endl;
+		}
+	}
+}
+
+// Activates the Shader Program
+void Shader::Activate()
+{
+	GLStateCache::useProgram(ID);
+}
+
+// Deletes the Shader Program
+void Shader::Delete()
+{
+	GLStateCache::deleteProgram(ID);
+}
+
+// Finds a uniform by name hash
+UniformHandle Shader::find(const UniformName& name) const
+{
+	UniformHandle handle;
+	auto it = std::lower_bound(names.begin(), names.end(), name.hash,
+	                           [](const UniformEntry& entry, uint32_t hash) { return entry.hash < hash; });
+	if (it == names.end() || it->hash != name.hash) return handle;
+	// A misspelled or inactive name hashing like an active uniform must not write that one.
+	// Only compared on a hash hit, and callers keep their handles.
+	if (it->name != name.text) return handle;
+	handle.index = it->slot;
+	return handle;
+}
+
+GLint Shader::getLocation(const UniformName& name) const
+{
+	UniformHandle handle = find(name);
+	return handle.isValid() ? uniforms[handle.index].location : -1;
+}
+
+// Remembers the value about to be uploaded; false if the uniform already holds it
+bool Shader::updateValue(UniformHandle uniform, const void* value, uint32_t size)
+{
+	if (!uniform.isValid()) return false;
+	UniformSlot& slot = uniforms[uniform.index];
+	if (slot.valueSize == size && std::memcmp(slot.value, value, size * sizeof(uint32_t)) == 0)
+	{
+		skippedUploads++;
+		return false;
+	}
+	std::memcpy(slot.value, value, size * sizeof(uint32_t));
+	slot.valueSize = size;
+	uploads++;
+	return true;
+}
+
+void Shader::set(UniformHandle uniform, GLint value)
+{
+	if (updateValue(uniform, &value, 1)) glUniform1i(uniforms[uniform.index].location, value);
+}
+
+void Shader::set(UniformHandle uniform, GLfloat value)
+{
+	if (updateValue(uniform, &value, 1)) glUniform1f(uniforms[uniform.index].location, value);
+}
+
+void Shader::set(UniformHandle uniform, const glm::vec3& value)
+{
+	if (updateValue(uniform, glm::value_ptr(value), 3)) glUniform3fv(uniforms[uniform.index].location, 1, glm::value_ptr(value));
+}
+
+void Shader::set(UniformHandle uniform, const glm::vec4& value)
+{
+	if (updateValue(uniform, glm::value_ptr(value), 4)) glUniform4fv(uniforms[uniform.index].location, 1, glm::value_ptr(value));
+}
+
+void Shader::set(UniformHandle uniform, const glm::mat4& value)
+{
+	if (updateValue(uniform, glm::value_ptr(value), 16)) glUniformMatrix4fv(uniforms[uniform.index].location, 1, GL_FALSE, glm::value_ptr(value));
+}
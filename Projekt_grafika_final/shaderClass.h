@@ -1,26 +1,137 @@
-    #ifndef SHADER_CLASS_H
-    #define SHADER_CLASS_H
-
-    #include <glad/glad.h>
-    #include <string>
-    #include <fstream>
-    #include <sstream>
-    #include <iostream>
-    #include <cerrno>
-
-    // Function to read the contents of a file into a string
-    std::string get_file_contents(const char* filename);
-
-    class Shader
-    {
-    public:
-        GLuint ID; // Shader program ID
-        // Constructor that takes vertex and fragment shader file paths
-        Shader(const char* vertexFile, const char* fragmentFile);
-
-        // Activates the shader program
-        void Activate();
-        // Deletes the shader program
-        void Delete();
-    };
-    #endif
\ No newline at end of file
+    #ifndef SHADER_CLASS_H
+    #define SHADER_CLASS_H
+
+    #include <glad/glad.h>
+    #include "glStateCache.h"
+    #include <glm/glm.hpp>
+    #include <string>
+    #include <vector>
+    #include <fstream>
+    #include <sstream>
+    #include <iostream>
+    #include <cerrno>
+    #include <cstddef>
+    #include <cstdint>
+
+    // Function to read the contents of a file into a string
+    std::string get_file_contents(const char* filename);
+
+    // 32-bit FNV-1a hash of a uniform name (constexpr, so names known at compile time cost nothing at run time)
+    constexpr uint32_t hashUniformName(const char* name, uint32_t hash = 2166136261u)
+    {
+        return *name ? hashUniformName(name + 1, (hash ^ static_cast<uint8_t>(*name)) * 16777619u) : hash;
+    }
+
+    // A uniform name with its hash. Built from a string literal; the constants below are hashed by the compiler.
+    struct UniformName
+    {
+        uint32_t hash;
+        const char* text;
+
+        template <size_t N>
+        constexpr UniformName(const char (&name)[N]) : hash(hashUniformName(name)), text(name) {}
+        // For names only known at run time (hashed on every call)
+        static UniformName fromString(const char* name) { return UniformName(hashUniformName(name), name); }
+
+    private:
+        constexpr UniformName(uint32_t nameHash, const char* name) : hash(nameHash), text(name) {}
+    };
+
+    // Uniforms set by the renderer (array elements and struct members use their GLSL names).
+    // The camera and lights are in uniform blocks instead, see FrameUniforms.
+    namespace Uniforms
+    {
+        constexpr UniformName model("model");
+        constexpr UniformName camMatrix("camMatrix");
+        constexpr UniformName tex0("tex0");
+        constexpr UniformName lightColor("lightColor");
+        constexpr UniformName meshPosOffset("meshPosOffset");
+        constexpr UniformName meshPosScale("meshPosScale");
+        constexpr UniformName meshUvTransform("meshUvTransform");
+    }
+
+    // Index of an active uniform in a Shader's table, resolved once with Shader::find().
+    // Invalid if the program has no such uniform (unused ones are removed by the GLSL compiler).
+    struct UniformHandle
+    {
+        int index = -1;
+        bool isValid() const { return index >= 0; }
+    };
+
+    // Handles of the uniforms every draw path sets, resolved once when the program is linked
+    struct DrawUniforms
+    {
+        UniformHandle model;
+        UniformHandle meshPosOffset;
+        UniformHandle meshPosScale;
+        UniformHandle meshUvTransform;
+    };
+
+    class Shader
+    {
+    public:
+        GLuint ID; // Shader program ID
+        // Constructor that takes vertex and fragment shader file paths.
+        // Optional defines (e.g. "#define PACKED_VERTICES\n") are inserted after the #version line of both shaders.
+        Shader(const char* vertexFile, const char* fragmentFile, const char* defines = nullptr);
+
+        // Activates the shader program (skipped if it is already active, see GLStateCache)
+        void Activate();
+        // Deletes the shader program
+        void Delete();
+
+        // Looks a uniform up in the table reflected after linking (binary search on the hash, no driver call).
+        // "name" and "name[0]" of an array give the same handle.
+        UniformHandle find(const UniformName& name) const;
+        GLint getLocation(const UniformName& name) const;
+        // The per-draw handles (model matrix, packed vertex decoding), no lookup
+        const DrawUniforms& getDrawUniforms() const { return drawUniforms; }
+        size_t getUniformCount() const { return uniforms.size(); }
+
+        // Typed setters for this program, which has to be the active one. A value equal to the last one
+        // set through them is not uploaded again; a handle that is not valid is ignored (like location -1).
+        void set(UniformHandle uniform, GLint value);
+        void set(UniformHandle uniform, GLfloat value);
+        void set(UniformHandle uniform, const glm::vec3& value);
+        void set(UniformHandle uniform, const glm::vec4& value);
+        void set(UniformHandle uniform, const glm::mat4& value);
+        template <typename T>
+        void set(const UniformName& name, const T& value) { set(find(name), value); }
+
+        // glUniform calls made by / saved by the setters since the last reset
+        size_t getUploadCount() const { return uploads; }
+        size_t getSkippedUploadCount() const { return skippedUploads; }
+        void resetUploadCounts() { uploads = skippedUploads = 0; }
+
+    private:
+        // One active uniform location (arrays get one slot per element). The last value set is kept as
+        // raw 32-bit words, up to a mat4, to skip repeated uploads.
+        struct UniformSlot
+        {
+            GLint location;
+            GLenum type;
+            uint32_t valueSize = 0; // Words in value, 0 until the first set
+            uint32_t value[16];
+        };
+        // A name a slot can be found by. The first element of an array has two ("name" and "name[0]"),
+        // both pointing at the same slot, so they share the value cache.
+        struct UniformEntry
+        {
+            uint32_t hash;
+            std::string name;
+            int slot;
+        };
+
+        std::vector<UniformSlot> uniforms; // Indexed by UniformHandle
+        std::vector<UniformEntry> names;   // Sorted by hash
+        DrawUniforms drawUniforms;
+        size_t uploads = 0;
+        size_t skippedUploads = 0;
+
+        // Reads the program's active uniforms into the table
+        void reflectUniforms();
+        void bindUniformBlocks();
+        // Stores the value, false if it equals the one already set
+        bool updateValue(UniformHandle uniform, const void* value, uint32_t size);
+    };
+    #endif
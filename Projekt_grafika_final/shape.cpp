@@ -1,112 +1,222 @@
-    #define GLM_ENABLE_EXPERIMENTAL
-
-    #include "Shape.h"
-    #include <iostream> // For error messages
-    #include <glm/gtc/type_ptr.hpp> // For glm::value_ptr
-    #include <glm/gtx/string_cast.hpp> // For glm::to_string (optional, for debugging)
-    #include "texture.h" // Assuming you have a Texture class defined
-
-    Shape::Shape() : modelMatrix(1.0f) {
-        Type = ShapeType::SHAPE_TYPE_CUSTOM; // Default shape type, can be set later
-        // VAO is default constructed. VBO/EBO are pointers, initialized in setupMesh.
-    }
-
-    Shape::~Shape() {
-        cleanup(); // Ensure OpenGL resources are released
-    }
-
-    void Shape::addVertex(const glm::vec3& pos, const glm::vec3& col, const glm::vec2& tex, const glm::vec3& norm) {
-        vertices_data.push_back(pos.x);
-        vertices_data.push_back(pos.y);
-        vertices_data.push_back(pos.z);
-        vertices_data.push_back(col.x);
-        vertices_data.push_back(col.y);
-        vertices_data.push_back(col.z);
-        vertices_data.push_back(tex.x);
-        vertices_data.push_back(tex.y);
-        vertices_data.push_back(norm.x);
-        vertices_data.push_back(norm.y);
-        vertices_data.push_back(norm.z);
-    }
-
-    void Shape::setupMesh() {
-        if (meshInitialized) { // Optional: prevent re-initialization or handle it
-            cleanup(); // Clean up existing GL resources before re-creating
-        }
-
-        // Ensure geometry data is generated by the derived class
-        if (vertices_data.empty() || indices_data.empty()) {
-            generateGeometry(); // This calls the derived class's implementation
-        }
-
-        if (vertices_data.empty() || indices_data.empty()) {
-            std::cerr << "Error: Vertex or index data is empty after generation. Cannot setup mesh for Shape." << std::endl;
-            return;
-        }
-
-        vao.Bind();
-
-        // Create VBO and EBO using the data populated by generateGeometry()
-        vbo_ptr = std::make_unique<VBO>(vertices_data.data(), getVerticesSizeInBytes());
-        ebo_ptr = std::make_unique<EBO>(indices_data.data(), getIndicesSizeInBytes());
-
-        // Link vertex attributes to the VAO
-        // Layout 0: Position
-        vao.LinkAttrib(*vbo_ptr, 0, 3, GL_FLOAT, (GLsizei)stride, (void*)0);
-        // Layout 1: Color
-        vao.LinkAttrib(*vbo_ptr, 1, 3, GL_FLOAT, (GLsizei)stride, (void*)(3 * sizeof(float)));
-        // Layout 2: Texture Coordinate
-        vao.LinkAttrib(*vbo_ptr, 2, 2, GL_FLOAT, (GLsizei)stride, (void*)(6 * sizeof(float)));
-        // Layout 3: Normal
-        vao.LinkAttrib(*vbo_ptr, 3, 3, GL_FLOAT, (GLsizei)stride, (void*)(8 * sizeof(float)));
-
-        vao.Unbind();
-
-        meshInitialized = true;
-    }
-
-    void Shape::setTexture(Texture* tex) {
-        this->shapeTexture = tex;
-    }
-
-    void Shape::draw(Shader& shader) {
-        if (!meshInitialized) {
-            std::cerr << "Error: Mesh not initialized. Cannot draw shape." << std::endl;
-            return;
-        }
-
-        shader.Activate();
-
-        // Set the model matrix uniform in the shader
-        glUniformMatrix4fv(glGetUniformLocation(shader.ID, "model"), 1, GL_FALSE, glm::value_ptr(this->modelMatrix));
-
-        // Bind the shape's specific texture
-        if (this->shapeTexture) {
-            glActiveTexture(GL_TEXTURE0); // Activate the texture unit the shader expects
-            this->shapeTexture->Bind();   // Bind this shape's specific texture
-        }
-
-        vao.Bind();
-        glDrawElements(GL_TRIANGLES, getIndexCount(), GL_UNSIGNED_INT, 0);
-        vao.Unbind();
-
-        // Optional: Unbind texture if you want to be very explicit
-        if (this->shapeTexture) {
-            glActiveTexture(GL_TEXTURE0);
-            this->shapeTexture->Unbind();
-        }
-    }
-
-    void Shape::cleanup() {
-        if (meshInitialized) {
-            // Explicitly delete VBO and EBO GL resources via their Delete methods
-            // The unique_ptr will then handle deleting the C++ objects.
-            if (vbo_ptr) vbo_ptr->Delete();
-            if (ebo_ptr) ebo_ptr->Delete();
-            vao.Delete(); // VAO also has a Delete method
-
-            vbo_ptr.reset(); // Release ownership
-            ebo_ptr.reset(); // Release ownership
-            meshInitialized = false;
-        }
+    #define GLM_ENABLE_EXPERIMENTAL
+
+    #include "Shape.h"
+    #include <iostream> // For error messages
+    #include <glm/gtc/type_ptr.hpp> // For glm::value_ptr
+    #include <glm/gtx/string_cast.hpp> // For glm::to_string (optional, for debugging)
+    #include "texture.h" // Assuming you have a Texture class defined
+    #include "meshCache.h"
+    #include "meshOptimizer.h"
+    #include "meshFile.h"
+    #include <cstring> // For std::memcpy
+    #include <cstdio>  // For std::snprintf
+
+    GeometryArena* Shape::geometryArena = nullptr;
+    VertexFormat Shape::vertexFormat = VertexFormat::Float;
+    bool Shape::optimizeMeshes = true;
+    std::string Shape::meshCacheDirectory;
+    const uint32_t Shape::geometryRevision = 1;
+
+    Shape::Shape() : modelMatrix(1.0f) {
+        Type = ShapeType::SHAPE_TYPE_CUSTOM; // Default shape type, can be set later
+        // The mesh (VAO/VBO/EBO) is created or fetched from the cache in setupMesh.
+    }
+
+    Shape::~Shape() {
+        cleanup(); // Ensure OpenGL resources are released
+    }
+
+    void Shape::generateGeometry() {
+        size_t vertexCount = 0, indexCount = 0;
+        countGeometry(vertexCount, indexCount);
+
+        // One allocation of the exact size each, no push_back growth
+        vertices_data.assign(vertexCount * 11, 0.0f);
+        indices_data.assign(indexCount, 0);
+        GeometryWriter writer(vertices_data.data(), vertexCount, indices_data.data(), indexCount);
+        writeGeometry(writer);
+        setLocalBounds(writer.getBounds()); // Accumulated while writing, no second pass
+
+        if (!writer.isComplete() || writer.hasOverflowed()) {
+            std::cerr << "Error: Generated geometry does not match countGeometry() (" << writer.getVertexCount() << "/" << vertexCount
+                      << " vertices, " << writer.getIndexCount() << "/" << indexCount << " indices)." << std::endl;
+        }
+    }
+
+    void Shape::getGeometry(std::vector<GLfloat>& vertices, std::vector<GLuint>& indices) const {
+        size_t vertexCount = 0, indexCount = 0;
+        countGeometry(vertexCount, indexCount);
+        vertices.assign(vertexCount * 11, 0.0f);
+        indices.assign(indexCount, 0);
+        GeometryWriter writer(vertices.data(), vertexCount, indices.data(), indexCount);
+        writeGeometry(writer);
+    }
+
+    void Shape::releaseGeometry() {
+        // swap, not clear(): clear() keeps the capacity
+        std::vector<GLfloat>().swap(vertices_data);
+        std::vector<GLuint>().swap(indices_data);
+    }
+
+    void Shape::setLocalBounds(const Bounds& bounds) {
+        localBounds = bounds;
+        worldBoundsValid = false;
+    }
+
+    const Bounds& Shape::getWorldBounds() const {
+        // modelMatrix is a public member, so changes are detected by comparing with the matrix of the cached bounds
+        if (!worldBoundsValid || worldBoundsMatrix != modelMatrix) {
+            worldBounds = localBounds.transformed(modelMatrix);
+            worldBoundsMatrix = modelMatrix;
+            worldBoundsValid = true;
+        }
+        return worldBounds;
+    }
+
+    void Shape::prepareGeometry() {
+        generateGeometry(); // This calls the derived class's implementation
+
+        // Reorder triangles and vertices for the GPU caches (same triangles, same result on screen)
+        if (optimizeMeshes && !vertices_data.empty() && !indices_data.empty()) {
+            MeshOptimizer::optimize(vertices_data, indices_data);
+        }
+    }
+
+    void Shape::setMeshCacheDirectory(const std::string& directory) {
+        if (!directory.empty() && !MeshFile::createDirectory(directory)) {
+            std::cerr << "Error: Could not create mesh cache directory " << directory << ", disk cache disabled." << std::endl;
+            meshCacheDirectory.clear();
+            return;
+        }
+        meshCacheDirectory = directory;
+    }
+
+    bool Shape::openMeshFile() {
+        std::string key = getMeshKey();
+        if (meshCacheDirectory.empty() || key.empty()) return false;
+        if (meshFile && meshFile->isOpen()) return true;
+
+        VertexFormat targetFormat = geometryArena ? geometryArena->getFormat() : vertexFormat;
+        std::shared_ptr<MeshFile> file = std::make_shared<MeshFile>();
+        if (!file->open(MeshFile::getCachePath(meshCacheDirectory, key), key, targetFormat, optimizeMeshes, geometryRevision)) return false;
+        meshFile = file;
+        return true;
+    }
+
+    std::string Shape::makeMeshKey(const char* typeName, std::initializer_list<float> params) {
+        std::string key(typeName);
+        char buffer[10];
+        for (float value : params) {
+            uint32_t bits;
+            std::memcpy(&bits, &value, sizeof(bits)); // Exact bit pattern, no rounding like std::to_string
+            std::snprintf(buffer, sizeof(buffer), ":%08x", bits);
+            key += buffer;
+        }
+        return key;
+    }
+
+    void Shape::setupMesh() {
+        if (meshInitialized) { // Optional: prevent re-initialization or handle it
+            cleanup(); // Release the current mesh before re-creating
+        }
+
+        // Reuse an already uploaded mesh with identical geometry (skips generation and upload)
+        std::string key = getMeshKey();
+        if (!key.empty()) {
+            mesh = MeshCache::instance().find(key);
+            if (mesh) {
+                setLocalBounds(mesh->bounds);
+                releaseGeometry(); // Possibly prepared by SceneBuilder before the first upload of this key
+                meshInitialized = true;
+                return;
+            }
+        }
+
+        // Upload straight from the mapped file of an earlier run (no generation, optimization or packing)
+        if (openMeshFile()) {
+            mesh = std::make_shared<Mesh>(meshFile->getData(), geometryArena);
+            meshFile.reset(); // The data now lives in GPU memory, unmap the file
+            MeshCache::instance().insert(key, mesh);
+            setLocalBounds(mesh->bounds);
+            releaseGeometry();
+            meshInitialized = true;
+            return;
+        }
+
+        VertexFormat targetFormat = geometryArena ? geometryArena->getFormat() : vertexFormat;
+        bool writeMeshFile = !meshCacheDirectory.empty() && !key.empty();
+        if (!optimizeMeshes && targetFormat == VertexFormat::Float && vertices_data.empty() && !writeMeshFile) {
+            // Nothing to do on the CPU side: generate straight into the mapped GPU buffers
+            size_t vertexCount = 0, indexCount = 0;
+            countGeometry(vertexCount, indexCount);
+            if (vertexCount == 0 || indexCount == 0) {
+                std::cerr << "Error: Shape reports no geometry. Cannot setup mesh for Shape." << std::endl;
+                return;
+            }
+            mesh = std::make_shared<Mesh>(vertexCount, indexCount,
+                [this](GeometryWriter& writer) { writeGeometry(writer); }, geometryArena);
+            setLocalBounds(mesh->bounds); // Collected by the writer on the mapped memory
+        } else {
+            // Ensure geometry data is generated (and optimized), unless SceneBuilder already did it on a worker
+            if (vertices_data.empty() || indices_data.empty()) {
+                prepareGeometry();
+            }
+
+            if (vertices_data.empty() || indices_data.empty()) {
+                std::cerr << "Error: Vertex or index data is empty after generation. Cannot setup mesh for Shape." << std::endl;
+                return;
+            }
+
+            // Encode once, then create VAO, VBO and EBO (or an arena sub-allocation) and store the same bytes on disk
+            MeshData data;
+            std::vector<PackedVertex> packed;
+            std::vector<GLushort> shortIndices;
+            Mesh::encode(vertices_data, indices_data, targetFormat, data, packed, shortIndices);
+            data.bounds = localBounds;
+            mesh = std::make_shared<Mesh>(data, geometryArena);
+            if (writeMeshFile) {
+                MeshFile::write(MeshFile::getCachePath(meshCacheDirectory, key), key, data, optimizeMeshes, geometryRevision);
+            }
+            // The data now lives in GPU memory (StaticBatcher and the CPU-side queries generate it again)
+            releaseGeometry();
+        }
+        if (!key.empty()) {
+            MeshCache::instance().insert(key, mesh);
+        }
+
+        meshInitialized = true;
+    }
+
+    void Shape::setTexture(Texture* tex) {
+        this->shapeTexture = tex;
+    }
+
+    void Shape::draw(Shader& shader) {
+        if (!meshInitialized) {
+            std::cerr << "Error: Mesh not initialized. Cannot draw shape." << std::endl;
+            return;
+        }
+
+        shader.Activate();
+
+        // Set the model matrix uniform in the shader
+        shader.set(shader.getDrawUniforms().model, this->modelMatrix);
+
+        // Bind the shape's specific texture to the unit the shader expects (none for untextured shapes).
+        // Nothing is unbound afterwards: the next shape with the same texture costs no GL call.
+        GLStateCache::bindTexture(GL_TEXTURE0, GL_TEXTURE_2D, this->shapeTexture ? this->shapeTexture->ID : 0);
+
+        // Bounding box / UV range of packed vertices
+        mesh->applyDequant(shader);
+
+        mesh->draw();
+    }
+
+    void Shape::cleanup() {
+        if (meshInitialized) {
+            // Drop our reference. The Mesh deletes its VBO, EBO and VAO
+            // once no other shape (and no cache lookup) holds it anymore.
+            mesh.reset();
+            meshInitialized = false;
+        }
     }
\ No newline at end of file
@@ -1,74 +1,155 @@
-    #ifndef SHAPE_H
-    #define SHAPE_H
-
-    #include <vector>
-    #include <string>
-    #include <memory> // For std::unique_ptr
-    #include <glad/glad.h>
-    #include <glm/glm.hpp>
-    #include "shaderClass.h" // For passing shader to draw method
-    #include "VAO.h"         // Your existing VAO class
-    #include "VBO.h"         // Your existing VBO class
-    #include "EBO.h"         // Your existing EBO class
-
-    #include "texture.h"
-
-
-    enum ShapeType {
-        SHAPE_TYPE_CUBE,
-        SHAPE_TYPE_SPHERE,
-        SHAPE_TYPE_PLANE,
-	    SHAPE_TYPE_CYLINDER,
-	    SHAPE_TYPE_PYRAMID,
-	    SHAPE_TYPE_LIGHT,
-        SHAPE_TYPE_CUSTOM // For any custom shapes
-    };
-
-    class Shape {
-    protected:
-	    // Type of the shape, useful for identification
-        std::vector<GLfloat> vertices_data; // Stores interleaved vertex attributes
-        std::vector<GLuint> indices_data;   // Stores vertex indices for EBO
-
-        VAO vao; // Each shape owns its VAO
-        std::unique_ptr<VBO> vbo_ptr; // Using unique_ptr for VBO
-        std::unique_ptr<EBO> ebo_ptr; // Using unique_ptr for EBO
-
-        bool meshInitialized = false;
-
-        // Helper for derived classes to add a complete vertex's attributes
-        void addVertex(const glm::vec3& pos, const glm::vec3& col, const glm::vec2& tex, const glm::vec3& norm);
-
-        // Pure virtual function for derived classes to implement their geometry generation
-        virtual void generateGeometry() = 0;
-
-	    Texture* shapeTexture = nullptr; // Optional: Pointer to a texture object if needed
-
-    public:
-        ShapeType Type;
-        glm::mat4 modelMatrix; // Each shape instance can have its own model matrix
-        const size_t stride = 11 * sizeof(GLfloat); // Matches your vertex attribute layout
-
-        Shape();
-        virtual ~Shape(); // Important for proper cleanup with polymorphism
-
-        // Initializes VBO, EBO, and configures VAO. Calls generateGeometry if needed.
-        virtual void setupMesh();
-
-        // Draws the shape using the provided shader
-        virtual void draw(Shader& shader);
-
-        // Cleans up OpenGL resources (VBO, EBO, VAO)
-        void cleanup();
-
-        // Accessors (optional, but can be useful for debugging or direct manipulation)
-        const std::vector<GLfloat>& getVertices() const { return vertices_data; }
-        const std::vector<GLuint>& getIndices() const { return indices_data; }
-        GLsizeiptr getVerticesSizeInBytes() const { return vertices_data.size() * sizeof(GLfloat); }
-        GLsizeiptr getIndicesSizeInBytes() const { return indices_data.size() * sizeof(GLuint); }
-        GLsizei getIndexCount() const { return static_cast<GLsizei>(indices_data.size()); }
-
-        void setTexture(Texture* tex);
-    };
-
+    #ifndef SHAPE_H
+    #define SHAPE_H
+
+    #include <vector>
+    #include <string>
+    #include <memory> // For std::shared_ptr
+    #include <initializer_list>
+    #include <glad/glad.h>
+    #include <glm/glm.hpp>
+    #include "shaderClass.h" // For passing shader to draw method
+    #include "mesh.h"        // GPU buffers (VAO/VBO/EBO), possibly shared with other shapes
+    #include "geometryWriter.h"
+    #include "bounds.h"
+
+    #include "texture.h"
+
+    class MeshFile;
+
+
+    enum ShapeType {
+        SHAPE_TYPE_CUBE,
+        SHAPE_TYPE_SPHERE,
+        SHAPE_TYPE_PLANE,
+	    SHAPE_TYPE_CYLINDER,
+	    SHAPE_TYPE_PYRAMID,
+	    SHAPE_TYPE_LIGHT,
+        SHAPE_TYPE_CUSTOM // For any custom shapes
+    };
+
+    class Shape {
+        friend class SceneBuilder; // Reads mesh keys to generate each shared mesh only once
+        friend class Scene;        // Same, for the triangle BVHs used by raycast()
+        friend class RenderQueue;  // Draws the mesh itself, skipping state that did not change
+
+    protected:
+	    // Type of the shape, useful for identification
+        std::vector<GLfloat> vertices_data; // Stores interleaved vertex attributes
+        std::vector<GLuint> indices_data;   // Stores vertex indices for EBO
+
+        // Uploaded geometry. Shapes with the same mesh key share one Mesh (see MeshCache)
+        std::shared_ptr<Mesh> mesh;
+
+        bool meshInitialized = false;
+
+        // Local-space bounds, collected by the GeometryWriter in generateGeometry() (or taken from the
+        // shared Mesh when the geometry was not generated by this shape)
+        Bounds localBounds;
+        // World-space bounds for the modelMatrix they were computed with, see getWorldBounds()
+        mutable Bounds worldBounds;
+        mutable glm::mat4 worldBoundsMatrix = glm::mat4(1.0f);
+        mutable bool worldBoundsValid = false;
+
+        // Arena new meshes are sub-allocated from (nullptr = every mesh gets its own buffers)
+        static GeometryArena* geometryArena;
+        // GPU vertex format of new meshes with their own buffers (arena meshes use the arena's format)
+        static VertexFormat vertexFormat;
+
+        // Static switch: run MeshOptimizer on generated meshes (otherwise float meshes are generated
+        // straight into mapped GPU memory, without a CPU-side copy)
+        static bool optimizeMeshes;
+
+        // Directory of MeshFiles written after generation and mapped instead of generating on later runs
+        // (empty = disk cache disabled)
+        static std::string meshCacheDirectory;
+        // Revision of the geometry code, stored in every MeshFile. Bump it whenever a change to any
+        // writeGeometry() / countGeometry(), MeshOptimizer or the vertex packing changes the generated
+        // meshes without changing their mesh keys; files written before are then regenerated.
+        static const uint32_t geometryRevision;
+        // MeshFile opened by openMeshFile(), kept mapped until setupMesh() uploads it
+        std::shared_ptr<MeshFile> meshFile;
+
+        // Maps and validates this shape's MeshFile (needs a mesh key and an enabled disk cache).
+        // Returns false on a miss; SceneBuilder then generates the geometry as usual.
+        bool openMeshFile();
+
+        // Pure virtual functions for derived classes to implement their geometry generation:
+        // the exact number of vertices and indices, and the geometry itself, written through the
+        // writer (GeometryWriter::addVertex / addTriangle) into memory sized from those counts
+        virtual void countGeometry(size_t& vertexCount, size_t& indexCount) const = 0;
+        virtual void writeGeometry(GeometryWriter& writer) const = 0;
+
+        // Fills vertices_data and indices_data (sized once, exactly) through writeGeometry()
+        void generateGeometry();
+        void setLocalBounds(const Bounds& bounds);
+
+        // Key identifying the generated geometry: class name + every parameter that affects the vertices.
+        // Shapes returning the same key reuse one uploaded Mesh. An empty key disables sharing.
+        virtual std::string getMeshKey() const { return ""; }
+
+        // Helper for building mesh keys. Parameters are stored bit-exact, so only identical values match.
+        static std::string makeMeshKey(const char* typeName, std::initializer_list<float> params);
+
+	    Texture* shapeTexture = nullptr; // Optional: Pointer to a texture object if needed
+
+    public:
+        ShapeType Type;
+        glm::mat4 modelMatrix; // Each shape instance can have its own model matrix
+        bool isStatic = false; // Never moves after construction: StaticBatcher may bake modelMatrix into a merged mesh
+        bool doubleSided = false; // Drawn with face culling off (both sides of the surface are visible)
+        const size_t stride = 11 * sizeof(GLfloat); // Matches your vertex attribute layout
+
+        Shape();
+        virtual ~Shape(); // Important for proper cleanup with polymorphism
+
+        // CPU half of setupMesh(): generates the geometry into the CPU-side arrays and runs MeshOptimizer.
+        // Touches no OpenGL state and no shared data of other shapes, so SceneBuilder runs it on worker threads.
+        void prepareGeometry();
+
+        // Initializes VBO, EBO, and configures VAO. Generates the geometry if needed.
+        // If a shape with the same mesh key was already uploaded, its Mesh is reused instead.
+        virtual void setupMesh();
+
+        // Makes all meshes created afterwards live in the given arena (nullptr to go back to separate buffers)
+        static void setGeometryArena(GeometryArena* arena) { geometryArena = arena; }
+        // Selects the vertex format for meshes created afterwards. The packed format needs shaders
+        // compiled with PACKED_VERTICES.
+        static void setVertexFormat(VertexFormat format) { vertexFormat = format; }
+        // Enables/disables MeshOptimizer for meshes created afterwards (enabled by default)
+        static void setMeshOptimization(bool enabled) { optimizeMeshes = enabled; }
+        // Enables the on-disk mesh cache in the given directory (created if missing), "" disables it
+        static void setMeshCacheDirectory(const std::string& directory);
+
+        // Draws the shape using the provided shader
+        virtual void draw(Shader& shader);
+
+        // Releases this shape's reference to its Mesh (GL objects are deleted with the last reference)
+        void cleanup();
+
+        // Frees the CPU-side arrays. setupMesh() calls it once the mesh is uploaded.
+        void releaseGeometry();
+
+        // Accessors (optional, but can be useful for debugging or direct manipulation)
+        // Note: the CPU-side arrays are only filled between prepareGeometry() and setupMesh()
+        // (or StaticBatcher::build()); the local bounds remain.
+        const std::vector<GLfloat>& getVertices() const { return vertices_data; }
+        const std::vector<GLuint>& getIndices() const { return indices_data; }
+        GLsizeiptr getVerticesSizeInBytes() const { return vertices_data.size() * sizeof(GLfloat); }
+        GLsizeiptr getIndicesSizeInBytes() const { return indices_data.size() * sizeof(GLuint); }
+        GLsizei getIndexCount() const { return static_cast<GLsizei>(indices_data.size()); }
+        std::shared_ptr<Mesh> getMesh() const { return mesh; }
+        // Local-space geometry for CPU-side queries (picking, collision), generated again through writeGeometry().
+        // Works after the CPU-side arrays were dropped; triangles come in generation order (before MeshOptimizer).
+        void getGeometry(std::vector<GLfloat>& vertices, std::vector<GLuint>& indices) const;
+
+        // Axis-aligned box and sphere around the geometry in local space.
+        // Empty until the geometry was generated (prepareGeometry()) or setupMesh() ran.
+        const Bounds& getLocalBounds() const { return localBounds; }
+        // Local bounds transformed by modelMatrix. Cached: only recomputed after modelMatrix changed.
+        const Bounds& getWorldBounds() const;
+
+        void setTexture(Texture* tex);
+        Texture* getTexture() const { return shapeTexture; }
+    };
+
     #endif // SHAPE_H
\ No newline at end of file
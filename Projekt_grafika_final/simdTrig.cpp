@@ -0,0 +1,185 @@
+#include "simdTrig.h"
+#include <cmath>
+
+#if defined(__AVX2__) && (defined(__FMA__) || defined(_MSC_VER)) // MSVC enables FMA with /arch:AVX2
+#define SIMD_TRIG_AVX2
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SIMD_TRIG_SSE2
+#include <emmintrin.h>
+#endif
+
+// Cephes sinf/cosf constants: 4/pi, pi/4 split into three parts for exact range reduction,
+// and the minimax polynomials for sin and cos on [-pi/4, pi/4]
+static const float fourOverPi = 1.27323954473516f;
+static const float reduce1 = -0.78515625f;
+static const float reduce2 = -2.4187564849853515625e-4f;
+static const float reduce3 = -3.77489497744594108e-8f;
+static const float sinC0 = -1.9515295891e-4f;
+static const float sinC1 = 8.3321608736e-3f;
+static const float sinC2 = -1.6666654611e-1f;
+static const float cosC0 = 2.443315711809948e-5f;
+static const float cosC1 = -1.388731625493765e-3f;
+static const float cosC2 = 4.166664568298827e-2f;
+
+void sinCosTableScalar(float start, float step, size_t count, float* sines, float* cosines) {
+    for (size_t i = 0; i < count; ++i) {
+        float angle = start + (float)i * step;
+        sines[i] = std::sin(angle);
+        cosines[i] = std::cos(angle);
+    }
+}
+
+#if defined(SIMD_TRIG_AVX2)
+
+// Evaluates sin and cos of 8 angles at once
+static inline void sinCos8(__m256 x, __m256& s, __m256& c) {
+    const __m256 signMask = _mm256_castsi256_ps(_mm256_set1_epi32((int)0x80000000));
+    __m256 sinSign = _mm256_and_ps(x, signMask);
+    x = _mm256_andnot_ps(signMask, x); // |x|
+
+    // Octant j (rounded up to even) and the reduced argument x - j * pi/4
+    __m256i j = _mm256_cvttps_epi32(_mm256_mul_ps(x, _mm256_set1_ps(fourOverPi)));
+    j = _mm256_and_si256(_mm256_add_epi32(j, _mm256_set1_epi32(1)), _mm256_set1_epi32(~1));
+    __m256 y = _mm256_cvtepi32_ps(j);
+    x = _mm256_fmadd_ps(y, _mm256_set1_ps(reduce1), x);
+    x = _mm256_fmadd_ps(y, _mm256_set1_ps(reduce2), x);
+    x = _mm256_fmadd_ps(y, _mm256_set1_ps(reduce3), x);
+
+    // Octant-dependent signs and polynomial selection
+    __m256 sinFlip = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(j, _mm256_set1_epi32(4)), 29));
+    __m256 cosFlip = _mm256_castsi256_ps(_mm256_slli_epi32(
+        _mm256_andnot_si256(_mm256_sub_epi32(j, _mm256_set1_epi32(2)), _mm256_set1_epi32(4)), 29));
+    __m256 usePolySin = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(j, _mm256_set1_epi32(2)), _mm256_setzero_si256()));
+    sinSign = _mm256_xor_ps(sinSign, sinFlip);
+
+    __m256 z = _mm256_mul_ps(x, x);
+    __m256 polyCos = _mm256_fmadd_ps(_mm256_set1_ps(cosC0), z, _mm256_set1_ps(cosC1));
+    polyCos = _mm256_fmadd_ps(polyCos, z, _mm256_set1_ps(cosC2));
+    polyCos = _mm256_mul_ps(_mm256_mul_ps(polyCos, z), z);
+    polyCos = _mm256_fnmadd_ps(_mm256_set1_ps(0.5f), z, polyCos);
+    polyCos = _mm256_add_ps(polyCos, _mm256_set1_ps(1.0f));
+
+    __m256 polySin = _mm256_fmadd_ps(_mm256_set1_ps(sinC0), z, _mm256_set1_ps(sinC1));
+    polySin = _mm256_fmadd_ps(polySin, z, _mm256_set1_ps(sinC2));
+    polySin = _mm256_fmadd_ps(_mm256_mul_ps(polySin, z), x, x);
+
+    s = _mm256_xor_ps(_mm256_blendv_ps(polyCos, polySin, usePolySin), sinSign);
+    c = _mm256_xor_ps(_mm256_blendv_ps(polySin, polyCos, usePolySin), cosFlip);
+}
+
+void sinCosTable(float start, float step, size_t count, float* sines, float* cosines) {
+    const __m256 lane = _mm256_setr_ps(0, 1, 2, 3, 4, 5, 6, 7);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 angle = _mm256_fmadd_ps(_mm256_add_ps(lane, _mm256_set1_ps((float)i)), _mm256_set1_ps(step), _mm256_set1_ps(start));
+        __m256 s, c;
+        sinCos8(angle, s, c);
+        _mm256_storeu_ps(sines + i, s);
+        _mm256_storeu_ps(cosines + i, c);
+    }
+    sinCosTableScalar(start + (float)i * step, step, count - i, sines + i, cosines + i);
+}
+
+void scaleRing(const float* cosines, const float* sines, size_t count, float scale, float* xs, float* zs) {
+    const __m256 factor = _mm256_set1_ps(scale);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        _mm256_storeu_ps(xs + i, _mm256_mul_ps(_mm256_loadu_ps(cosines + i), factor));
+        _mm256_storeu_ps(zs + i, _mm256_mul_ps(_mm256_loadu_ps(sines + i), factor));
+    }
+    for (; i < count; ++i) {
+        xs[i] = cosines[i] * scale;
+        zs[i] = sines[i] * scale;
+    }
+}
+
+const char* getSimdTrigPath() { return "AVX2"; }
+
+#elif defined(SIMD_TRIG_SSE2)
+
+// Bitwise select (SSE2 has no blendv): mask ? a : b
+static inline __m128 select4(__m128 mask, __m128 a, __m128 b) {
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+// Evaluates sin and cos of 4 angles at once
+static inline void sinCos4(__m128 x, __m128& s, __m128& c) {
+    const __m128 signMask = _mm_castsi128_ps(_mm_set1_epi32((int)0x80000000));
+    __m128 sinSign = _mm_and_ps(x, signMask);
+    x = _mm_andnot_ps(signMask, x); // |x|
+
+    // Octant j (rounded up to even) and the reduced argument x - j * pi/4
+    __m128i j = _mm_cvttps_epi32(_mm_mul_ps(x, _mm_set1_ps(fourOverPi)));
+    j = _mm_and_si128(_mm_add_epi32(j, _mm_set1_epi32(1)), _mm_set1_epi32(~1));
+    __m128 y = _mm_cvtepi32_ps(j);
+    x = _mm_add_ps(x, _mm_mul_ps(y, _mm_set1_ps(reduce1)));
+    x = _mm_add_ps(x, _mm_mul_ps(y, _mm_set1_ps(reduce2)));
+    x = _mm_add_ps(x, _mm_mul_ps(y, _mm_set1_ps(reduce3)));
+
+    // Octant-dependent signs and polynomial selection
+    __m128 sinFlip = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(j, _mm_set1_epi32(4)), 29));
+    __m128 cosFlip = _mm_castsi128_ps(_mm_slli_epi32(
+        _mm_andnot_si128(_mm_sub_epi32(j, _mm_set1_epi32(2)), _mm_set1_epi32(4)), 29));
+    __m128 usePolySin = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(j, _mm_set1_epi32(2)), _mm_setzero_si128()));
+    sinSign = _mm_xor_ps(sinSign, sinFlip);
+
+    __m128 z = _mm_mul_ps(x, x);
+    __m128 polyCos = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(cosC0), z), _mm_set1_ps(cosC1));
+    polyCos = _mm_add_ps(_mm_mul_ps(polyCos, z), _mm_set1_ps(cosC2));
+    polyCos = _mm_mul_ps(_mm_mul_ps(polyCos, z), z);
+    polyCos = _mm_sub_ps(polyCos, _mm_mul_ps(_mm_set1_ps(0.5f), z));
+    polyCos = _mm_add_ps(polyCos, _mm_set1_ps(1.0f));
+
+    __m128 polySin = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(sinC0), z), _mm_set1_ps(sinC1));
+    polySin = _mm_add_ps(_mm_mul_ps(polySin, z), _mm_set1_ps(sinC2));
+    polySin = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(polySin, z), x), x);
+
+    s = _mm_xor_ps(select4(usePolySin, polySin, polyCos), sinSign);
+    c = _mm_xor_ps(select4(usePolySin, polyCos, polySin), cosFlip);
+}
+
+void sinCosTable(float start, float step, size_t count, float* sines, float* cosines) {
+    const __m128 lane = _mm_setr_ps(0, 1, 2, 3);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 angle = _mm_add_ps(_mm_mul_ps(_mm_add_ps(lane, _mm_set1_ps((float)i)), _mm_set1_ps(step)), _mm_set1_ps(start));
+        __m128 s, c;
+        sinCos4(angle, s, c);
+        _mm_storeu_ps(sines + i, s);
+        _mm_storeu_ps(cosines + i, c);
+    }
+    sinCosTableScalar(start + (float)i * step, step, count - i, sines + i, cosines + i);
+}
+
+void scaleRing(const float* cosines, const float* sines, size_t count, float scale, float* xs, float* zs) {
+    const __m128 factor = _mm_set1_ps(scale);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        _mm_storeu_ps(xs + i, _mm_mul_ps(_mm_loadu_ps(cosines + i), factor));
+        _mm_storeu_ps(zs + i, _mm_mul_ps(_mm_loadu_ps(sines + i), factor));
+    }
+    for (; i < count; ++i) {
+        xs[i] = cosines[i] * scale;
+        zs[i] = sines[i] * scale;
+    }
+}
+
+const char* getSimdTrigPath() { return "SSE2"; }
+
+#else
+
+void sinCosTable(float start, float step, size_t count, float* sines, float* cosines) {
+    sinCosTableScalar(start, step, count, sines, cosines);
+}
+
+void scaleRing(const float* cosines, const float* sines, size_t count, float scale, float* xs, float* zs) {
+    for (size_t i = 0; i < count; ++i) {
+        xs[i] = cosines[i] * scale;
+        zs[i] = sines[i] * scale;
+    }
+}
+
+const char* getSimdTrigPath() { return "scalar"; }
+
+#endif
@@ -0,0 +1,22 @@
+#ifndef SIMD_TRIG_H
+#define SIMD_TRIG_H
+
+#include <cstddef>
+
+// Vectorized sin/cos kernels for procedural geometry (Sphere, Cylinder).
+// Compiled for AVX2 (8 values per step) when the compiler targets it (/arch:AVX2, -mavx2),
+// otherwise SSE2 (4 values, always available on x64), with a scalar fallback for other targets.
+// The SIMD versions use the Cephes single-precision polynomials (max. error ~1e-7 for |angle| < 8192).
+
+// sines[i] = sin(start + i * step), cosines[i] = cos(start + i * step) for i in [0, count)
+void sinCosTable(float start, float step, size_t count, float* sines, float* cosines);
+// Same with std::sin / std::cos (reference and fallback)
+void sinCosTableScalar(float start, float step, size_t count, float* sines, float* cosines);
+
+// One ring of a surface of revolution: xs[i] = scale * cosines[i], zs[i] = scale * sines[i]
+void scaleRing(const float* cosines, const float* sines, size_t count, float scale, float* xs, float* zs);
+
+// Name of the compiled kernel ("AVX2", "SSE2" or "scalar")
+const char* getSimdTrigPath();
+
+#endif // SIMD_TRIG_H
@@ -1,64 +1,78 @@
-#include "Sphere.h"
-#include <glm/gtc/matrix_transform.hpp>
-#include <cmath>
-
-Sphere::Sphere(float r, unsigned int sectors, unsigned int stacks, const glm::vec3& color)
-    : radius(r), sectorCount(sectors), stackCount(stacks), sphereColor(color) {
-    Type = ShapeType::SHAPE_TYPE_SPHERE;
-}
-
-void Sphere::generateGeometry() {
-    vertices_data.clear();
-    indices_data.clear();
-
-    float x_pos, y_height, z_depth;
-    float nx, ny, nz, lengthInv = 1.0f / radius;
-    float s, t;
-    float sectorStep = 2 * glm::pi<float>() / sectorCount;
-    float stackStep = glm::pi<float>() / stackCount;
-    float sectorAngle, stackAngle;
-
-    // Generate vertices
-    for (unsigned int i = 0; i <= stackCount; ++i) {
-        stackAngle = glm::pi<float>() / 2.0f - i * stackStep; // from pi/2 to -pi/2
-        float xy_projection = radius * cosf(stackAngle);
-        y_height = radius * sinf(stackAngle);
-        for (unsigned int j = 0; j <= sectorCount; ++j) {
-            sectorAngle = j * sectorStep; // from 0 to 2pi
-            x_pos = xy_projection * cosf(sectorAngle);
-            z_depth = xy_projection * sinf(sectorAngle);
-            nx = x_pos * lengthInv;
-            ny = y_height * lengthInv;
-            nz = z_depth * lengthInv;
-
-            // Texture coordinates
-            s = 1.0f - ((float)j / sectorCount);
-            t = 1.0f - ((float)i / stackCount);
-
-            // Add vertex (position, color, tex coords, normal)
-            // The multiplication by glm::vec3(1.0f, 1.0f, 0.0f) is likely a bug and should be removed
-            addVertex(glm::vec3(x_pos, z_depth, y_height), sphereColor, glm::vec2(s, t), glm::vec3(nx, nz, ny));
-        }
-    }
-
-    // Generate indices for triangles
-    unsigned int k1, k2;
-    for (unsigned int i = 0; i < stackCount; ++i) {
-        k1 = i * (sectorCount + 1);
-        k2 = k1 + sectorCount + 1;
-        for (unsigned int j = 0; j < sectorCount; ++j, ++k1, ++k2) {
-            if (i != 0) {
-                // First triangle of quad
-                indices_data.push_back(k1);
-                indices_data.push_back(k2);
-                indices_data.push_back(k1 + 1);
-            }
-            if (i != (stackCount - 1)) {
-                // Second triangle of quad
-                indices_data.push_back(k1 + 1);
-                indices_data.push_back(k2);
-                indices_data.push_back(k2 + 1);
-            }
-        }
-    }
+#include "Sphere.h"
+#include <glm/gtc/matrix_transform.hpp>
+#include <cmath>
+#include <vector>
+#include "simdTrig.h"
+
+Sphere::Sphere(float r, unsigned int sectors, unsigned int stacks, const glm::vec3& color)
+    : radius(r), sectorCount(sectors), stackCount(stacks), sphereColor(color) {
+    Type = ShapeType::SHAPE_TYPE_SPHERE;
+}
+
+std::string Sphere::getMeshKey() const {
+    return makeMeshKey("Sphere", { radius, (float)sectorCount, (float)stackCount, sphereColor.r, sphereColor.g, sphereColor.b });
+}
+
+void Sphere::countGeometry(size_t& vertexCount, size_t& indexCount) const {
+    vertexCount = (size_t)(stackCount + 1) * (sectorCount + 1);
+    // 2 triangles per quad, except for the first and the last stack (1 triangle each)
+    indexCount = stackCount > 1 ? (size_t)sectorCount * (stackCount - 1) * 2 * 3 : 0;
+}
+
+void Sphere::writeGeometry(GeometryWriter& writer) const {
+    float y_height, ny;
+    float s, t;
+    float sectorStep = 2 * glm::pi<float>() / sectorCount;
+    float stackStep = glm::pi<float>() / stackCount;
+
+    // sin/cos of every sector and stack angle, computed once per mesh (SIMD) instead of per vertex
+    size_t sectorEntries = sectorCount + 1;
+    size_t stackEntries = stackCount + 1;
+    std::vector<float> scratch(6 * sectorEntries + 2 * stackEntries);
+    float* sectorSin = scratch.data();
+    float* sectorCos = sectorSin + sectorEntries;
+    float* ringX = sectorCos + sectorEntries; // Positions of the current ring
+    float* ringZ = ringX + sectorEntries;
+    float* ringNX = ringZ + sectorEntries;    // Normals of the current ring
+    float* ringNZ = ringNX + sectorEntries;
+    float* stackSin = ringNZ + sectorEntries;
+    float* stackCos = stackSin + stackEntries;
+    sinCosTable(0.0f, sectorStep, sectorEntries, sectorSin, sectorCos);                  // from 0 to 2pi
+    sinCosTable(glm::pi<float>() / 2.0f, -stackStep, stackEntries, stackSin, stackCos); // from pi/2 to -pi/2
+
+    // Generate vertices
+    for (unsigned int i = 0; i <= stackCount; ++i) {
+        float xy_projection = radius * stackCos[i];
+        y_height = radius * stackSin[i];
+        ny = stackSin[i];
+        // Whole ring of positions and normals at once
+        scaleRing(sectorCos, sectorSin, sectorEntries, xy_projection, ringX, ringZ);
+        scaleRing(sectorCos, sectorSin, sectorEntries, stackCos[i], ringNX, ringNZ);
+
+        t = 1.0f - ((float)i / stackCount);
+        for (unsigned int j = 0; j <= sectorCount; ++j) {
+            // Texture coordinates
+            s = 1.0f - ((float)j / sectorCount);
+
+            // Add vertex (position, color, tex coords, normal)
+            writer.addVertex(glm::vec3(ringX[j], ringZ[j], y_height), sphereColor, glm::vec2(s, t), glm::vec3(ringNX[j], ringNZ[j], ny));
+        }
+    }
+
+    // Generate indices for triangles
+    unsigned int k1, k2;
+    for (unsigned int i = 0; i < stackCount; ++i) {
+        k1 = i * (sectorCount + 1);
+        k2 = k1 + sectorCount + 1;
+        for (unsigned int j = 0; j < sectorCount; ++j, ++k1, ++k2) {
+            if (i != 0) {
+                // First triangle of quad
+                writer.addTriangle(k1, k2, k1 + 1);
+            }
+            if (i != (stackCount - 1)) {
+                // Second triangle of quad
+                writer.addTriangle(k1 + 1, k2, k2 + 1);
+            }
+        }
+    }
 }
\ No newline at end of file
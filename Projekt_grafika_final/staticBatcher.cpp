@@ -0,0 +1,186 @@
+#include "staticBatcher.h"
+#include <algorithm>
+#include <iostream>
+
+void StaticBatcher::add(Shape* shape) {
+    if (shape && shape->isStatic) queuedShapes.push_back(shape);
+}
+
+void StaticBatcher::add(InstancedShape* shape) {
+    if (shape && shape->getPrototype()) queuedInstanced.push_back(shape);
+}
+
+namespace {
+    // CPU-side data of a batch while it is being merged
+    struct BatchBuilder {
+        Texture* texture = nullptr;
+        bool doubleSided = false;
+        std::vector<GLfloat> vertices;
+        std::vector<GLuint> indices;
+        std::vector<StaticBatchItem> items;
+    };
+
+    BatchBuilder& findBatch(std::vector<BatchBuilder>& builders, Texture* texture, bool doubleSided) {
+        for (BatchBuilder& builder : builders) {
+            if (builder.texture == texture && builder.doubleSided == doubleSided) return builder;
+        }
+        builders.emplace_back();
+        builders.back().texture = texture;
+        builders.back().doubleSided = doubleSided;
+        return builders.back();
+    }
+
+    // Appends the 11-float vertices transformed by model, and the indices shifted behind the existing vertices
+    void appendTransformed(BatchBuilder& batch, StaticBatchItem item, const std::vector<GLfloat>& vertices,
+                           const std::vector<GLuint>& indices, const glm::mat4& model) {
+        glm::mat3 normalMatrix = glm::transpose(glm::inverse(glm::mat3(model))); // Correct for non-uniform scale
+        GLuint firstVertex = (GLuint)(batch.vertices.size() / 11);
+        item.firstIndex = batch.indices.size();
+        item.indexCount = (GLsizei)indices.size();
+        item.bounds = BoundingBox();
+
+        batch.vertices.reserve(batch.vertices.size() + vertices.size());
+        for (size_t v = 0; v + 10 < vertices.size(); v += 11) {
+            glm::vec3 position = glm::vec3(model * glm::vec4(vertices[v], vertices[v + 1], vertices[v + 2], 1.0f));
+            glm::vec3 normal = normalMatrix * glm::vec3(vertices[v + 8], vertices[v + 9], vertices[v + 10]);
+            float length = glm::length(normal);
+            if (length > 0.0f) normal /= length;
+
+            item.bounds.expand(position);
+
+            const GLfloat baked[11] = {
+                position.x, position.y, position.z,
+                vertices[v + 3], vertices[v + 4], vertices[v + 5], // Color
+                vertices[v + 6], vertices[v + 7],                  // Texture coordinates
+                normal.x, normal.y, normal.z
+            };
+            batch.vertices.insert(batch.vertices.end(), baked, baked + 11);
+        }
+
+        // A mirroring matrix turns counter-clockwise triangles clockwise: swap two corners to keep them front-facing
+        bool mirrored = glm::determinant(glm::mat3(model)) < 0.0f;
+        batch.indices.reserve(batch.indices.size() + indices.size());
+        for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+            batch.indices.push_back(firstVertex + indices[i]);
+            batch.indices.push_back(firstVertex + indices[mirrored ? i + 2 : i + 1]);
+            batch.indices.push_back(firstVertex + indices[mirrored ? i + 1 : i + 2]);
+        }
+        batch.items.push_back(item);
+    }
+
+    // CPU-side geometry of a shape (generated again if the shape reused a cached mesh)
+    bool getGeometry(Shape* shape) {
+        if (shape->getVertices().empty() || shape->getIndices().empty()) shape->prepareGeometry();
+        return !shape->getVertices().empty() && !shape->getIndices().empty();
+    }
+}
+
+void StaticBatcher::build() {
+    std::vector<BatchBuilder> builders;
+
+    for (Shape* shape : queuedShapes) {
+        if (!getGeometry(shape)) {
+            std::cerr << "Error: Static shape has no geometry, not batched." << std::endl;
+            continue;
+        }
+        StaticBatchItem item;
+        item.shape = shape;
+        appendTransformed(findBatch(builders, shape->getTexture(), shape->doubleSided), item, shape->getVertices(), shape->getIndices(), shape->modelMatrix);
+    }
+
+    for (InstancedShape* instanced : queuedInstanced) {
+        Shape* prototype = instanced->getPrototype();
+        if (!getGeometry(prototype)) {
+            std::cerr << "Error: Instanced prototype has no geometry, not batched." << std::endl;
+            continue;
+        }
+        BatchBuilder& batch = findBatch(builders, instanced->getTexture(), prototype->doubleSided);
+        for (size_t i = 0; i < instanced->getInstanceCount(); ++i) {
+            StaticBatchItem item;
+            item.shape = prototype;
+            item.instanced = instanced;
+            item.instance = i;
+            appendTransformed(batch, item, prototype->getVertices(), prototype->getIndices(), instanced->getInstance(i));
+        }
+    }
+
+    // Upload. No MeshOptimizer pass: it would mix the pieces' triangles and break the item ranges
+    // (every piece was already optimized on its own).
+    for (BatchBuilder& builder : builders) {
+        if (builder.indices.empty()) continue;
+        StaticBatch batch;
+        batch.texture = builder.texture;
+        batch.doubleSided = builder.doubleSided;
+        batch.items = std::move(builder.items);
+        batch.mesh = std::make_shared<Mesh>(builder.vertices, builder.indices, format, arena);
+        batches.push_back(std::move(batch));
+    }
+
+    // The batches replace the individual meshes, and the merged copies the CPU-side arrays
+    for (Shape* shape : queuedShapes) {
+        shape->cleanup();
+        shape->releaseGeometry();
+    }
+    for (InstancedShape* instanced : queuedInstanced) {
+        instanced->cleanup();
+        instanced->getPrototype()->releaseGeometry();
+    }
+    queuedShapes.clear();
+    queuedInstanced.clear();
+}
+
+void StaticBatcher::draw(Shader& shader) {
+    drawCalls = 0;
+    shader.Activate();
+    glm::mat4 identity(1.0f); // Vertices are already in world space
+    shader.set(shader.getDrawUniforms().model, identity);
+    bool cullWasEnabled = GLStateCache::isEnabled(GL_CULL_FACE);
+
+    for (StaticBatch& batch : batches) {
+        GLStateCache::setEnabled(GL_CULL_FACE, cullWasEnabled && !batch.doubleSided);
+        GLStateCache::bindTexture(GL_TEXTURE0, GL_TEXTURE_2D, batch.texture ? batch.texture->ID : 0);
+        batch.mesh->applyDequant(shader);
+
+        bool allVisible = std::all_of(batch.items.begin(), batch.items.end(), [](const StaticBatchItem& item) { return item.visible; });
+        if (allVisible) {
+            batch.mesh->draw();
+            drawCalls += batch.mesh->chunks.size();
+        } else {
+            // Runs of consecutive visible pieces are contiguous in the index buffer
+            size_t i = 0;
+            while (i < batch.items.size()) {
+                if (!batch.items[i].visible) { ++i; continue; }
+                size_t first = batch.items[i].firstIndex;
+                size_t end = first;
+                while (i < batch.items.size() && batch.items[i].visible) {
+                    end = batch.items[i].firstIndex + batch.items[i].indexCount;
+                    ++i;
+                }
+                drawCalls += batch.mesh->drawRange(first, (GLsizei)(end - first));
+            }
+        }
+    }
+    GLStateCache::setEnabled(GL_CULL_FACE, cullWasEnabled);
+}
+
+void StaticBatcher::setVisible(const Shape* shape, bool visible) {
+    for (StaticBatch& batch : batches) {
+        for (StaticBatchItem& item : batch.items) {
+            if (item.shape == shape && !item.instanced) item.visible = visible;
+        }
+    }
+}
+
+void StaticBatcher::setVisible(const InstancedShape* shape, size_t instance, bool visible) {
+    for (StaticBatch& batch : batches) {
+        for (StaticBatchItem& item : batch.items) {
+            if (item.instanced == shape && item.instance == instance) item.visible = visible;
+        }
+    }
+}
+
+size_t StaticBatcher::getItemCount() const {
+    size_t count = 0;
+    for (const StaticBatch& batch : batches) count += batch.items.size();
+    return count;
+}
@@ -0,0 +1,79 @@
+#ifndef STATIC_BATCHER_H
+#define STATIC_BATCHER_H
+
+#include <vector>
+#include <memory>
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include "shape.h"
+#include "instancedShape.h"
+#include "mesh.h"
+#include "bounds.h"
+#include "geometryArena.h"
+#include "vertexFormat.h"
+#include "shaderClass.h"
+#include "texture.h"
+
+// One piece of a merged batch: the source shape (or one instance of an InstancedShape)
+// and where its triangles ended up in the batch's index buffer
+struct StaticBatchItem {
+    const Shape* shape = nullptr;              // Source shape, or the prototype of an InstancedShape
+    const InstancedShape* instanced = nullptr; // Source InstancedShape (nullptr for plain shapes)
+    size_t instance = 0;                       // Instance index within 'instanced'
+    size_t firstIndex = 0;                     // First index in the batch (in indices, not bytes)
+    GLsizei indexCount = 0;
+    BoundingBox bounds;                        // World-space bounding box of the baked vertices
+    bool visible = true;
+};
+
+// All static geometry using one texture and face culling mode, pre-transformed into world space and uploaded as one mesh
+struct StaticBatch {
+    Texture* texture = nullptr;
+    bool doubleSided = false; // Drawn with face culling off, like the shapes it was merged from
+    std::shared_ptr<Mesh> mesh;
+    std::vector<StaticBatchItem> items; // In index buffer order
+};
+
+// Merges shapes that never move after construction (walls, floor, baseboards, frames) into one mesh per
+// texture and doubleSided flag: modelMatrix is baked into positions and normals, so a whole batch is drawn with an identity
+// model matrix in one call. The item table keeps the index range of every piece, so single pieces can
+// still be hidden; a batch with hidden pieces is drawn as the runs of consecutive visible ones.
+class StaticBatcher {
+public:
+    // Batches are created like shape meshes: in the arena if one is given, otherwise with their own buffers
+    explicit StaticBatcher(GeometryArena* arena = nullptr, VertexFormat format = VertexFormat::Float)
+        : arena(arena), format(format) {}
+
+    // Queue static geometry (shapes with isStatic, every instance of an InstancedShape).
+    // Their current modelMatrix / instance matrices are baked in by build().
+    void add(Shape* shape);
+    void add(InstancedShape* shape);
+
+    // Merges and uploads all queued geometry. The queued shapes release their own meshes afterwards
+    // (they are drawn by the batcher from then on) but stay valid for setVisible().
+    void build();
+
+    // Draws every batch with the given shader (model = identity). The shader's camera/light uniforms must be set.
+    void draw(Shader& shader);
+
+    // Hides or shows one piece
+    void setVisible(const Shape* shape, bool visible);
+    void setVisible(const InstancedShape* shape, size_t instance, bool visible);
+
+    const std::vector<StaticBatch>& getBatches() const { return batches; }
+    std::vector<StaticBatch>& getBatches() { return batches; }
+    size_t getItemCount() const;
+    // Draw calls issued by the last draw() (one per batch while nothing is hidden)
+    size_t getDrawCallCount() const { return drawCalls; }
+
+private:
+    GeometryArena* arena;
+    VertexFormat format;
+
+    std::vector<Shape*> queuedShapes;
+    std::vector<InstancedShape*> queuedInstanced;
+    std::vector<StaticBatch> batches;
+    size_t drawCalls = 0;
+};
+
+#endif // STATIC_BATCHER_H
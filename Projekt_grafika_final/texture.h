@@ -1,30 +1,31 @@
-    #ifndef TEXTURE_CLASS_H
-    #define TEXTURE_CLASS_H
-
-    #include <glad/glad.h>
-    #include <stb/stb_image.h>
-    #include "shaderClass.h"
-
-    class Texture
-    {
-    public:
-        GLuint ID;     // Texture ID
-        GLenum type;   // Texture type
-
-        // Constructor
-        Texture(const char* image, GLenum texType, GLenum slot, GLenum format, GLenum pixelType);
-
-        // Assigns a texture unit to a texture
-        void texUnit(Shader& shader, const char* uniform, GLuint unit);
-
-        // Binds a texture
-        void Bind();
-
-        // Unbinds a texture
-        void Unbind();
-
-        // Deletes a texture
-        void Delete();
-    };
-
+    #ifndef TEXTURE_CLASS_H
+    #define TEXTURE_CLASS_H
+
+    #include <glad/glad.h>
+    #include <stb/stb_image.h>
+    #include "shaderClass.h"
+    #include "glStateCache.h"
+
+    class Texture
+    {
+    public:
+        GLuint ID;     // Texture ID
+        GLenum type;   // Texture type
+
+        // Constructor
+        Texture(const char* image, GLenum texType, GLenum slot, GLenum format, GLenum pixelType);
+
+        // Assigns a texture unit to a texture
+        void texUnit(Shader& shader, const char* uniform, GLuint unit);
+
+        // Binds a texture
+        void Bind();
+
+        // Unbinds a texture
+        void Unbind();
+
+        // Deletes a texture
+        void Delete();
+    };
+
     #endif
\ No newline at end of file
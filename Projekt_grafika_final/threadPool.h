@@ -0,0 +1,46 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <cstddef>
+
+// Fixed set of worker threads for CPU-only jobs (geometry generation, mesh optimization).
+// Tasks must not touch OpenGL: the context belongs to the main thread.
+class ThreadPool {
+public:
+    // threadCount = 0: one worker per hardware thread, minus the calling thread (at least 1)
+    explicit ThreadPool(unsigned int threadCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Queues a task for the workers
+    void submit(std::function<void()> task);
+    // Blocks until every submitted task has finished
+    void wait();
+
+    // Calls fn(i) for every i in [0, count) on the workers and the calling thread, returns when all are done.
+    // Indices are handed out one at a time, so uneven jobs (a few big spheres among many planes) still balance.
+    void parallelFor(size_t count, const std::function<void(size_t)>& fn);
+
+    unsigned int getThreadCount() const { return static_cast<unsigned int>(workers.size()); }
+
+private:
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> tasks;
+    std::mutex mutex;
+    std::condition_variable taskAvailable;
+    std::condition_variable tasksDone;
+    size_t activeTasks = 0; // Queued + running
+    bool stopping = false;
+
+    void workerLoop();
+};
+
+#endif // THREAD_POOL_H
@@ -0,0 +1,127 @@
+#include "vertexFormat.h"
+#include <cmath>
+#include <cstddef> // For offsetof
+#include <algorithm>
+
+static_assert(sizeof(PackedVertex) == 20, "PackedVertex must stay tightly packed");
+
+GLsizei getVertexStride(VertexFormat format) {
+    return format == VertexFormat::Packed ? (GLsizei)sizeof(PackedVertex) : (GLsizei)(11 * sizeof(GLfloat));
+}
+
+std::vector<VertexAttribute> getVertexAttributes(VertexFormat format) {
+    if (format == VertexFormat::Packed) {
+        // Normalized integer attributes, see PackedVertex for the encoding
+        return {
+            { 0, 4, GL_SHORT, GL_TRUE, (uint32_t)offsetof(PackedVertex, position) },         // Position (snorm16 x4, relative to the bounding box)
+            { 1, 4, GL_UNSIGNED_BYTE, GL_TRUE, (uint32_t)offsetof(PackedVertex, color) },    // Color (unorm8 x4)
+            { 2, 2, GL_UNSIGNED_SHORT, GL_TRUE, (uint32_t)offsetof(PackedVertex, texCoord) }, // Texture Coordinate (unorm16 x2, relative to the UV range)
+            { 3, 2, GL_SHORT, GL_TRUE, (uint32_t)offsetof(PackedVertex, normal) },           // Normal (snorm16 x2, octahedral)
+        };
+    }
+    return {
+        { 0, 3, GL_FLOAT, GL_FALSE, 0 },                      // Position
+        { 1, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(GLfloat) },    // Color
+        { 2, 2, GL_FLOAT, GL_FALSE, 6 * sizeof(GLfloat) },    // Texture Coordinate
+        { 3, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(GLfloat) },    // Normal
+    };
+}
+
+// Sign that never returns 0 (needed by the octahedral fold)
+static float signNotZero(float value) {
+    return value >= 0.0f ? 1.0f : -1.0f;
+}
+
+glm::vec2 encodeOctahedral(const glm::vec3& normal) {
+    // Project onto the octahedron |x| + |y| + |z| = 1
+    float l1 = std::fabs(normal.x) + std::fabs(normal.y) + std::fabs(normal.z);
+    if (l1 == 0.0f) return glm::vec2(0.0f);
+    glm::vec2 p(normal.x / l1, normal.y / l1);
+
+    // Fold the lower hemisphere over the diagonals
+    if (normal.z < 0.0f) {
+        p = glm::vec2((1.0f - std::fabs(p.y)) * signNotZero(p.x),
+                      (1.0f - std::fabs(p.x)) * signNotZero(p.y));
+    }
+    return p;
+}
+
+glm::vec3 decodeOctahedral(const glm::vec2& encoded) {
+    glm::vec3 n(encoded.x, encoded.y, 1.0f - std::fabs(encoded.x) - std::fabs(encoded.y));
+    if (n.z < 0.0f) {
+        float x = n.x;
+        n.x = (1.0f - std::fabs(n.y)) * signNotZero(x);
+        n.y = (1.0f - std::fabs(x)) * signNotZero(n.y);
+    }
+    return glm::normalize(n);
+}
+
+static int16_t toSnorm16(float value) {
+    return (int16_t)std::lround(std::min(std::max(value, -1.0f), 1.0f) * 32767.0f);
+}
+
+static uint16_t toUnorm16(float value) {
+    return (uint16_t)std::lround(std::min(std::max(value, 0.0f), 1.0f) * 65535.0f);
+}
+
+static uint8_t toUnorm8(float value) {
+    return (uint8_t)std::lround(std::min(std::max(value, 0.0f), 1.0f) * 255.0f);
+}
+
+void packVertices(const std::vector<GLfloat>& vertices, std::vector<PackedVertex>& packed, MeshDequant& dequant) {
+    size_t vertexCount = vertices.size() / 11;
+    packed.resize(vertexCount);
+    if (vertexCount == 0) return;
+
+    // Bounding box of positions and range of texture coordinates
+    glm::vec3 posMin(vertices[0], vertices[1], vertices[2]);
+    glm::vec3 posMax = posMin;
+    glm::vec2 uvMin(vertices[6], vertices[7]);
+    glm::vec2 uvMax = uvMin;
+    for (size_t i = 0; i < vertexCount; ++i) {
+        const GLfloat* v = &vertices[i * 11];
+        glm::vec3 pos(v[0], v[1], v[2]);
+        glm::vec2 uv(v[6], v[7]);
+        posMin = glm::min(posMin, pos);
+        posMax = glm::max(posMax, pos);
+        uvMin = glm::min(uvMin, uv);
+        uvMax = glm::max(uvMax, uv);
+    }
+
+    dequant.posOffset = (posMin + posMax) * 0.5f;
+    dequant.posScale = (posMax - posMin) * 0.5f;
+    dequant.uvTransform = glm::vec4(uvMin.x, uvMin.y, uvMax.x - uvMin.x, uvMax.y - uvMin.y);
+
+    // Flat axes (e.g. the Y axis of a Plane) would divide by zero, they encode as 0 anyway
+    glm::vec3 posInvScale(0.0f);
+    for (int axis = 0; axis < 3; ++axis) {
+        if (dequant.posScale[axis] > 0.0f) posInvScale[axis] = 1.0f / dequant.posScale[axis];
+    }
+    glm::vec2 uvInvScale(0.0f);
+    for (int axis = 0; axis < 2; ++axis) {
+        if (dequant.uvTransform[2 + axis] > 0.0f) uvInvScale[axis] = 1.0f / dequant.uvTransform[2 + axis];
+    }
+
+    for (size_t i = 0; i < vertexCount; ++i) {
+        const GLfloat* v = &vertices[i * 11];
+        PackedVertex& out = packed[i];
+
+        glm::vec3 pos = (glm::vec3(v[0], v[1], v[2]) - dequant.posOffset) * posInvScale;
+        out.position[0] = toSnorm16(pos.x);
+        out.position[1] = toSnorm16(pos.y);
+        out.position[2] = toSnorm16(pos.z);
+        out.position[3] = 0;
+
+        glm::vec2 normal = encodeOctahedral(glm::vec3(v[8], v[9], v[10]));
+        out.normal[0] = toSnorm16(normal.x);
+        out.normal[1] = toSnorm16(normal.y);
+
+        out.texCoord[0] = toUnorm16((v[6] - uvMin.x) * uvInvScale.x);
+        out.texCoord[1] = toUnorm16((v[7] - uvMin.y) * uvInvScale.y);
+
+        out.color[0] = toUnorm8(v[3]);
+        out.color[1] = toUnorm8(v[4]);
+        out.color[2] = toUnorm8(v[5]);
+        out.color[3] = 255;
+    }
+}
@@ -0,0 +1,59 @@
+#ifndef VERTEX_FORMAT_H
+#define VERTEX_FORMAT_H
+
+#include <vector>
+#include <cstdint>
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+// GPU vertex layouts.
+// Float:  the CPU layout of GeometryWriter::addVertex, 11 floats (44 bytes) per vertex.
+// Packed: 20 bytes per vertex, decoded in the vertex shader when compiled with PACKED_VERTICES:
+//         position  4 x snorm16  relative to the mesh bounding box (w unused)
+//         normal    2 x snorm16  octahedral encoding
+//         texcoord  2 x unorm16  relative to the mesh UV range
+//         color     4 x unorm8
+enum class VertexFormat {
+    Float,
+    Packed
+};
+
+struct PackedVertex {
+    int16_t position[4];
+    int16_t normal[2];
+    uint16_t texCoord[2];
+    uint8_t color[4];
+};
+
+// Per-mesh values needed to decode packed positions and texture coordinates
+// (identity for the float format)
+struct MeshDequant {
+    glm::vec3 posOffset = glm::vec3(0.0f); // Bounding box center
+    glm::vec3 posScale = glm::vec3(1.0f);  // Bounding box half extent
+    glm::vec4 uvTransform = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f); // UV offset (xy) and scale (zw)
+};
+
+// One vertex attribute of a format, as passed to glVertexAttribPointer by Mesh::linkLayout
+// (fixed-size fields: also the layout descriptor stored in MeshFiles)
+struct VertexAttribute {
+    uint32_t location;
+    uint32_t components;
+    uint32_t type;       // GL_FLOAT, GL_SHORT, ...
+    uint32_t normalized; // GL_TRUE maps integer types to [0, 1] / [-1, 1]
+    uint32_t offset;     // Byte offset within a vertex
+};
+
+// Size of one vertex in the given format
+GLsizei getVertexStride(VertexFormat format);
+
+// Layouts 0-3 (position, color, texture coordinates, normal) of the given format
+std::vector<VertexAttribute> getVertexAttributes(VertexFormat format);
+
+// Converts 11-float vertices to the packed layout and computes the decode parameters
+void packVertices(const std::vector<GLfloat>& vertices, std::vector<PackedVertex>& packed, MeshDequant& dequant);
+
+// Octahedral normal encoding (unit vector -> 2 values in [-1, 1]) and its inverse
+glm::vec2 encodeOctahedral(const glm::vec3& normal);
+glm::vec3 decodeOctahedral(const glm::vec2& encoded);
+
+#endif // VERTEX_FORMAT_H